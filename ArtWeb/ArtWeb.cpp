@@ -4,6 +4,7 @@
 #include <fstream>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <ctime>      // For logging time stamps
 #include <vector>
 #include <algorithm>
@@ -12,9 +13,42 @@
 #include <clocale>    // For setlocale
 #include <memory>     // For std::unique_ptr
 #include <map>        // For MIME types
+#include <unordered_map>
+#include <list>
+#include <array>
+#include <deque>
+#include <functional>
+#include <set>
 #include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
 #include <limits>
 #include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <atomic>
+#include <thread>
+#include <random>
+#include <regex>
+#include <cmath>
+
+#ifdef ARTWEB_ZSTD_SUPPORT
+#include <zstd.h>     // Optional: zstd-compressed tar uploads
+#endif
+
+// --- SIMD byte scanning for the escaping helpers (x86/x64; scalar elsewhere) ---
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ARTWEB_SSE2
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define ARTWEB_AVX2
+#define ARTWEB_TARGET_AVX2
+#elif defined(__GNUC__) || defined(__clang__)
+#define ARTWEB_AVX2
+#define ARTWEB_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
 
 #if __has_include(<filesystem>)
 #include <filesystem>
@@ -44,6 +78,41 @@ namespace fs = std::experimental::filesystem;
 #include <unistd.h>
 #include <ifaddrs.h>
 #include <net/if.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/resource.h> // getrlimit
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define ARTWEB_IO_URING   // optional io_uring file I/O engine (--io-engine uring)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+#ifdef __linux__
+#include <sys/xattr.h>
+#include <sys/ioctl.h>
+#include <linux/fs.h>       // FICLONE
+#include <sys/sysmacros.h>  // makedev
+#include <sys/inotify.h>
+#include <dirent.h>
+#include <poll.h>
+#endif
+#endif
+
+// --- Path resolution below the served root (openat2 on Linux) ---
+#ifdef __linux__
+#include <sys/syscall.h>
+#if __has_include(<linux/openat2.h>)
+#include <linux/openat2.h>
+#endif
+#ifndef RESOLVE_BENEATH
+struct open_how { __u64 flags; __u64 mode; __u64 resolve; };
+#define RESOLVE_NO_MAGICLINKS 0x02
+#define RESOLVE_BENEATH       0x08
+#endif
+#ifndef SYS_openat2
+#define SYS_openat2 437
+#endif
 #endif
 
 
@@ -55,30 +124,6 @@ const std::size_t MAX_UPLOAD_SIZE = 1024 * 1024 * 1024;
 
 // ------------------------ Helpers ------------------------
 
-std::string get_mime_type(const std::string& path) {
-    auto pos = path.rfind('.');
-    if (pos == std::string::npos) {
-        return "application/octet-stream";
-    }
-    auto ext = path.substr(pos);
-    static const std::map<std::string, std::string> mime_map = {
-        {".html", "text/html"}, {".htm", "text/html"}, {".css", "text/css"},
-        {".js", "application/javascript"}, {".mjs", "application/javascript"},
-        {".json", "application/json"}, {".xml", "application/xml"},
-        {".txt", "text/plain"}, {".csv", "text/csv"},
-        {".jpg", "image/jpeg"}, {".jpeg", "image/jpeg"},
-        {".png", "image/png"}, {".gif", "image/gif"},
-        {".svg", "image/svg+xml"}, {".ico", "image/x-icon"},
-        {".woff", "font/woff"}, {".woff2", "font/woff2"}, {".ttf", "font/ttf"},
-        {".mp4", "video/mp4"}, {".webm", "video/webm"},
-        {".mp3", "audio/mpeg"}, {".ogg", "audio/ogg"}, {".wav", "audio/wav"},
-        {".pdf", "application/pdf"}, {".zip", "application/zip"}
-    };
-    auto it = mime_map.find(ext);
-    if (it != mime_map.end()) return it->second;
-    return "application/octet-stream";
-}
-
 // If the content type is "text-like", append charset for correct rendering
 std::string add_charset_if_text(const std::string& mime) {
     if (mime.rfind("text/", 0) == 0 ||
@@ -90,6 +135,571 @@ std::string add_charset_if_text(const std::string& mime) {
     return mime;
 }
 
+// ------------------------ MIME types ------------------------
+// Content types come from a perfect-hash table generated from a mime.types file
+// (`ArtWeb --mime-gen /etc/mime.types ArtWeb/artweb_mime_table.h`), with the
+// charset already applied. An optional runtime overlay (--mime-types FILE) is
+// consulted first. Lookups never allocate.
+
+struct MimeEntry {
+    std::string_view ext;           // lowercase, without the dot
+    std::string_view content_type;  // charset already applied
+};
+
+const std::size_t MIME_MAX_EXT = 32;
+
+constexpr std::uint32_t mime_hash(std::string_view s, std::uint32_t seed) {
+    std::uint32_t h = 2166136261u ^ (seed * 0x9E3779B1u);
+    for (char c : s) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 16777619u;
+    }
+    h ^= h >> 16; h *= 0x85EBCA6Bu;
+    h ^= h >> 13; h *= 0xC2B2AE35u;
+    h ^= h >> 16;
+    return h;
+}
+
+#include "artweb_mime_table.h"      // MIME_BUCKET_COUNT, MIME_SLOT_COUNT, g_mime_displacement[], g_mime_slots[]
+
+// Two probes: the extension's bucket picks the seed that places it in its slot.
+constexpr std::string_view mime_table_lookup(std::string_view ext) {
+    const std::uint32_t seed = g_mime_displacement[mime_hash(ext, 0) % MIME_BUCKET_COUNT];
+    const MimeEntry& e = g_mime_slots[mime_hash(ext, seed) % MIME_SLOT_COUNT];
+    return e.ext == ext ? e.content_type : std::string_view();
+}
+
+static_assert(mime_table_lookup("html") == "text/html; charset=utf-8", "MIME table out of date: rerun --mime-gen");
+static_assert(mime_table_lookup("png") == "image/png", "MIME table out of date: rerun --mime-gen");
+
+// --mime-types overlay: sorted by extension, values with charset applied.
+std::vector<std::pair<std::string, std::string>> g_mime_overlay;
+
+// Parse mime.types lines ("type ext1 ext2 ...", '#' comments) into ext/type pairs
+// in file order. Extensions are lowercased; ones that cannot match a final
+// path extension (dots, odd characters, too long) are skipped.
+void parse_mime_types(std::istream& in, std::vector<std::pair<std::string, std::string>>& out) {
+    std::string line;
+    while (std::getline(in, line)) {
+        const auto hash = line.find('#');
+        if (hash != std::string::npos) line.resize(hash);
+        std::istringstream fields(line);
+        std::string type, ext;
+        if (!(fields >> type) || type.find('/') == std::string::npos) continue;
+        std::transform(type.begin(), type.end(), type.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        while (fields >> ext) {
+            if (ext.size() > MIME_MAX_EXT) continue;
+            bool ok = true;
+            for (auto& c : ext) {
+                c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+                if (!(std::isalnum(static_cast<unsigned char>(c)) || c == '-' || c == '_' || c == '+')) ok = false;
+            }
+            if (ok) out.emplace_back(ext, type);
+        }
+    }
+}
+
+// Load the --mime-types overlay; later lines win.
+bool load_mime_overlay(const std::string& path) {
+    std::ifstream in(fs::u8path(path));
+    if (!in) return false;
+    std::vector<std::pair<std::string, std::string>> pairs;
+    parse_mime_types(in, pairs);
+    std::map<std::string, std::string> merged;
+    for (auto& p : pairs) merged[p.first] = add_charset_if_text(p.second);
+    g_mime_overlay.assign(merged.begin(), merged.end());
+    return true;
+}
+
+// Content-Type for a path from its final extension (case-insensitive).
+// The result is NUL-terminated and lives for the whole process.
+std::string_view get_content_type(std::string_view path) {
+    static constexpr std::string_view fallback = "application/octet-stream";
+    const auto dot = path.rfind('.');
+    const auto slash = path.find_last_of("/\\");
+    if (dot == std::string_view::npos || (slash != std::string_view::npos && dot < slash)) return fallback;
+    const std::size_t len = path.size() - dot - 1;
+    if (len == 0 || len > MIME_MAX_EXT) return fallback;
+
+    char buf[MIME_MAX_EXT];
+    for (std::size_t i = 0; i < len; ++i) {
+        const char c = path[dot + 1 + i];
+        buf[i] = (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c;
+    }
+    const std::string_view ext(buf, len);
+
+    if (!g_mime_overlay.empty()) {
+        auto it = std::lower_bound(g_mime_overlay.begin(), g_mime_overlay.end(), ext,
+            [](const std::pair<std::string, std::string>& e, std::string_view key) { return std::string_view(e.first) < key; });
+        if (it != g_mime_overlay.end() && it->first == ext) return it->second;
+    }
+    const std::string_view type = mime_table_lookup(ext);
+    return type.empty() ? fallback : type;
+}
+
+// Historic built-in types; they win over the mime.types source when generating.
+static const std::pair<const char*, const char*> MIME_BUILTIN_TYPES[] = {
+    {"html", "text/html"}, {"htm", "text/html"}, {"css", "text/css"},
+    {"js", "application/javascript"}, {"mjs", "application/javascript"},
+    {"json", "application/json"}, {"xml", "application/xml"},
+    {"txt", "text/plain"}, {"csv", "text/csv"},
+    {"jpg", "image/jpeg"}, {"jpeg", "image/jpeg"},
+    {"png", "image/png"}, {"gif", "image/gif"},
+    {"svg", "image/svg+xml"}, {"ico", "image/x-icon"},
+    {"woff", "font/woff"}, {"woff2", "font/woff2"}, {"ttf", "font/ttf"},
+    {"mp4", "video/mp4"}, {"webm", "video/webm"},
+    {"mp3", "audio/mpeg"}, {"ogg", "audio/ogg"}, {"wav", "audio/wav"},
+    {"pdf", "application/pdf"}, {"zip", "application/zip"},
+    {"wasm", "application/wasm"}, {"webp", "image/webp"}, {"avif", "image/avif"},
+    {"md", "text/markdown"}, {"map", "application/json"}, {"log", "text/plain"},
+    {"webmanifest", "application/manifest+json"}
+};
+
+// --mime-gen SOURCE HEADER: build the perfect-hash table (hash and displace).
+// Extensions are spread over buckets; the largest buckets first search for a
+// seed that puts all their keys in free slots.
+int generate_mime_header(const std::string& source, const std::string& header_path) {
+    std::ifstream in(fs::u8path(source));
+    if (!in) {
+        std::cerr << "Error: cannot read " << source << std::endl;
+        return 1;
+    }
+    std::vector<std::pair<std::string, std::string>> pairs;
+    parse_mime_types(in, pairs);
+    std::map<std::string, std::string> types;   // first mention wins, built-ins override
+    for (auto& p : pairs) types.emplace(p.first, p.second);
+    for (const auto& b : MIME_BUILTIN_TYPES) types[b.first] = b.second;
+
+    std::vector<std::pair<std::string, std::string>> entries(types.begin(), types.end());
+    const std::size_t n = entries.size();
+    const std::size_t buckets = std::max<std::size_t>(1, n / 3);
+    std::vector<std::vector<std::size_t>> members(buckets);
+    for (std::size_t i = 0; i < n; ++i) members[mime_hash(entries[i].first, 0) % buckets].push_back(i);
+    std::vector<std::size_t> order(buckets);
+    for (std::size_t b = 0; b < buckets; ++b) order[b] = b;
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return members[a].size() > members[b].size(); });
+
+    std::size_t slots = n + n / 4 + 1;
+    std::vector<std::uint16_t> displacement;
+    std::vector<long> slot_entry;
+    for (;;) {
+        displacement.assign(buckets, 0);
+        slot_entry.assign(slots, -1);
+        bool placed_all = true;
+        for (std::size_t b : order) {
+            if (members[b].empty()) break;
+            bool placed = false;
+            for (std::uint32_t seed = 1; seed <= 0xFFFF && !placed; ++seed) {
+                std::vector<std::size_t> taken;
+                for (std::size_t i : members[b]) {
+                    const std::size_t s = mime_hash(entries[i].first, seed) % slots;
+                    if (slot_entry[s] != -1 || std::find(taken.begin(), taken.end(), s) != taken.end()) break;
+                    taken.push_back(s);
+                }
+                if (taken.size() != members[b].size()) continue;
+                for (std::size_t k = 0; k < taken.size(); ++k) slot_entry[taken[k]] = static_cast<long>(members[b][k]);
+                displacement[b] = static_cast<std::uint16_t>(seed);
+                placed = true;
+            }
+            if (!placed) { placed_all = false; break; }
+        }
+        if (placed_all) break;
+        slots += slots / 8;
+    }
+
+    std::ofstream out(fs::u8path(header_path), std::ios::binary);
+    if (!out) {
+        std::cerr << "Error: cannot write " << header_path << std::endl;
+        return 1;
+    }
+    out << "// Generated by ArtWeb --mime-gen from " << fs::u8path(source).filename().u8string() << ". Do not edit.\n"
+        << "// " << n << " extensions; see mime_table_lookup() in ArtWeb.cpp.\n"
+        << "#pragma once\n\n"
+        << "constexpr std::size_t MIME_BUCKET_COUNT = " << buckets << ";\n"
+        << "constexpr std::size_t MIME_SLOT_COUNT = " << slots << ";\n\n"
+        << "constexpr std::uint16_t g_mime_displacement[MIME_BUCKET_COUNT] = {";
+    for (std::size_t b = 0; b < buckets; ++b) out << (b % 16 ? " " : "\n    ") << displacement[b] << ",";
+    out << "\n};\n\nconstexpr MimeEntry g_mime_slots[MIME_SLOT_COUNT] = {\n";
+    for (std::size_t s = 0; s < slots; ++s) {
+        if (slot_entry[s] < 0) { out << "    {},\n"; continue; }
+        const auto& e = entries[static_cast<std::size_t>(slot_entry[s])];
+        out << "    { \"" << e.first << "\", \"" << add_charset_if_text(e.second) << "\" },\n";
+    }
+    out << "};\n";
+    std::cout << "Wrote " << header_path << " (" << n << " extensions, " << slots << " slots)" << std::endl;
+    return 0;
+}
+
+// FNV-1a/64: cheap content fingerprint (ETags) and bundle path hashing
+std::uint64_t fnv1a64(const char* data, std::size_t len, std::uint64_t hash = 1469598103934665603ULL) {
+    for (std::size_t i = 0; i < len; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Strong ETag from a content fingerprint and size, e.g. "0123456789abcdef-1f4"
+std::string make_etag(std::uint64_t fingerprint, std::uintmax_t size) {
+    std::ostringstream etag;
+    etag << '"' << std::hex << std::setw(16) << std::setfill('0') << fingerprint << "-" << size << '"';
+    return etag.str();
+}
+
+// ETag of the gzip representation of `etag`: "…-gz". The bytes differ, so a
+// strong validator must too.
+std::string gzip_etag(std::string_view etag) {
+    std::string gz(etag);
+    if (!gz.empty() && gz.back() == '"') gz.insert(gz.size() - 1, "-gz");
+    return gz;
+}
+
+// gzip variant for precompressed assets (embedded site, bundles).
+// Empty when zlib is not built in, the type is binary, or it saves less than 10%.
+std::string precompress_asset([[maybe_unused]] const std::string& content, [[maybe_unused]] std::string_view content_type) {
+    std::string gz;
+#ifdef CPPHTTPLIB_ZLIB_SUPPORT
+    if (content.size() >= 256 && content_type.find("charset=") != std::string_view::npos) {
+        httplib::detail::gzip_compressor compressor;
+        compressor.compress(content.data(), content.size(), true,
+            [&gz](const char* data, size_t n) { gz.append(data, n); return true; });
+        if (gz.size() * 10 > content.size() * 9) gz.clear();
+    }
+#endif
+    return gz;
+}
+
+// ------------------------ Byte scanning ------------------------
+// The escaping helpers below copy runs of bytes that need no escaping in bulk.
+// Runs are found 16 (SSE2) or 32 (AVX2) bytes at a time; AVX2 is chosen at
+// startup when the CPU and OS support it, other targets use the scalar loop.
+
+enum class ByteClass { UrlUnreserved, UrlPath, NotPercent, LogPrintable };
+enum class SimdLevel { Scalar, SSE2, AVX2 };
+
+template <ByteClass C>
+inline bool is_clean_byte(unsigned char c) {
+    switch (C) {
+    case ByteClass::UrlPath:
+        if (c == '/') return true;
+        // fall through
+    case ByteClass::UrlUnreserved:
+        return (c >= '0' && c <= '9') || ((c | 0x20) >= 'a' && (c | 0x20) <= 'z') ||
+            c == '-' || c == '_' || c == '.' || c == '~';
+    case ByteClass::NotPercent:
+        return c != '%';
+    case ByteClass::LogPrintable:
+        return c >= 32 && c < 127;
+    }
+    return false;
+}
+
+template <ByteClass C>
+std::size_t clean_run_scalar(const unsigned char* p, std::size_t n) {
+    std::size_t i = 0;
+    while (i < n && is_clean_byte<C>(p[i])) ++i;
+    return i;
+}
+
+#ifdef ARTWEB_SSE2
+inline unsigned count_trailing_zeros(std::uint32_t x) {
+#ifdef _MSC_VER
+    unsigned long i;
+    _BitScanForward(&i, x);
+    return static_cast<unsigned>(i);
+#else
+    return static_cast<unsigned>(__builtin_ctz(x));
+#endif
+}
+
+// Signed compares: bytes >= 0x80 are negative and never fall inside an ASCII range.
+inline __m128i sse2_in_range(__m128i v, char lo, char hi) {
+    return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(static_cast<char>(lo - 1))),
+        _mm_cmplt_epi8(v, _mm_set1_epi8(static_cast<char>(hi + 1))));
+}
+
+// Bit i set when byte i of the block needs no escaping.
+template <ByteClass C>
+inline std::uint32_t sse2_clean_mask(__m128i v) {
+    if (C == ByteClass::NotPercent)
+        return ~static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('%')))) & 0xFFFF;
+    if (C == ByteClass::LogPrintable)
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(sse2_in_range(v, 32, 126)));
+    __m128i m = _mm_or_si128(sse2_in_range(v, '0', '9'), sse2_in_range(_mm_or_si128(v, _mm_set1_epi8(0x20)), 'a', 'z'));
+    m = _mm_or_si128(m, _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('-')), _mm_cmpeq_epi8(v, _mm_set1_epi8('_'))));
+    m = _mm_or_si128(m, _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('.')), _mm_cmpeq_epi8(v, _mm_set1_epi8('~'))));
+    if (C == ByteClass::UrlPath) m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('/')));
+    return static_cast<std::uint32_t>(_mm_movemask_epi8(m));
+}
+
+template <ByteClass C>
+std::size_t clean_run_sse2(const unsigned char* p, std::size_t n) {
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const std::uint32_t mask = sse2_clean_mask<C>(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)));
+        if (mask != 0xFFFF) return i + count_trailing_zeros(~mask);
+    }
+    return i + clean_run_scalar<C>(p + i, n - i);
+}
+#endif
+
+#ifdef ARTWEB_AVX2
+ARTWEB_TARGET_AVX2 inline __m256i avx2_in_range(__m256i v, char lo, char hi) {
+    return _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8(static_cast<char>(lo - 1))),
+        _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(hi + 1)), v));
+}
+
+template <ByteClass C>
+ARTWEB_TARGET_AVX2 inline std::uint32_t avx2_clean_mask(__m256i v) {
+    if (C == ByteClass::NotPercent)
+        return ~static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('%'))));
+    if (C == ByteClass::LogPrintable)
+        return static_cast<std::uint32_t>(_mm256_movemask_epi8(avx2_in_range(v, 32, 126)));
+    __m256i m = _mm256_or_si256(avx2_in_range(v, '0', '9'), avx2_in_range(_mm256_or_si256(v, _mm256_set1_epi8(0x20)), 'a', 'z'));
+    m = _mm256_or_si256(m, _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('-')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('_'))));
+    m = _mm256_or_si256(m, _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('.')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('~'))));
+    if (C == ByteClass::UrlPath) m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('/')));
+    return static_cast<std::uint32_t>(_mm256_movemask_epi8(m));
+}
+
+template <ByteClass C>
+ARTWEB_TARGET_AVX2 std::size_t clean_run_avx2(const unsigned char* p, std::size_t n) {
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        const std::uint32_t mask = avx2_clean_mask<C>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i)));
+        if (mask != 0xFFFFFFFFu) return i + count_trailing_zeros(~mask);
+    }
+    return i + clean_run_sse2<C>(p + i, n - i);
+}
+#endif
+
+SimdLevel detect_simd_level() {
+#if defined(ARTWEB_AVX2) && defined(_MSC_VER)
+    int regs[4];
+    __cpuid(regs, 1);
+    const bool osxsave_avx = (regs[2] & (1 << 27)) && (regs[2] & (1 << 28));
+    if (osxsave_avx && (_xgetbv(0) & 6) == 6) {
+        __cpuidex(regs, 7, 0);
+        if (regs[1] & (1 << 5)) return SimdLevel::AVX2;
+    }
+#elif defined(ARTWEB_AVX2)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+#endif
+#ifdef ARTWEB_SSE2
+    return SimdLevel::SSE2;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+SimdLevel g_simd_level = detect_simd_level();
+
+// Length of the leading run of `p` that needs no escaping for class C.
+template <ByteClass C>
+inline std::size_t clean_run(const char* data, std::size_t n) {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+    switch (g_simd_level) {
+#ifdef ARTWEB_AVX2
+    case SimdLevel::AVX2: return clean_run_avx2<C>(p, n);
+#endif
+#ifdef ARTWEB_SSE2
+    case SimdLevel::SSE2: return clean_run_sse2<C>(p, n);
+#endif
+    default: return clean_run_scalar<C>(p, n);
+    }
+}
+
+// --- Newline counting (line index, ?lines=) ---
+
+inline unsigned popcount32(std::uint32_t x) {
+#ifdef _MSC_VER
+    return static_cast<unsigned>(__popcnt(x));
+#else
+    return static_cast<unsigned>(__builtin_popcount(x));
+#endif
+}
+
+// Offset of the k-th set bit (k >= 1) of a mask with at least k bits set.
+inline unsigned nth_set_bit(std::uint32_t mask, std::uint64_t k) {
+    while (--k > 0) mask &= mask - 1;
+#ifdef _MSC_VER
+    unsigned long i;
+    _BitScanForward(&i, mask);
+    return static_cast<unsigned>(i);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+std::size_t skip_lines_scalar(const char* p, std::size_t n, std::uint64_t k, std::uint64_t& seen) {
+    std::size_t i = 0;
+    while (seen < k && i < n) {
+        const void* hit = std::memchr(p + i, '\n', n - i);
+        if (!hit) return n;
+        i = static_cast<std::size_t>(static_cast<const char*>(hit) - p) + 1;
+        ++seen;
+    }
+    return i;
+}
+
+#ifdef ARTWEB_SSE2
+std::size_t skip_lines_sse2(const char* p, std::size_t n, std::uint64_t k, std::uint64_t& seen) {
+    const __m128i nl = _mm_set1_epi8('\n');
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const std::uint32_t mask = static_cast<std::uint32_t>(_mm_movemask_epi8(
+            _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)), nl)));
+        const unsigned c = popcount32(mask);
+        if (seen + c >= k) {
+            const unsigned bit = nth_set_bit(mask, k - seen);
+            seen = k;
+            return i + bit + 1;
+        }
+        seen += c;
+    }
+    return i + skip_lines_scalar(p + i, n - i, k, seen);
+}
+#endif
+
+#ifdef ARTWEB_AVX2
+ARTWEB_TARGET_AVX2 std::size_t skip_lines_avx2(const char* p, std::size_t n, std::uint64_t k, std::uint64_t& seen) {
+    const __m256i nl = _mm256_set1_epi8('\n');
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        const std::uint32_t mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(
+            _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i)), nl)));
+        const unsigned c = popcount32(mask);
+        if (seen + c >= k) {
+            const unsigned bit = nth_set_bit(mask, k - seen);
+            seen = k;
+            return i + bit + 1;
+        }
+        seen += c;
+    }
+    return i + skip_lines_sse2(p + i, n - i, k, seen);
+}
+#endif
+
+// Count newlines in p[0, n) until `seen` reaches k: returns the offset just past
+// that newline, or n (with `seen` short of k) when the block runs out first.
+inline std::size_t skip_lines(const char* p, std::size_t n, std::uint64_t k, std::uint64_t& seen) {
+    if (seen >= k) return 0;
+    switch (g_simd_level) {
+#ifdef ARTWEB_AVX2
+    case SimdLevel::AVX2: return skip_lines_avx2(p, n, k, seen);
+#endif
+#ifdef ARTWEB_SSE2
+    case SimdLevel::SSE2: return skip_lines_sse2(p, n, k, seen);
+#endif
+    default: return skip_lines_scalar(p, n, k, seen);
+    }
+}
+
+// Last newline in p[0, n), or nullptr.
+inline const char* last_newline(const char* p, std::size_t n) {
+#if defined(__GLIBC__)
+    return static_cast<const char*>(memrchr(p, '\n', n));
+#else
+    for (std::size_t i = n; i-- > 0;) if (p[i] == '\n') return p + i;
+    return nullptr;
+#endif
+}
+
+// --- Literal search (?grep=) ---
+// Candidates are positions where both the first and the last byte of the
+// needle match, found a block at a time; each is then verified in full. With
+// icase the needle is lowercase and letters are compared with bit 5 set.
+
+inline bool ascii_alpha(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+inline bool literal_at(const char* p, const std::string& needle, bool icase) {
+    if (!icase) return std::memcmp(p, needle.data(), needle.size()) == 0;
+    for (std::size_t i = 0; i < needle.size(); ++i) {
+        const char c = ascii_alpha(p[i]) ? static_cast<char>(p[i] | 0x20) : p[i];
+        if (c != needle[i]) return false;
+    }
+    return true;
+}
+
+std::size_t find_literal_scalar(const char* p, std::size_t n, const std::string& needle, bool icase) {
+    const std::size_t m = needle.size();
+    if (m > n) return std::string::npos;
+    if (!icase || !ascii_alpha(needle[0])) {
+        for (std::size_t i = 0; i + m <= n;) {
+            const void* hit = std::memchr(p + i, needle[0], n - m + 1 - i);
+            if (!hit) break;
+            i = static_cast<std::size_t>(static_cast<const char*>(hit) - p);
+            if (literal_at(p + i, needle, icase)) return i;
+            ++i;
+        }
+        return std::string::npos;
+    }
+    for (std::size_t i = 0; i + m <= n; ++i) {
+        if ((p[i] | 0x20) == needle[0] && literal_at(p + i, needle, icase)) return i;
+    }
+    return std::string::npos;
+}
+
+#ifdef ARTWEB_SSE2
+inline __m128i sse2_eq_folded(__m128i v, char c, bool icase) {
+    if (icase && ascii_alpha(c)) v = _mm_or_si128(v, _mm_set1_epi8(0x20));
+    return _mm_cmpeq_epi8(v, _mm_set1_epi8(c));
+}
+
+std::size_t find_literal_sse2(const char* p, std::size_t n, const std::string& needle, bool icase) {
+    const std::size_t m = needle.size();
+    std::size_t i = 0;
+    for (; i + m - 1 + 16 <= n; i += 16) {
+        const __m128i first = sse2_eq_folded(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)), needle[0], icase);
+        const __m128i last = sse2_eq_folded(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i + m - 1)), needle[m - 1], icase);
+        for (std::uint32_t mask = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_and_si128(first, last))); mask; mask &= mask - 1) {
+            const std::size_t at = i + count_trailing_zeros(mask);
+            if (literal_at(p + at, needle, icase)) return at;
+        }
+    }
+    const std::size_t rest = find_literal_scalar(p + i, n - i, needle, icase);
+    return rest == std::string::npos ? rest : i + rest;
+}
+#endif
+
+#ifdef ARTWEB_AVX2
+ARTWEB_TARGET_AVX2 inline __m256i avx2_eq_folded(__m256i v, char c, bool icase) {
+    if (icase && ascii_alpha(c)) v = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+    return _mm256_cmpeq_epi8(v, _mm256_set1_epi8(c));
+}
+
+ARTWEB_TARGET_AVX2 std::size_t find_literal_avx2(const char* p, std::size_t n, const std::string& needle, bool icase) {
+    const std::size_t m = needle.size();
+    std::size_t i = 0;
+    for (; i + m - 1 + 32 <= n; i += 32) {
+        const __m256i first = avx2_eq_folded(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i)), needle[0], icase);
+        const __m256i last = avx2_eq_folded(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i + m - 1)), needle[m - 1], icase);
+        for (std::uint32_t mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(first, last))); mask; mask &= mask - 1) {
+            const std::size_t at = i + count_trailing_zeros(mask);
+            if (literal_at(p + at, needle, icase)) return at;
+        }
+    }
+    const std::size_t rest = find_literal_sse2(p + i, n - i, needle, icase);
+    return rest == std::string::npos ? rest : i + rest;
+}
+#endif
+
+// Offset of the first occurrence of a non-empty needle in p[0, n), or npos.
+inline std::size_t find_literal(const char* p, std::size_t n, const std::string& needle, bool icase) {
+    switch (g_simd_level) {
+#ifdef ARTWEB_AVX2
+    case SimdLevel::AVX2: return find_literal_avx2(p, n, needle, icase);
+#endif
+#ifdef ARTWEB_SSE2
+    case SimdLevel::SSE2: return find_literal_sse2(p, n, needle, icase);
+#endif
+    default: return find_literal_scalar(p, n, needle, icase);
+    }
+}
+
 // Base64 encoding (for HTTP Basic Auth)
 static const std::string base64_chars =
 "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
@@ -97,35 +707,52 @@ static const std::string base64_chars =
 "0123456789+/";
 
 std::string base64_encode(const std::string& in) {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(in.data());
+    const std::size_t n = in.size();
     std::string out;
-    int val = 0, valb = -6;
-    for (unsigned char c : in) {
-        val = (val << 8) + c;
-        valb += 8;
-        while (valb >= 0) {
-            out.push_back(base64_chars[(val >> valb) & 0x3F]);
-            valb -= 6;
-        }
+    out.reserve((n + 2) / 3 * 4);
+    std::size_t i = 0;
+    for (; i + 3 <= n; i += 3) {
+        const std::uint32_t v = (std::uint32_t(p[i]) << 16) | (std::uint32_t(p[i + 1]) << 8) | p[i + 2];
+        const char quad[4] = { base64_chars[v >> 18], base64_chars[(v >> 12) & 0x3F],
+            base64_chars[(v >> 6) & 0x3F], base64_chars[v & 0x3F] };
+        out.append(quad, 4);
+    }
+    if (i < n) {
+        const std::uint32_t v = (std::uint32_t(p[i]) << 16) | (i + 1 < n ? std::uint32_t(p[i + 1]) << 8 : 0);
+        out.push_back(base64_chars[v >> 18]);
+        out.push_back(base64_chars[(v >> 12) & 0x3F]);
+        out.push_back(i + 1 < n ? base64_chars[(v >> 6) & 0x3F] : '=');
+        out.push_back('=');
     }
-    if (valb > -6) out.push_back(base64_chars[((val << 8) >> (valb + 8)) & 0x3F]);
-    while (out.size() % 4) out.push_back('=');
     return out;
 }
 
-// URL encode helper
-std::string url_encode(const std::string& value) {
-    std::ostringstream escaped;
-    escaped.fill('0');
-    escaped << std::hex;
-    for (unsigned char c : value) {
-        if (isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~') {
-            escaped << c;
-        }
-        else {
-            escaped << '%' << std::setw(2) << int(c);
+// Percent-encode every byte outside class C (lowercase hex, as before).
+template <ByteClass C>
+std::string percent_encode(const std::string& value) {
+    static const char hex[] = "0123456789abcdef";
+    const char* p = value.data();
+    const std::size_t n = value.size();
+    std::string out;
+    out.reserve(n + n / 4);
+    std::size_t i = 0;
+    while (i < n) {
+        const std::size_t run = clean_run<C>(p + i, n - i);
+        out.append(p + i, run);
+        i += run;
+        if (i < n) {
+            const unsigned char c = static_cast<unsigned char>(p[i++]);
+            const char esc[3] = { '%', hex[c >> 4], hex[c & 0xF] };
+            out.append(esc, 3);
         }
     }
-    return escaped.str();
+    return out;
+}
+
+// URL encode helper (RFC 3986 unreserved characters are kept)
+std::string url_encode(const std::string& value) {
+    return percent_encode<ByteClass::UrlUnreserved>(value);
 }
 
 // URL decode helper (percent-decoding). '+' is kept as '+' (this is for paths too).
@@ -137,65 +764,63 @@ std::string url_decode(const std::string& value) {
         return -1;
         };
 
+    const char* p = value.data();
+    const std::size_t n = value.size();
     std::string out;
-    out.reserve(value.size());
-    for (size_t i = 0; i < value.size(); ++i) {
-        char c = value[i];
-        if (c == '%' && i + 2 < value.size()) {
-            int hi = hexval(value[i + 1]);
-            int lo = hexval(value[i + 2]);
+    out.reserve(n);
+    std::size_t i = 0;
+    while (i < n) {
+        const std::size_t run = clean_run<ByteClass::NotPercent>(p + i, n - i);
+        out.append(p + i, run);
+        i += run;
+        if (i >= n) break;
+        // p[i] == '%'
+        if (i + 2 < n) {
+            int hi = hexval(p[i + 1]);
+            int lo = hexval(p[i + 2]);
             if (hi >= 0 && lo >= 0) {
                 out.push_back(static_cast<char>((hi << 4) | lo));
-                i += 2;
+                i += 3;
                 continue;
             }
         }
-        out.push_back(c);
+        out.push_back('%');
+        ++i;
     }
     return out;
 }
 
 // Encode each path segment but keep '/' separators.
 std::string url_encode_path(const std::string& path) {
-    std::string out;
-    out.reserve(path.size());
-    std::string seg;
-    for (size_t i = 0; i < path.size(); ++i) {
-        char c = path[i];
-        if (c == '/') {
-            out += url_encode(seg);
-            out.push_back('/');
-            seg.clear();
-        }
-        else {
-            seg.push_back(c);
-        }
-    }
-    out += url_encode(seg);
-    return out;
+    return percent_encode<ByteClass::UrlPath>(path);
 }
 
 
 
 // Make first N bytes printable/safe for logs (CR/LF/TAB preserved, others as \xHH)
 std::string sanitize_for_log(const std::string& s, size_t maxlen = 1024) {
-    std::ostringstream o;
-    o << std::uppercase << std::hex;
-    size_t n = std::min(s.size(), maxlen);
-    for (size_t i = 0; i < n; ++i) {
-        unsigned char c = static_cast<unsigned char>(s[i]);
-        if (c == '\r') { o << "\\r"; }
-        else if (c == '\n') { o << "\\n"; }
-        else if (c == '\t') { o << "\\t"; }
-        else if (c >= 32 && c < 127) {
-            o << static_cast<char>(c);
-        }
+    static const char hex[] = "0123456789ABCDEF";
+    const char* p = s.data();
+    const std::size_t n = std::min(s.size(), maxlen);
+    std::string o;
+    o.reserve(n + 16);
+    std::size_t i = 0;
+    while (i < n) {
+        const std::size_t run = clean_run<ByteClass::LogPrintable>(p + i, n - i);
+        o.append(p + i, run);
+        i += run;
+        if (i >= n) break;
+        const unsigned char c = static_cast<unsigned char>(p[i++]);
+        if (c == '\r') { o += "\\r"; }
+        else if (c == '\n') { o += "\\n"; }
+        else if (c == '\t') { o += "\\t"; }
         else {
-            o << "\\x" << std::setw(2) << std::setfill('0') << static_cast<int>(c);
+            const char esc[4] = { '\\', 'x', hex[c >> 4], hex[c & 0xF] };
+            o.append(esc, 4);
         }
     }
-    if (s.size() > maxlen) o << "…(truncated)";
-    return o.str();
+    if (s.size() > maxlen) o += "…(truncated)";
+    return o;
 }
 
 // POST logging
@@ -270,568 +895,6530 @@ std::wstring utf8_to_wstring(const std::string& str) {
 
 
 
-// ANSI color support
-inline bool supports_color() {
-#ifdef _WIN32
-    // Enable Virtual Terminal Processing (VT) if possible
-    HANDLE hOut = GetStdHandle(STD_OUTPUT_HANDLE);
-    if (hOut == INVALID_HANDLE_VALUE) return false;
+// ------------------------ Path resolution ------------------------
 
-    DWORD mode = 0;
-    if (!GetConsoleMode(hOut, &mode)) {
-        // Not a console (redirected) OR very old console host -> no color
-        return false;
-    }
+// Served root, opened once at startup. Both handlers resolve request paths
+// relative to it instead of re-canonicalizing the root on every hit.
+struct RootDir {
+    fs::path path;           // as configured (web root or current directory)
+    std::string canonical;   // weakly_canonical(path), computed once
+    int dirfd = -1;          // POSIX: directory descriptor used as openat2 anchor
+};
 
-    DWORD newMode = mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING;
-    if (!SetConsoleMode(hOut, newMode)) {
-        // Classic cmd.exe (without VT) will fail here -> no color
-        return false;
+RootDir g_root;
+
+// Open descriptor shared between the file cache and in-flight responses.
+// All reads use pread(), so sharing never touches a common file offset.
+struct FileHandle {
+    int fd = -1;
+    explicit FileHandle(int f) : fd(f) {}
+    FileHandle(const FileHandle&) = delete;
+    FileHandle& operator=(const FileHandle&) = delete;
+    ~FileHandle() {
+#ifndef _WIN32
+        if (fd >= 0) close(fd);
+#endif
     }
-    return true;
+};
+
+// An opened request target plus the metadata taken from that same descriptor.
+struct ResolvedFile {
+    std::shared_ptr<FileHandle> handle; // POSIX only; empty on Windows
+    bool is_dir = false;
+    bool is_regular = false;
+    std::uintmax_t size = 0;
+    std::time_t mtime = 0;
+    std::uint32_t mtime_nsec = 0;
+    std::uint64_t dev = 0, ino = 0; // file identity, for the digest cache (POSIX)
+    fs::path path;           // full path of the target (inside the root), for MIME lookup and Windows I/O
+
+    int fd() const { return handle ? handle->fd : -1; }
+};
+
+enum class ResolveStatus { Ok, NotFound, Forbidden, Error };
+
+// file_time_type has an unspecified epoch in C++17; convert via the clocks' "now".
+std::time_t to_time_t(fs::file_time_type ftime) {
+    return std::chrono::system_clock::to_time_t(
+        std::chrono::time_point_cast<std::chrono::system_clock::duration>(
+            ftime - fs::file_time_type::clock::now() + std::chrono::system_clock::now()));
+}
+
+bool open_root(RootDir& root, const fs::path& path) {
+    root.path = path;
+    root.canonical = fs::weakly_canonical(path).string();
+#ifndef _WIN32
+    if (root.dirfd >= 0) close(root.dirfd);
+    root.dirfd = open(root.canonical.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    return root.dirfd >= 0;
 #else
-    // Respect NO_COLOR spec and avoid coloring when not a TTY or in "dumb" term
-    if (std::getenv("NO_COLOR")) return false;
-#include <unistd.h>
-    if (!isatty(STDOUT_FILENO)) return false;
-    const char* term = std::getenv("TERM");
-    if (!term || std::string(term) == "dumb") return false;
     return true;
 #endif
 }
 
-inline std::string colorize_blue(const std::string& s) {
-    static const char* BLUE = "\x1b[34m";
-    static const char* RESET = "\x1b[0m";
-    return std::string(BLUE) + s + RESET;
+#ifndef _WIN32
+inline std::uint32_t mtime_nsec_of(const struct stat& st) {
+#if defined(__APPLE__)
+    return static_cast<std::uint32_t>(st.st_mtimespec.tv_nsec);
+#else
+    return static_cast<std::uint32_t>(st.st_mtim.tv_nsec);
+#endif
 }
-inline std::string colorize_green(const std::string& s) {
-    static const char* GREEN = "\x1b[32m";
-    static const char* RESET = "\x1b[0m";
-    return std::string(GREEN) + s + RESET;
+
+// Fill type/size/mtime from an open descriptor (one statx/fstat, no path walk).
+bool stat_fd(int fd, ResolvedFile& out) {
+#if defined(__linux__) && defined(STATX_TYPE)
+    struct statx stx;
+    if (statx(fd, "", AT_EMPTY_PATH, STATX_TYPE | STATX_SIZE | STATX_MTIME | STATX_INO, &stx) == 0) {
+        out.is_dir = S_ISDIR(stx.stx_mode);
+        out.is_regular = S_ISREG(stx.stx_mode);
+        out.size = stx.stx_size;
+        out.mtime = static_cast<std::time_t>(stx.stx_mtime.tv_sec);
+        out.mtime_nsec = stx.stx_mtime.tv_nsec;
+        out.dev = static_cast<std::uint64_t>(makedev(stx.stx_dev_major, stx.stx_dev_minor)); // same as st_dev
+        out.ino = stx.stx_ino;
+        return true;
+    }
+#endif
+    struct stat st;
+    if (fstat(fd, &st) != 0) return false;
+    out.is_dir = S_ISDIR(st.st_mode);
+    out.is_regular = S_ISREG(st.st_mode);
+    out.size = static_cast<std::uintmax_t>(st.st_size);
+    out.mtime = st.st_mtime;
+    out.mtime_nsec = mtime_nsec_of(st);
+    out.dev = static_cast<std::uint64_t>(st.st_dev);
+    out.ino = static_cast<std::uint64_t>(st.st_ino);
+    return true;
 }
-inline std::string colorize_yellow(const std::string& s) {
-    static const char* YELLOW = "\x1b[33m";
-    static const char* RESET = "\x1b[0m";
-    return std::string(YELLOW) + s + RESET;
+#endif
+
+// Resolve `rel` below the root and open it.
+// Linux: a single openat2(RESOLVE_BENEATH | RESOLVE_NO_MAGICLINKS) from the root dirfd,
+// so the kernel enforces confinement while walking the path. Elsewhere (or when openat2
+// is unavailable, e.g. old kernels or seccomp) this falls back to the canonical-prefix check.
+ResolveStatus resolve_beneath(const RootDir& root, const std::string& rel, ResolvedFile& out) {
+    // Request paths are root-relative; never let a leading '/' turn them absolute.
+    std::size_t skip = 0;
+    while (skip < rel.size() && (rel[skip] == '/' || rel[skip] == '\\')) ++skip;
+    const std::string relative = (skip < rel.size()) ? rel.substr(skip) : ".";
+
+#ifdef __linux__
+    static std::atomic<bool> openat2_unavailable{ false }; // set by whichever worker sees ENOSYS first
+    if (!openat2_unavailable.load(std::memory_order_relaxed) && root.dirfd >= 0) {
+        struct open_how how;
+        std::memset(&how, 0, sizeof(how));
+        how.flags = O_RDONLY | O_CLOEXEC | O_NOCTTY | O_NONBLOCK;
+        how.resolve = RESOLVE_BENEATH | RESOLVE_NO_MAGICLINKS;
+        int fd = static_cast<int>(syscall(SYS_openat2, root.dirfd, relative.c_str(), &how, sizeof(how)));
+        if (fd >= 0) {
+            out.handle = std::make_shared<FileHandle>(fd);
+            out.path = fs::path(root.canonical) / fs::u8path(relative);
+            return stat_fd(fd, out) ? ResolveStatus::Ok : ResolveStatus::Error;
+        }
+        switch (errno) {
+        case ENOENT:
+        case ENOTDIR:
+        case ENAMETOOLONG:
+            return ResolveStatus::NotFound;
+        case EXDEV:
+            // Left the root or hit an absolute symlink; the latter may still point
+            // inside the root, so let the canonical check below decide.
+            break;
+        case ELOOP:
+        case EACCES:
+            return ResolveStatus::Forbidden;
+        case ENOSYS:
+        case EPERM:
+        case E2BIG:
+            openat2_unavailable.store(true, std::memory_order_relaxed);
+            break;
+        default:
+            return ResolveStatus::Error;
+        }
+    }
+#endif
+
+    std::error_code ec;
+    auto canonical_full = fs::weakly_canonical(root.path / fs::u8path(relative), ec);
+    if (ec || canonical_full.string().rfind(root.canonical, 0) != 0) {
+        return ResolveStatus::Forbidden;
+    }
+    out.path = canonical_full;
+#ifndef _WIN32
+    int fd = open(canonical_full.c_str(), O_RDONLY | O_CLOEXEC | O_NOCTTY | O_NONBLOCK);
+    if (fd < 0) {
+        return (errno == ENOENT || errno == ENOTDIR) ? ResolveStatus::NotFound
+            : (errno == EACCES) ? ResolveStatus::Forbidden : ResolveStatus::Error;
+    }
+    out.handle = std::make_shared<FileHandle>(fd);
+    return stat_fd(fd, out) ? ResolveStatus::Ok : ResolveStatus::Error;
+#else
+    auto st = fs::status(canonical_full, ec);
+    if (ec || !fs::exists(st)) return ResolveStatus::NotFound;
+    out.is_dir = fs::is_directory(st);
+    out.is_regular = fs::is_regular_file(st);
+    if (out.is_regular) out.size = fs::file_size(canonical_full, ec);
+    out.mtime = to_time_t(fs::last_write_time(canonical_full, ec));
+    return ResolveStatus::Ok;
+#endif
 }
 
+// ------------------------ File digests ------------------------
+// SHA-256 (OpenSSL), BLAKE3 and CRC-32C of files, for GET /path?hash=ALGO
+// and for upload verification. Large files are hashed on several threads
+// where the algorithm allows it (BLAKE3 subtrees, CRC-32C segments joined
+// with crc32c_combine); SHA-256 is sequential, so its reads are overlapped
+// with the hashing instead. Results are cached by file identity (device,
+// inode, mtime, size) and also feed Repr-Digest/ETag on plain downloads.
+
+// Incremental SHA-256 through OpenSSL (SHA-NI/AVX2 code paths where the CPU has them).
+class Sha256 {
+public:
+    Sha256() : ctx_(EVP_MD_CTX_new()) { EVP_DigestInit_ex(ctx_, EVP_sha256(), nullptr); }
+    Sha256(const Sha256& other) : ctx_(EVP_MD_CTX_new()) { EVP_MD_CTX_copy_ex(ctx_, other.ctx_); }
+    Sha256& operator=(const Sha256& other) {
+        if (this != &other) EVP_MD_CTX_copy_ex(ctx_, other.ctx_);
+        return *this;
+    }
+    ~Sha256() { EVP_MD_CTX_free(ctx_); }
 
+    void update(const char* data, std::size_t n) { EVP_DigestUpdate(ctx_, data, n); }
 
-//Logo
-inline std::string make_startup_logo() {
-    std::string ver = VERSION;
-    if (!ver.empty() && (ver[0] == 'v' || ver[0] == 'V')) {
-        ver.erase(0, 1);
+    // Raw digest of everything so far; the state stays usable.
+    std::string digest() const {
+        Sha256 copy(*this);
+        unsigned char out[EVP_MAX_MD_SIZE];
+        unsigned int len = 0;
+        EVP_DigestFinal_ex(copy.ctx_, out, &len);
+        return std::string(reinterpret_cast<const char*>(out), len);
     }
 
-    std::ostringstream s;
-    s <<
-        R"(
- _____     _   _ _ _     _        
-|  _  |___| |_| | | |___| |_
-|     |  _|  _| | | | -_| . |
-|__|__|_| |_| |_____|___|___| 
-)";
-    return s.str();
-}
+private:
+    EVP_MD_CTX* ctx_;
+};
 
+std::string to_hex(const std::string& bytes) {
+    static const char digits[] = "0123456789abcdef";
+    std::string out;
+    out.reserve(bytes.size() * 2);
+    for (unsigned char c : bytes) {
+        out.push_back(digits[c >> 4]);
+        out.push_back(digits[c & 0x0F]);
+    }
+    return out;
+}
 
-inline std::string make_startup_footer() {
-    std::string ver = VERSION;                // e.g., "v2.1"
-    if (!ver.empty() && (ver[0] == 'v' || ver[0] == 'V')) ver.erase(0, 1);
+// Inverse of to_hex; expects an even number of hex digits.
+std::string from_hex(const std::string& hex) {
+    auto nibble = [](char c) { return c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10; };
+    std::string out;
+    for (std::size_t i = 0; i + 1 < hex.size(); i += 2) {
+        out.push_back(static_cast<char>((nibble(hex[i]) << 4) | nibble(hex[i + 1])));
+    }
+    return out;
+}
 
-    std::ostringstream s;
-    s << "ArtWeb by @art3x      ver " << ver << "\n"
-        << "https://github.com/art3x\n\n";
-    return s.str();
+// Digest field value for the Repr-Digest header (RFC 9530).
+std::string repr_digest_sha256(const std::string& raw) {
+    return "sha-256=:" + base64_encode(raw) + ":";
 }
 
-inline void print_logo() {
-    std::string logo = make_startup_logo();
-    std::string footer = make_startup_footer();
+// --- CRC-32C (Castagnoli), SSE4.2 crc32 instruction where available ---
 
-    if (supports_color()) {
-        logo = colorize_green(logo);
-        footer = colorize_blue(footer);
+constexpr std::uint32_t CRC32C_POLY = 0x82F63B78u; // reflected
+
+struct Crc32cTable {
+    std::uint32_t t[8][256];
+    Crc32cTable() {
+        for (std::uint32_t i = 0; i < 256; ++i) {
+            std::uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = (c >> 1) ^ ((c & 1) ? CRC32C_POLY : 0);
+            t[0][i] = c;
+        }
+        for (std::uint32_t i = 0; i < 256; ++i) {
+            for (int s = 1; s < 8; ++s) t[s][i] = (t[s - 1][i] >> 8) ^ t[0][t[s - 1][i] & 0xFF];
+        }
     }
+};
+
+// Slicing-by-8 on the raw (unconditioned) CRC register.
+std::uint32_t crc32c_scalar(std::uint32_t crc, const unsigned char* p, std::size_t n) {
+    static const Crc32cTable table;
+    const auto& t = table.t;
+    while (n >= 8) {
+        std::uint32_t lo, hi;
+        std::memcpy(&lo, p, 4);
+        std::memcpy(&hi, p + 4, 4);
+        lo ^= crc;
+        crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^
+            t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^ t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+        p += 8;
+        n -= 8;
+    }
+    while (n--) crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xFF];
+    return crc;
+}
 
-#ifdef _WIN32
-    std::wcout << utf8_to_wstring(logo);
-    std::wcout << utf8_to_wstring(footer);
+#if defined(ARTWEB_SSE2) && (defined(__x86_64__) || defined(_M_X64))
+#define ARTWEB_CRC32C_HW
+#if defined(_MSC_VER)
+#define ARTWEB_TARGET_SSE42
 #else
-    std::cout << logo << footer;
+#define ARTWEB_TARGET_SSE42 __attribute__((target("sse4.2")))
 #endif
-}
 
+ARTWEB_TARGET_SSE42
+std::uint32_t crc32c_hw(std::uint32_t crc, const unsigned char* p, std::size_t n) {
+    std::uint64_t c = crc;
+    while (n >= 8) {
+        std::uint64_t v;
+        std::memcpy(&v, p, 8);
+        c = _mm_crc32_u64(c, v);
+        p += 8;
+        n -= 8;
+    }
+    std::uint32_t c32 = static_cast<std::uint32_t>(c);
+    while (n--) c32 = _mm_crc32_u8(c32, *p++);
+    return c32;
+}
 
-#ifdef _WIN32
-inline std::wstring to_lower(std::wstring s) {
-    std::transform(s.begin(), s.end(), s.begin(),
-        [](wchar_t c) { return std::towlower(c); });
-    return s;
+bool cpu_has_sse42() {
+#if defined(_MSC_VER)
+    int regs[4];
+    __cpuid(regs, 1);
+    return (regs[2] & (1 << 20)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse4.2");
+#endif
 }
+#endif
 
-inline bool starts_with_icase(const std::wstring& s, const std::wstring& pref) {
-    if (s.size() < pref.size()) return false;
-    auto sl = to_lower(s);
-    auto pl = to_lower(pref);
-    return std::equal(pl.begin(), pl.end(), sl.begin());
+// Continue a CRC-32C: pass 0 to start; the result is the finished checksum.
+std::uint32_t crc32c_update(std::uint32_t crc, const char* data, std::size_t n) {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+#ifdef ARTWEB_CRC32C_HW
+    static const bool hw = cpu_has_sse42();
+    if (hw) return ~crc32c_hw(~crc, p, n);
+#endif
+    return ~crc32c_scalar(~crc, p, n);
 }
 
-inline bool contains_icase(const std::wstring& s, const std::wstring& needle) {
-    auto sl = to_lower(s);
-    auto nl = to_lower(needle);
-    return sl.find(nl) != std::wstring::npos;
+// CRC-32C of A||B from crc(A), crc(B) and len(B), as in zlib's crc32_combine.
+std::uint32_t crc32c_combine(std::uint32_t crc1, std::uint32_t crc2, std::uint64_t len2) {
+    auto times = [](const std::uint32_t* mat, std::uint32_t vec) {
+        std::uint32_t sum = 0;
+        for (int i = 0; vec; vec >>= 1, ++i) {
+            if (vec & 1) sum ^= mat[i];
+        }
+        return sum;
+    };
+    auto square = [&](std::uint32_t* sq, const std::uint32_t* mat) {
+        for (int n = 0; n < 32; ++n) sq[n] = times(mat, mat[n]);
+    };
+    if (len2 == 0) return crc1;
+    std::uint32_t even[32], odd[32];
+    odd[0] = CRC32C_POLY; // operator for one zero bit
+    for (int n = 1; n < 32; ++n) odd[n] = 1u << (n - 1);
+    square(even, odd);    // two zero bits
+    square(odd, even);    // four zero bits
+    do {
+        square(even, odd);
+        if (len2 & 1) crc1 = times(even, crc1);
+        len2 >>= 1;
+        if (len2 == 0) break;
+        square(odd, even);
+        if (len2 & 1) crc1 = times(odd, crc1);
+        len2 >>= 1;
+    } while (len2 != 0);
+    return crc1 ^ crc2;
 }
-#endif
 
+// --- BLAKE3 (portable compression; parallel over subtrees for big files) ---
 
-inline void print_ipv4_list_after_logo() {
-#ifdef _WIN32
-    // Enumerate adapters (IPv4 only)
-    ULONG flags = GAA_FLAG_SKIP_ANYCAST | GAA_FLAG_SKIP_MULTICAST | GAA_FLAG_SKIP_DNS_SERVER;
-    ULONG fam = AF_UNSPEC; // we'll filter per unicast addr
-    ULONG sz = 0;
-    if (GetAdaptersAddresses(fam, flags, nullptr, nullptr, &sz) != ERROR_BUFFER_OVERFLOW || sz == 0) {
-        return;
-    }
-    std::vector<unsigned char> buf(sz);
-    IP_ADAPTER_ADDRESSES* addrs = reinterpret_cast<IP_ADAPTER_ADDRESSES*>(buf.data());
-    if (GetAdaptersAddresses(fam, flags, nullptr, addrs, &sz) != NO_ERROR) {
-        return;
-    }
+namespace blake3 {
 
-    // Collect (name, ip) pairs, filtered by interface name
-    std::vector<std::pair<std::wstring, std::wstring>> entries;
+constexpr std::size_t BLOCK_LEN = 64;
+constexpr std::size_t CHUNK_LEN = 1024;
+constexpr std::uint32_t CHUNK_START = 1, CHUNK_END = 2, PARENT = 4, ROOT = 8;
+constexpr std::uint32_t IV[8] = { 0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A, 0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19 };
+constexpr unsigned PERMUTATION[16] = { 2, 6, 3, 10, 7, 0, 4, 13, 1, 11, 12, 5, 9, 14, 15, 8 };
 
-    for (auto* a = addrs; a; a = a->Next) {
-        if (a->OperStatus != IfOperStatusUp) continue;
+using Cv = std::array<std::uint32_t, 8>;
 
-        std::wstring name = a->FriendlyName ? a->FriendlyName : L"";
-        if (name.empty()) continue;
+inline std::uint32_t rotr(std::uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
 
-        // Filter: Linux-like prefixes + common Windows equivalents
-        bool match =
-            starts_with_icase(name, L"eth") ||
-            starts_with_icase(name, L"ens") ||
-            starts_with_icase(name, L"tun") ||
-            starts_with_icase(name, L"ethernet") ||
-            starts_with_icase(name, L"vEthernet") ||
-            contains_icase(name, L"Wi-Fi") ||
-            contains_icase(name, L"TAP") ||
-            contains_icase(name, L"TUN") ||
-            contains_icase(name, L"WireGuard") ||
-            contains_icase(name, L"OpenVPN");
+inline void g(std::uint32_t* s, int a, int b, int c, int d, std::uint32_t mx, std::uint32_t my) {
+    s[a] = s[a] + s[b] + mx; s[d] = rotr(s[d] ^ s[a], 16);
+    s[c] = s[c] + s[d];      s[b] = rotr(s[b] ^ s[c], 12);
+    s[a] = s[a] + s[b] + my; s[d] = rotr(s[d] ^ s[a], 8);
+    s[c] = s[c] + s[d];      s[b] = rotr(s[b] ^ s[c], 7);
+}
 
-        if (!match) continue;
+void compress(const Cv& cv, const std::uint32_t block[16], std::uint64_t counter,
+    std::uint32_t block_len, std::uint32_t flags, std::uint32_t out[16]) {
+    std::uint32_t s[16] = { cv[0], cv[1], cv[2], cv[3], cv[4], cv[5], cv[6], cv[7],
+        IV[0], IV[1], IV[2], IV[3], static_cast<std::uint32_t>(counter), static_cast<std::uint32_t>(counter >> 32), block_len, flags };
+    std::uint32_t m[16];
+    std::memcpy(m, block, sizeof(m));
+    for (int round = 0; round < 7; ++round) {
+        g(s, 0, 4, 8, 12, m[0], m[1]);
+        g(s, 1, 5, 9, 13, m[2], m[3]);
+        g(s, 2, 6, 10, 14, m[4], m[5]);
+        g(s, 3, 7, 11, 15, m[6], m[7]);
+        g(s, 0, 5, 10, 15, m[8], m[9]);
+        g(s, 1, 6, 11, 12, m[10], m[11]);
+        g(s, 2, 7, 8, 13, m[12], m[13]);
+        g(s, 3, 4, 9, 14, m[14], m[15]);
+        if (round < 6) {
+            std::uint32_t p[16];
+            for (int i = 0; i < 16; ++i) p[i] = m[PERMUTATION[i]];
+            std::memcpy(m, p, sizeof(m));
+        }
+    }
+    for (int i = 0; i < 8; ++i) {
+        out[i] = s[i] ^ s[i + 8];
+        out[i + 8] = s[i + 8] ^ cv[i];
+    }
+}
 
-        for (auto* ua = a->FirstUnicastAddress; ua; ua = ua->Next) {
-            if (!ua->Address.lpSockaddr) continue;
-            if (ua->Address.lpSockaddr->sa_family != AF_INET) continue;
+inline void load_block(const unsigned char* p, std::size_t n, std::uint32_t block[16]) {
+    unsigned char bytes[BLOCK_LEN] = {};
+    std::memcpy(bytes, p, n);
+    for (int i = 0; i < 16; ++i) {
+        block[i] = static_cast<std::uint32_t>(bytes[4 * i]) | (static_cast<std::uint32_t>(bytes[4 * i + 1]) << 8) |
+            (static_cast<std::uint32_t>(bytes[4 * i + 2]) << 16) | (static_cast<std::uint32_t>(bytes[4 * i + 3]) << 24);
+    }
+}
 
-            auto* sin = reinterpret_cast<sockaddr_in*>(ua->Address.lpSockaddr);
-            wchar_t ipw[64] = L"";
-            if (InetNtopW(AF_INET, &sin->sin_addr, ipw, 64)) {
-                entries.emplace_back(name, std::wstring(ipw));
+// The last compression of a node, kept until we know whether it is the root.
+struct Output {
+    Cv cv;
+    std::uint32_t block[16];
+    std::uint64_t counter;
+    std::uint32_t block_len;
+    std::uint32_t flags;
+
+    Cv chaining_value() const {
+        std::uint32_t out[16];
+        compress(cv, block, counter, block_len, flags, out);
+        Cv r;
+        std::copy(out, out + 8, r.begin());
+        return r;
+    }
+
+    std::string root_hash() const {
+        std::uint32_t out[16];
+        compress(cv, block, 0, block_len, flags | ROOT, out);
+        std::string bytes(32, '\0');
+        for (int i = 0; i < 8; ++i) {
+            for (int b = 0; b < 4; ++b) bytes[4 * i + b] = static_cast<char>(out[i] >> (8 * b));
+        }
+        return bytes;
+    }
+};
+
+inline Output parent_output(const Cv& left, const Cv& right) {
+    Output o;
+    o.cv = Cv{ IV[0], IV[1], IV[2], IV[3], IV[4], IV[5], IV[6], IV[7] };
+    std::copy(left.begin(), left.end(), o.block);
+    std::copy(right.begin(), right.end(), o.block + 8);
+    o.counter = 0;
+    o.block_len = BLOCK_LEN;
+    o.flags = PARENT;
+    return o;
+}
+
+struct ChunkState {
+    Cv cv{ IV[0], IV[1], IV[2], IV[3], IV[4], IV[5], IV[6], IV[7] };
+    std::uint64_t counter = 0;
+    unsigned char block[BLOCK_LEN] = {};
+    std::size_t block_len = 0;
+    std::size_t blocks_compressed = 0;
+
+    explicit ChunkState(std::uint64_t chunk_counter = 0) : counter(chunk_counter) {}
+
+    std::size_t len() const { return BLOCK_LEN * blocks_compressed + block_len; }
+    std::uint32_t start_flag() const { return blocks_compressed == 0 ? CHUNK_START : 0; }
+
+    void update(const unsigned char* p, std::size_t n) {
+        while (n > 0) {
+            if (block_len == BLOCK_LEN) {
+                std::uint32_t words[16], out[16];
+                load_block(block, BLOCK_LEN, words);
+                compress(cv, words, counter, BLOCK_LEN, start_flag(), out);
+                std::copy(out, out + 8, cv.begin());
+                ++blocks_compressed;
+                block_len = 0;
             }
+            const std::size_t take = std::min(BLOCK_LEN - block_len, n);
+            std::memcpy(block + block_len, p, take);
+            block_len += take;
+            p += take;
+            n -= take;
         }
     }
 
-    std::sort(entries.begin(), entries.end());
-    std::wostringstream oss;
-    if (!entries.empty()) {
-        oss << L"Listening on:\n";
-        for (auto& e : entries) {
-            oss << L"  " << e.first << L": " << e.second << L"\n";
+    Output output() const {
+        Output o;
+        o.cv = cv;
+        load_block(block, block_len, o.block);
+        o.counter = counter;
+        o.block_len = static_cast<std::uint32_t>(block_len);
+        o.flags = start_flag() | CHUNK_END;
+        return o;
+    }
+};
+
+class Hasher {
+public:
+    void update(const char* data, std::size_t n) {
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+        while (n > 0) {
+            if (chunk_.len() == CHUNK_LEN) {
+                const std::uint64_t total_chunks = chunk_.counter + 1;
+                push_subtree(chunk_.output().chaining_value(), total_chunks);
+                chunk_ = ChunkState(total_chunks);
+            }
+            const std::size_t take = std::min(CHUNK_LEN - chunk_.len(), n);
+            chunk_.update(p, take);
+            p += take;
+            n -= take;
         }
     }
-    else {
-        oss << L"Listening on: can't find any\n";
+
+    // Add the chaining value of a complete subtree whose chunks end at `total_units`
+    // (counted in subtree-sized units), before any byte that follows it.
+    void push_subtree(Cv cv, std::uint64_t total_units) {
+        while ((total_units & 1) == 0) {
+            cv = parent_output(stack_.back(), cv).chaining_value();
+            stack_.pop_back();
+            total_units >>= 1;
+        }
+        stack_.push_back(cv);
     }
 
-    std::wstring out = oss.str();
+    // Continue after subtrees pushed by hand: the next chunk has index `chunk_counter`.
+    void set_chunk_counter(std::uint64_t chunk_counter) { chunk_ = ChunkState(chunk_counter); }
 
-    // Optional: colorize blue if VT is enabled
-    if (supports_color()) {
-        std::wcout << L"\x1b[33m" << out << L"\x1b[0m";
+    std::string digest() const {
+        Output o = chunk_.output();
+        for (auto it = stack_.rbegin(); it != stack_.rend(); ++it) o = parent_output(*it, o.chaining_value());
+        return o.root_hash();
     }
-    else {
-        std::wcout << out;
+
+private:
+    ChunkState chunk_;
+    std::vector<Cv> stack_;
+};
+
+// Chaining value of 2^k whole chunks starting at chunk `first` (never the root).
+Cv subtree_cv(const char* data, std::size_t chunks, std::uint64_t first) {
+    std::vector<Cv> level(chunks);
+    for (std::size_t i = 0; i < chunks; ++i) {
+        ChunkState c(first + i);
+        c.update(reinterpret_cast<const unsigned char*>(data) + i * CHUNK_LEN, CHUNK_LEN);
+        level[i] = c.output().chaining_value();
+    }
+    while (level.size() > 1) {
+        for (std::size_t i = 0; i < level.size() / 2; ++i) level[i] = parent_output(level[2 * i], level[2 * i + 1]).chaining_value();
+        level.resize(level.size() / 2);
     }
+    return level[0];
+}
 
+} // namespace blake3
 
-#else
-    // POSIX: use getifaddrs for eth*/ens*/tun*
-    ifaddrs* ifaddr = nullptr;
-    if (getifaddrs(&ifaddr) != 0 || !ifaddr) return;
+// --- Digest cache ---
 
-    std::vector<std::pair<std::string, std::string>> entries;
+enum class DigestAlgo { Sha256, Blake3, Crc32c };
 
-    for (ifaddrs* ifa = ifaddr; ifa; ifa = ifa->ifa_next) {
-        if (!ifa || !ifa->ifa_name || !ifa->ifa_addr) continue;
-        if (!(ifa->ifa_flags & IFF_UP)) continue;
-        if (ifa->ifa_addr->sa_family != AF_INET) continue;
+bool parse_digest_algo(const std::string& name, DigestAlgo& out) {
+    if (name == "sha256") out = DigestAlgo::Sha256;
+    else if (name == "blake3") out = DigestAlgo::Blake3;
+    else if (name == "crc32c") out = DigestAlgo::Crc32c;
+    else return false;
+    return true;
+}
 
-        std::string name = ifa->ifa_name;
-        if (!(name.rfind("eth", 0) == 0 || name.rfind("ens", 0) == 0 || name.rfind("tun", 0) == 0)) {
-            continue;
-        }
+// Identity of a file's current contents: device, inode, mtime (ns) and size
+// on POSIX; path, mtime and size on Windows.
+std::string file_identity(const ResolvedFile& file) {
+    std::ostringstream key;
+#ifndef _WIN32
+    key << file.dev << ':' << file.ino << ':' << file.mtime << '.' << file.mtime_nsec << ':' << file.size;
+#else
+    key << file.path.u8string() << ':' << file.mtime << ':' << file.size;
+#endif
+    return key.str();
+}
 
-        char buf[INET_ADDRSTRLEN] = { 0 };
-        auto* sin = reinterpret_cast<sockaddr_in*>(ifa->ifa_addr);
-        if (inet_ntop(AF_INET, &sin->sin_addr, buf, sizeof(buf))) {
-            entries.emplace_back(name, std::string(buf));
-        }
-    }
-    freeifaddrs(ifaddr);
+// Same identity for a path, from a fresh stat (used after uploads).
+bool file_identity_of(const fs::path& path, std::string& out) {
+    ResolvedFile file;
+#ifndef _WIN32
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) return false;
+    file.size = static_cast<std::uintmax_t>(st.st_size);
+    file.mtime = st.st_mtime;
+    file.mtime_nsec = mtime_nsec_of(st);
+    file.dev = static_cast<std::uint64_t>(st.st_dev);
+    file.ino = static_cast<std::uint64_t>(st.st_ino);
+#else
+    std::error_code ec;
+    file.path = fs::weakly_canonical(path, ec);
+    file.size = fs::file_size(path, ec);
+    if (ec) return false;
+    file.mtime = to_time_t(fs::last_write_time(path, ec));
+#endif
+    out = file_identity(file);
+    return true;
+}
 
-    std::sort(entries.begin(), entries.end());
+// Bounded LRU of raw digests by (file identity, algorithm). A changed file has a
+// new identity, so stale entries are never hit and simply age out.
+class DigestCache {
+public:
+    bool lookup(const std::string& identity, DigestAlgo algo, std::string& raw) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(key(identity, algo));
+        if (it == entries_.end()) return false;
+        lru_.splice(lru_.begin(), lru_, it->second.lru);
+        raw = it->second.raw;
+        hits.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
 
-    std::ostringstream oss;
-    if (!entries.empty()) {
-        oss << "Listening on:\n";
-        for (auto& e : entries) {
-            oss << "  " << e.first << ": " << e.second << "\n";
+    void store(const std::string& identity, DigestAlgo algo, const std::string& raw) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const std::string k = key(identity, algo);
+        auto it = entries_.find(k);
+        if (it != entries_.end()) {
+            it->second.raw = raw;
+            return;
         }
-    }
-    else {
-        oss << "Listening on: can't find any\n";
+        while (entries_.size() >= kMaxEntries && !lru_.empty()) {
+            entries_.erase(lru_.back());
+            lru_.pop_back();
+        }
+        lru_.push_front(k);
+        entries_[k] = Entry{ raw, lru_.begin() };
     }
 
-    std::string out = oss.str();
-    if (supports_color()) out = colorize_yellow(out);
-    std::cout << out;
-#endif
-}
-
+    std::atomic<std::uint64_t> hits{ 0 };
+    std::atomic<std::uint64_t> bytes_hashed{ 0 };
 
-
-// Help/usage
-void print_usage(const char* progname) {
+private:
+    static constexpr std::size_t kMaxEntries = 4096;
+    struct Entry {
+        std::string raw;
+        std::list<std::string>::iterator lru;
+    };
+    static std::string key(const std::string& identity, DigestAlgo algo) {
+        return identity + '#' + static_cast<char>('0' + static_cast<int>(algo));
+    }
+    std::mutex mutex_;
+    std::unordered_map<std::string, Entry> entries_;
+    std::list<std::string> lru_; // front = most recently used
+};
+
+DigestCache g_digests;
+
+// RFC 9110 IMF-fixdate ("Sun, 06 Nov 1994 08:49:37 GMT"), independent of the locale.
+std::string http_date(std::time_t t) {
+    static const char* const days[] = { "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat" };
+    static const char* const months[] = { "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec" };
+    std::tm tm{};
 #ifdef _WIN32
-    std::wstring wprogname = utf8_to_wstring(std::string(progname));
-    std::wcout << L"Usage: " << wprogname << L" [options]\n"
-        << L"Options:\n"
-        << L"  -h, --help               Print this help message\n"
-        << L"  -p, --port PORT          Set the port (default: 80 for HTTP, 443 for HTTPS)\n"
-        << L"  -i, --index DIR_PATH     Serve static files from a directory. `index.html` is the default page.\n"
-        << L"  --pass PASSWORD          Enable HTTP Basic authentication (username is 'admin')\n"
-        << L"  --proxy                  Use proxy-safe (chunked) uploads (slower, but proxy friendly)\n"
-        << L"  --unlim                  Unlimited upload size (more than 1 Gb)\n"
-        << L"  -s, --ssl                Enable HTTPS mode\n"
-        << L"  -c, --cert CERT_PATH     Path to SSL certificate file (required for --ssl)\n"
-        << L"  -k, --key KEY_PATH       Path to SSL private key file (required for --ssl)\n";
+    gmtime_s(&tm, &t);
 #else
-    std::cout << "Usage: " << progname << " [options]\n"
-        << "Options:\n"
-        << "  -h, --help               Print this help message\n"
-        << "  -p, --port PORT          Set the port (default: 80 for HTTP, 443 for HTTPS)\n"
-        << "  -i, --index DIR_PATH     Serve static files from a directory. `index.html` is the default page.\n"
-        << "  --pass PASSWORD          Enable HTTP Basic authentication (username is 'admin')\n"
-        << "  --proxy                  Use proxy-safe (chunked) uploads (slower, but proxy friendly)\n"
-        << "  --unlim                  Unlimited upload size (more than 1 Gb)\n"
-        << "  -s, --ssl                Enable HTTPS mode\n"
-        << "  -c, --cert CERT_PATH     Path to SSL certificate file (required for --ssl)\n"
-        << "  -k, --key KEY_PATH       Path to SSL private key file (required for --ssl)\n";
+    gmtime_r(&t, &tm);
 #endif
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%s, %02d %s %04d %02d:%02d:%02d GMT", days[tm.tm_wday], tm.tm_mday,
+        months[tm.tm_mon], tm.tm_year + 1900, tm.tm_hour, tm.tm_min, tm.tm_sec);
+    return buf;
 }
 
-// HTTP Basic Auth check
-bool authenticate(const httplib::Request& req, httplib::Response& res) {
-    if (!require_auth) return true;
-    auto auth = req.get_header_value("Authorization");
-    if (auth != g_expected_auth_header) {
-        res.status = 401;
-        res.set_header("WWW-Authenticate", "Basic realm=\"User Visible Realm\"");
-        res.set_content("Unauthorized", "text/plain");
-        return false;
+// Validators and HEAD for a resolved regular file, from the stat taken when it
+// was resolved. Sets ETag/Last-Modified (and Repr-Digest when the file's SHA-256
+// is cached; the ETag stays mtime/size based either way, so it doesn't change
+// under clients when a digest lands in the cache); returns true when the response is
+// already complete (304, or HEAD with Content-Length/Content-Type and no body).
+bool answer_from_metadata(const httplib::Request& req, httplib::Response& res,
+    const ResolvedFile& file, std::string_view content_type) {
+    const std::string etag = make_etag(static_cast<std::uint64_t>(file.mtime), file.size);
+    std::string sha256;
+    if (g_digests.lookup(file_identity(file), DigestAlgo::Sha256, sha256)) {
+        res.set_header("Repr-Digest", repr_digest_sha256(sha256));
+    }
+    res.set_header("ETag", etag);
+    res.set_header("Last-Modified", http_date(file.mtime));
+    if (req.get_header_value("If-None-Match") == etag) {
+        res.status = 304;
+        return true;
     }
+    if (req.method != "HEAD") return false;
+    res.status = 200;
+    res.set_header("Content-Type", std::string(content_type));
+    res.set_header("Content-Length", std::to_string(file.size));
     return true;
 }
 
-// File Upload Handler
-void upload_handler(const httplib::Request& req, httplib::Response& res) {
-    if (!authenticate(req, res)) return;
 
-    auto file = req.get_file_value("file");
-    if (file.filename.empty()) {
-        res.status = 400;
-        res.set_content("No file uploaded", "text/plain");
-        return;
+// ------------------------ Open file cache ------------------------
+
+// Bounded LRU of resolve results, in the spirit of nginx's open_file_cache:
+// positive entries keep the descriptor open, negative entries (404/403) remember
+// misses so scanner probes are answered without touching the filesystem.
+// Entries live for g_file_cache_ttl seconds; any upload clears the cache.
+// Default size: a quarter of the open-file limit, at most 1024. Cached
+// descriptors have to leave room for sockets, uploads and everything else.
+std::size_t default_file_cache_size() {
+#ifndef _WIN32
+    struct rlimit rl;
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur != RLIM_INFINITY) {
+        return static_cast<std::size_t>(std::min<rlim_t>(1024, std::max<rlim_t>(16, rl.rlim_cur / 4)));
     }
+#endif
+    return 1024;
+}
 
-    // Proxy uploads can be slow/fragile; support chunked uploads where the browser
-    // sends many small multipart requests and we append them server-side.
-    const bool is_chunked_upload =
-        req.has_param("upload_id") &&
-        req.has_param("chunk_index") &&
-        req.has_param("total_chunks") &&
-        req.has_param("offset") &&
-        req.has_param("file_size");
+std::size_t g_file_cache_max = default_file_cache_size();   // 0 disables the cache
+int g_file_cache_ttl = 5;              // seconds
 
-    if (!g_unlimited_upload && !is_chunked_upload && file.content.size() > MAX_UPLOAD_SIZE) {
-        res.status = 413;
-        res.set_content("Uploaded file is too large", "text/plain");
-        return;
+struct FileCacheEntry {
+    ResolveStatus status = ResolveStatus::NotFound;
+    ResolvedFile file;
+    std::chrono::steady_clock::time_point expires;
+    std::list<std::string>::iterator lru;
+};
+
+std::mutex g_file_cache_mutex;
+std::unordered_map<std::string, FileCacheEntry> g_file_cache;
+std::list<std::string> g_file_cache_lru; // front = most recently used
+
+void file_cache_clear() {
+    std::lock_guard<std::mutex> lock(g_file_cache_mutex);
+    g_file_cache.clear();
+    g_file_cache_lru.clear();
+}
+
+#ifndef _WIN32
+// Cheap revalidation of a cached descriptor: picks up size/mtime changes of
+// growing files and drops entries whose file has been deleted.
+bool refresh_cached_file(ResolvedFile& file) {
+    struct stat st;
+    if (fstat(file.fd(), &st) != 0 || st.st_nlink == 0) return false;
+    file.size = static_cast<std::uintmax_t>(st.st_size);
+    file.mtime = st.st_mtime;
+    file.mtime_nsec = mtime_nsec_of(st);
+    return true;
+}
+#endif
+
+ResolveStatus resolve_cached(const RootDir& root, const std::string& rel, ResolvedFile& out) {
+    if (g_file_cache_max == 0) return resolve_beneath(root, rel, out);
+
+    const auto now = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(g_file_cache_mutex);
+        auto it = g_file_cache.find(rel);
+        if (it != g_file_cache.end()) {
+            auto& entry = it->second;
+            bool usable = entry.expires > now;
+#ifndef _WIN32
+            if (usable && entry.status == ResolveStatus::Ok) usable = refresh_cached_file(entry.file);
+#endif
+            if (usable) {
+                g_file_cache_lru.splice(g_file_cache_lru.begin(), g_file_cache_lru, entry.lru);
+                out = entry.file;
+                return entry.status;
+            }
+            g_file_cache_lru.erase(entry.lru);
+            g_file_cache.erase(it);
+        }
     }
 
-    std::size_t declared_file_size = 0;
-    std::size_t chunk_index = 0;
-    std::size_t total_chunks = 0;
-    std::size_t offset = 0;
-    std::string upload_id;
-    if (is_chunked_upload) {
-        try {
-            upload_id = req.get_param_value("upload_id");
-            chunk_index = static_cast<std::size_t>(std::stoull(req.get_param_value("chunk_index")));
-            total_chunks = static_cast<std::size_t>(std::stoull(req.get_param_value("total_chunks")));
-            offset = static_cast<std::size_t>(std::stoull(req.get_param_value("offset")));
-            declared_file_size = static_cast<std::size_t>(std::stoull(req.get_param_value("file_size")));
+    const auto status = resolve_beneath(root, rel, out);
+    if (status == ResolveStatus::Error) return status; // transient, never cached
+
+    std::lock_guard<std::mutex> lock(g_file_cache_mutex);
+    if (g_file_cache.count(rel)) return status; // raced with another request
+    while (g_file_cache.size() >= g_file_cache_max && !g_file_cache_lru.empty()) {
+        g_file_cache.erase(g_file_cache_lru.back());
+        g_file_cache_lru.pop_back();
+    }
+    g_file_cache_lru.push_front(rel);
+    auto& entry = g_file_cache[rel];
+    entry.status = status;
+    if (status == ResolveStatus::Ok) entry.file = out;
+    entry.expires = now + std::chrono::seconds(g_file_cache_ttl);
+    entry.lru = g_file_cache_lru.begin();
+    return status;
+}
+
+
+// ------------------------ Bandwidth ------------------------
+
+// Token buckets with debt: a caller takes its bytes up front and sleeps off any
+// deficit, so concurrent users of one bucket share its rate without a timer thread.
+struct TokenBucket {
+    double rate = 0;        // bytes per second
+    double burst = 0;       // max saved-up tokens
+    double tokens = 0;
+    std::chrono::steady_clock::time_point last = std::chrono::steady_clock::now();
+
+    TokenBucket() = default;
+    explicit TokenBucket(std::uint64_t bytes_per_sec)
+        : rate(static_cast<double>(bytes_per_sec)),
+          burst(std::max(rate / 4, 256.0 * 1024)),
+          tokens(burst) {}
+
+    void refill(std::chrono::steady_clock::time_point now) {
+        tokens = std::min(burst, tokens + rate * std::chrono::duration<double>(now - last).count());
+        last = now;
+    }
+    // Seconds to wait before `n` bytes may pass.
+    double take(std::size_t n) {
+        refill(std::chrono::steady_clock::now());
+        tokens -= static_cast<double>(n);
+        return tokens < 0 ? -tokens / rate : 0.0;
+    }
+};
+
+// One direction (downloads or uploads) of the rate limiter: an optional
+// per-client-IP bucket, then a shared cap handed out by weighted fair queuing.
+// Each chunk gets a virtual finish tag (previous tag of its IP + bytes / weight)
+// and the cap serves the smallest tag first, so clients share the link by weight
+// no matter how many connections each one opens.
+class BandwidthScheduler {
+public:
+    std::uint64_t total_rate = 0;   // bytes/s for all clients, 0 = unlimited
+    std::uint64_t per_ip_rate = 0;  // bytes/s per client IP, 0 = unlimited
+    std::atomic<std::uint64_t> throttled_bytes{ 0 };   // bytes that had to wait
+    std::atomic<std::uint64_t> throttle_wait_us{ 0 };
+
+    bool enabled() const { return total_rate != 0 || per_ip_rate != 0; }
+
+    void set_weight(const std::string& ip, double weight) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        weights_[ip] = weight;
+    }
+
+    // Blocks until `n` bytes for `ip` may pass.
+    void acquire(const std::string& ip, std::size_t n) {
+        const auto start = std::chrono::steady_clock::now();
+        std::unique_lock<std::mutex> lock(mutex_);
+        Flow& flow = flow_for(ip);
+        ++flow.users;
+
+        if (per_ip_rate) {
+            const double wait = flow.bucket.take(n);
+            if (wait > 0) {
+                lock.unlock();
+                std::this_thread::sleep_for(std::chrono::duration<double>(wait));
+                lock.lock();
+            }
         }
-        catch (...) {
-            res.status = 400;
-            res.set_content("Invalid chunk parameters", "text/plain");
-            return;
+
+        if (total_rate) {
+            const double tag = std::max(virtual_time_, flow.finish) + static_cast<double>(n) / flow.weight;
+            flow.finish = tag;
+            const auto key = std::make_pair(tag, next_seq_++);
+            waiting_.insert(key);
+            for (;;) {
+                total_.refill(std::chrono::steady_clock::now());
+                const bool first = *waiting_.begin() == key;
+                if (first && total_.tokens >= 0) break;
+                if (first) cv_.wait_for(lock, std::chrono::duration<double>(-total_.tokens / total_.rate));
+                else cv_.wait(lock);
+            }
+            total_.tokens -= static_cast<double>(n);
+            virtual_time_ = tag;
+            waiting_.erase(key);
+            cv_.notify_all();
         }
+        --flow.users;
+        lock.unlock();
 
-        if (upload_id.empty() || upload_id.size() > 64 ||
-            std::any_of(upload_id.begin(), upload_id.end(), [](unsigned char c) {
-                return !(std::isalnum(c) || c == '_' || c == '-');
-                })) {
-            res.status = 400;
-            res.set_content("Invalid upload_id", "text/plain");
-            return;
+        const auto waited = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        if (waited >= 1000) {
+            throttled_bytes.fetch_add(n, std::memory_order_relaxed);
+            throttle_wait_us.fetch_add(static_cast<std::uint64_t>(waited), std::memory_order_relaxed);
         }
+    }
 
-        if (!g_unlimited_upload && declared_file_size > MAX_UPLOAD_SIZE) {
-            res.status = 413;
-            res.set_content("Uploaded file is too large", "text/plain");
-            return;
+    void configure(std::uint64_t total, std::uint64_t per_ip) {
+        total_rate = total;
+        per_ip_rate = per_ip;
+        total_ = TokenBucket(total ? total : 1);
+    }
+
+private:
+    struct Flow {
+        TokenBucket bucket;
+        double weight = 1;
+        double finish = 0;
+        int users = 0;
+    };
+
+    Flow& flow_for(const std::string& ip) {
+        auto it = flows_.find(ip);
+        if (it != flows_.end()) return it->second;
+        if (flows_.size() >= 4096) {
+            // Forget idle clients; their buckets would be full again anyway.
+            for (auto f = flows_.begin(); f != flows_.end();) {
+                if (f->second.users == 0) f = flows_.erase(f);
+                else ++f;
+            }
         }
+        Flow& flow = flows_[ip];
+        flow.bucket = TokenBucket(per_ip_rate ? per_ip_rate : 1);
+        auto w = weights_.find(ip);
+        if (w != weights_.end()) flow.weight = w->second;
+        flow.finish = virtual_time_;
+        return flow;
+    }
 
-        if (total_chunks == 0 || chunk_index >= total_chunks) {
-            res.status = 400;
-            res.set_content("Invalid chunk range", "text/plain");
-            return;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    TokenBucket total_;
+    std::unordered_map<std::string, Flow> flows_;
+    std::unordered_map<std::string, double> weights_;
+    std::set<std::pair<double, std::uint64_t>> waiting_;
+    std::uint64_t next_seq_ = 0;
+    double virtual_time_ = 0;
+};
+
+BandwidthScheduler g_outbound;              // --limit-rate, --limit-rate-ip
+BandwidthScheduler g_inbound;               // --limit-upload
+std::uint64_t g_limit_rate_conn = 0;        // --limit-rate-conn: bytes/s per download
+
+// "10M", "512k", "1g", "65536" -> bytes per second (binary multiples).
+bool parse_rate(const std::string& text, std::uint64_t& out) {
+    try {
+        std::size_t pos = 0;
+        const double value = std::stod(text, &pos);
+        double scale = 1;
+        if (pos < text.size()) {
+            switch (std::tolower(static_cast<unsigned char>(text[pos]))) {
+            case 'k': scale = 1024.0; break;
+            case 'm': scale = 1024.0 * 1024; break;
+            case 'g': scale = 1024.0 * 1024 * 1024; break;
+            default: return false;
+            }
+            if (pos + 1 != text.size()) return false;
         }
+        if (value < 0) return false;
+        out = static_cast<std::uint64_t>(value * scale);
+        return true;
+    }
+    catch (...) {
+        return false;
+    }
+}
 
-        if (offset > declared_file_size) {
-            res.status = 400;
-            res.set_content("Invalid offset", "text/plain");
-            return;
+// ---------------------------------------------------------------------------
+// File I/O engine
+// ---------------------------------------------------------------------------
+// Downloads and uploads read and write file data through here. "sync" is plain
+// pread/pwrite on the worker thread. "uring" (Linux, --io-engine uring) gives
+// each worker thread its own ring with registered buffers: downloads keep a few
+// chunks in flight ahead of the socket, uploads submit their writes in batches.
+// When a ring call fails, that call is redone on the sync path.
+
+enum class IoEngine { Sync, Uring };
+IoEngine g_io_engine = IoEngine::Sync;
+std::atomic<std::uint64_t> g_io_fallbacks{ 0 };    // ring calls redone with pread/pwrite
+std::uint64_t g_bulk_threshold = 8ull << 20;       // bytes (--bulk-threshold MB): bulk lane and page cache policy
+
+#ifndef _WIN32
+// pread until `n` bytes, EOF or an error; returns the bytes read.
+std::size_t pread_full(int fd, char* buf, std::size_t n, std::uint64_t offset) {
+    std::size_t got = 0;
+    while (got < n) {
+        ssize_t r = pread(fd, buf + got, n - got, static_cast<off_t>(offset + got));
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) break;
+        got += static_cast<std::size_t>(r);
+    }
+    return got;
+}
+
+bool pwrite_full(int fd, const char* data, std::size_t n, std::uint64_t offset) {
+    std::size_t done = 0;
+    while (done < n) {
+        ssize_t r = pwrite(fd, data + done, n - done, static_cast<off_t>(offset + done));
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) return false;
+        done += static_cast<std::size_t>(r);
+    }
+    return true;
+}
+#endif
+
+#ifdef ARTWEB_IO_URING
+// Minimal io_uring over the raw syscalls (no liburing dependency). Not
+// thread-safe: every worker thread owns its own ring.
+class Uring {
+public:
+    Uring() = default;
+    Uring(const Uring&) = delete;
+    Uring& operator=(const Uring&) = delete;
+    ~Uring() {
+        if (sqes_) munmap(sqes_, sqes_len_);
+        if (cq_ptr_ && cq_ptr_ != sq_ptr_) munmap(cq_ptr_, cq_len_);
+        if (sq_ptr_) munmap(sq_ptr_, sq_len_);
+        if (fd_ >= 0) close(fd_);
+    }
+
+    bool init(unsigned entries) {
+        io_uring_params p{};
+        fd_ = static_cast<int>(syscall(__NR_io_uring_setup, entries, &p));
+        if (fd_ < 0) return false;
+
+        const bool single_mmap = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        sq_len_ = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+        cq_len_ = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+        if (single_mmap) sq_len_ = cq_len_ = std::max(sq_len_, cq_len_);
+        sqes_len_ = p.sq_entries * sizeof(io_uring_sqe);
+
+        sq_ptr_ = map(sq_len_, IORING_OFF_SQ_RING);
+        if (!sq_ptr_) return false;
+        cq_ptr_ = single_mmap ? sq_ptr_ : map(cq_len_, IORING_OFF_CQ_RING);
+        if (!cq_ptr_) return false;
+        sqes_ = static_cast<io_uring_sqe*>(map(sqes_len_, IORING_OFF_SQES));
+        if (!sqes_) return false;
+
+        char* sq = static_cast<char*>(sq_ptr_);
+        sq_head_ = reinterpret_cast<unsigned*>(sq + p.sq_off.head);
+        sq_tail_ = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+        sq_mask_ = *reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+        sq_array_ = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+        char* cq = static_cast<char*>(cq_ptr_);
+        cq_head_ = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+        cq_tail_ = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+        cq_mask_ = *reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes);
+        entries_ = p.sq_entries;
+        local_tail_ = *sq_tail_;
+        return true;
+    }
+
+    bool register_buffers(const iovec* iov, unsigned n) {
+        return syscall(__NR_io_uring_register, fd_, IORING_REGISTER_BUFFERS, iov, n) == 0;
+    }
+
+    // True if the running kernel knows every opcode in `ops` (IORING_REGISTER_PROBE, 5.6+).
+    bool supports(std::initializer_list<unsigned> ops) {
+        const std::size_t size = sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op);
+        std::unique_ptr<char[]> buf(new char[size]());
+        auto* probe = reinterpret_cast<io_uring_probe*>(buf.get());
+        if (syscall(__NR_io_uring_register, fd_, IORING_REGISTER_PROBE, probe, 256) != 0) return false;
+        for (unsigned op : ops) {
+            if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) return false;
         }
+        return true;
     }
 
-    std::string safeFilename = fs::path(file.filename).filename().string();
-    if (safeFilename.empty()) {
-        res.status = 400;
-        res.set_content("Invalid file name", "text/plain");
-        return;
+    // Next free submission entry (zeroed), or nullptr when the queue is full.
+    io_uring_sqe* get_sqe() {
+        if (local_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= entries_) return nullptr;
+        const unsigned index = local_tail_ & sq_mask_;
+        sq_array_[index] = index;
+        ++local_tail_;
+        io_uring_sqe* sqe = &sqes_[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        return sqe;
     }
 
+    // Hand every queued entry to the kernel and optionally wait for `wait_nr`
+    // completions, all in one syscall.
+    bool enter(unsigned wait_nr) {
+        __atomic_store_n(sq_tail_, local_tail_, __ATOMIC_RELEASE);
+        for (;;) {
+            const unsigned pending = local_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+            if (pending == 0 && wait_nr == 0) return true;
+            if (syscall(__NR_io_uring_enter, fd_, pending, wait_nr, wait_nr ? IORING_ENTER_GETEVENTS : 0, nullptr, 0) >= 0) return true;
+            if (errno != EINTR) return false;
+        }
+    }
 
+    bool pop(io_uring_cqe& out) {
+        const unsigned head = *cq_head_;
+        if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) return false;
+        out = cqes_[head & cq_mask_];
+        __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+        return true;
+    }
 
-    const fs::path upload_root = fs::current_path();
-    auto canonical_root = fs::weakly_canonical(upload_root);
+    bool wait(io_uring_cqe& out) {
+        while (!pop(out)) {
+            if (!enter(1)) return false;
+        }
+        return true;
+    }
 
-    std::string targetDirStr = ".";
-    if (req.has_param("dir")) {
-        targetDirStr = req.get_param_value("dir");
+private:
+    void* map(std::size_t len, off_t offset) {
+        void* p = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, offset);
+        return p == MAP_FAILED ? nullptr : p;
     }
 
-    fs::path requested_path = upload_root / fs::u8path(targetDirStr);
-    auto canonical_target_dir = fs::weakly_canonical(requested_path);
+    int fd_ = -1;
+    void* sq_ptr_ = nullptr;
+    void* cq_ptr_ = nullptr;
+    io_uring_sqe* sqes_ = nullptr;
+    std::size_t sq_len_ = 0, cq_len_ = 0, sqes_len_ = 0;
+    unsigned* sq_head_ = nullptr;
+    unsigned* sq_tail_ = nullptr;
+    unsigned* sq_array_ = nullptr;
+    unsigned sq_mask_ = 0;
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    unsigned cq_mask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+    unsigned entries_ = 0;
+    unsigned local_tail_ = 0;
+};
+
+// A worker thread's ring and its registered read buffers.
+struct UringThreadState {
+    static constexpr unsigned kSlots = 4;                  // download reads in flight
+    static constexpr std::size_t kSlotSize = 256 * 1024;
+    static constexpr unsigned kEntries = 32;
+
+    std::unique_ptr<char[]> buffers;  // kSlots * kSlotSize
+    Uring ring;                       // destroyed before the buffers it may still reference
+    bool ready = false;
+    bool fixed = false;               // buffers registered: reads use READ_FIXED
+    bool in_use = false;              // a download reader holds the slots
+
+    char* slot(unsigned i) { return buffers.get() + i * kSlotSize; }
+};
+
+// Check once at startup that io_uring can be used here (kernel 5.6+, not
+// blocked by seccomp or io_uring_disabled).
+bool io_uring_usable() {
+    Uring probe;
+    return probe.init(4) && probe.supports({ IORING_OP_READ_FIXED, IORING_OP_READ, IORING_OP_WRITE });
+}
 
+// The calling thread's ring, set up on first use; nullptr if that failed or a
+// ring call went wrong earlier on this thread.
+UringThreadState* uring_thread_state() {
+    thread_local UringThreadState state;
+    thread_local bool tried = false;
+    if (!tried) {
+        tried = true;
+        if (state.ring.init(UringThreadState::kEntries)) {
+            state.buffers.reset(new char[UringThreadState::kSlots * UringThreadState::kSlotSize]);
+            iovec iov[UringThreadState::kSlots];
+            for (unsigned i = 0; i < UringThreadState::kSlots; ++i) {
+                iov[i].iov_base = state.slot(i);
+                iov[i].iov_len = UringThreadState::kSlotSize;
+            }
+            // Registration pins memory (RLIMIT_MEMLOCK on older kernels); plain reads work without it.
+            state.fixed = state.ring.register_buffers(iov, UringThreadState::kSlots);
+            state.ready = true;
+        }
+    }
+    return state.ready ? &state : nullptr;
+}
 
-    if (canonical_target_dir.string().rfind(canonical_root.string(), 0) != 0) {
-        res.status = 403;
-        res.set_content("Forbidden: Invalid target directory.", "text/plain");
-        return;
+// Read-ahead for one download, used from the worker thread that serves it
+// (httplib calls the content provider there). Chunks are read into the ring's
+// slots in order; while one chunk is being sent, the next ones are on disk.
+class UringFileReader {
+public:
+    UringFileReader(int fd, std::size_t chunk) : fd_(fd), chunk_(std::min(chunk, UringThreadState::kSlotSize)) {}
+    UringFileReader(const UringFileReader&) = delete;
+    UringFileReader& operator=(const UringFileReader&) = delete;
+    ~UringFileReader() { detach(); }
+
+    // Data for [offset, offset + want) out of the `length` bytes the response
+    // still needs. nullptr means "use pread": the ring is unavailable or busy,
+    // or the read failed. Call release() once the data has been sent.
+    const char* acquire(std::uint64_t offset, std::size_t length, std::size_t want, std::size_t& got) {
+        if (failed_ || !attach()) return nullptr;
+        if (count_ == 0 || slots_[head_].offset != offset) {
+            if (!drain()) return fail();
+            head_ = 0;
+            count_ = 0;
+            next_ = offset;
+            end_ = offset + length;
+            if (!fill()) return fail();
+        }
+        Slot& s = slots_[head_];
+        while (s.in_flight) {
+            if (!reap(true)) return fail();
+        }
+        if (s.result <= 0) return fail();
+        got = std::min(static_cast<std::size_t>(s.result), want);
+        return st_->slot(head_);
     }
 
-    fs::path fullPath = canonical_target_dir / fs::u8path(safeFilename);
+    // Recycle the chunk returned by acquire() for the next read ahead.
+    void release() {
+        if (failed_ || count_ == 0) return;
+        head_ = (head_ + 1) % UringThreadState::kSlots;
+        --count_;
+        if (!fill()) fail();
+    }
 
-    // Check for file overwrite.
-    if (fs::exists(fullPath)) {
-        res.status = 409; // Conflict
-        res.set_content("File with this name already exists", "text/plain");
-        return;
+private:
+    struct Slot {
+        std::uint64_t offset = 0;
+        unsigned length = 0;
+        int result = 0;
+        bool in_flight = false;
+    };
+
+    bool attach() {
+        if (st_) return true;
+        UringThreadState* st = uring_thread_state();
+        if (!st || st->in_use) return false;
+        st->in_use = true;
+        st_ = st;
+        return true;
     }
 
-    if (is_chunked_upload) {
-        static std::mutex chunk_write_mutex;
+    void detach() {
+        if (!st_) return;
+        if (drain()) st_->in_use = false;
+        else st_->ready = false; // reads may still target the slots: retire this ring
+        st_ = nullptr;
+    }
 
-        // Write chunks to a temporary file and rename on completion.
-        fs::path partPath = fullPath;
-        partPath += "." + upload_id + ".part";
+    const char* fail() {
+        failed_ = true;
+        g_io_fallbacks.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
 
-        // Ensure parent directories exist (same safety check as the non-chunked path).
-        if (fullPath.parent_path().string().rfind(canonical_root.string(), 0) != 0) {
-            res.status = 403;
-            res.set_content("Forbidden: Cannot create directory in this location.", "text/plain");
-            return;
+    // Queue reads for every free slot and submit them together.
+    bool fill() {
+        bool queued = false;
+        while (count_ < UringThreadState::kSlots && next_ < end_) {
+            io_uring_sqe* sqe = st_->ring.get_sqe();
+            if (!sqe) break;
+            const unsigned index = (head_ + count_) % UringThreadState::kSlots;
+            Slot& s = slots_[index];
+            s.offset = next_;
+            s.length = static_cast<unsigned>(std::min<std::uint64_t>(chunk_, end_ - next_));
+            s.result = 0;
+            s.in_flight = true;
+            sqe->opcode = st_->fixed ? IORING_OP_READ_FIXED : IORING_OP_READ;
+            sqe->fd = fd_;
+            sqe->addr = reinterpret_cast<std::uint64_t>(st_->slot(index));
+            sqe->len = s.length;
+            sqe->off = s.offset;
+            if (st_->fixed) sqe->buf_index = static_cast<std::uint16_t>(index);
+            sqe->user_data = index;
+            next_ += s.length;
+            ++count_;
+            queued = true;
         }
-        fs::create_directories(fullPath.parent_path());
+        return !queued || st_->ring.enter(0);
+    }
 
-        {
-            std::lock_guard<std::mutex> lock(chunk_write_mutex);
+    bool reap(bool wait) {
+        io_uring_cqe cqe;
+        if (wait ? !st_->ring.wait(cqe) : !st_->ring.pop(cqe)) return !wait;
+        do {
+            Slot& s = slots_[cqe.user_data % UringThreadState::kSlots];
+            s.result = cqe.res;
+            s.in_flight = false;
+        } while (st_->ring.pop(cqe));
+        return true;
+    }
 
-            // Enforce in-order chunks: current part file size must match declared offset.
-            std::error_code ec;
-            const bool part_exists = fs::exists(partPath, ec);
-            const std::uintmax_t current_size = part_exists ? fs::file_size(partPath, ec) : 0;
-            if (ec) {
-                res.status = 500;
-                res.set_content("Failed to query upload state", "text/plain");
-                return;
+    bool drain() {
+        for (const Slot& s : slots_) {
+            while (s.in_flight) {
+                if (!reap(true)) return false;
             }
+        }
+        return true;
+    }
 
-            if (chunk_index == 0) {
-                if (offset != 0) {
-                    res.status = 400;
-                    res.set_content("Invalid offset for first chunk", "text/plain");
-                    return;
-                }
-            }
-            else {
-                if (!part_exists) {
-                    res.status = 409;
-                    res.set_content("Missing initial chunk", "text/plain");
-                    return;
-                }
+    int fd_;
+    std::size_t chunk_;
+    UringThreadState* st_ = nullptr;
+    Slot slots_[UringThreadState::kSlots];
+    unsigned head_ = 0;       // slot with the oldest chunk
+    unsigned count_ = 0;      // slots holding consecutive chunks from head_
+    std::uint64_t next_ = 0;  // file offset of the next chunk to queue
+    std::uint64_t end_ = 0;
+    bool failed_ = false;
+};
+
+// Write `n` bytes at `offset` as 1 MB ring writes, submitted in batches and
+// awaited together. False if the ring could not do it; the caller then redoes
+// the whole range with pwrite (same bytes at the same offsets).
+bool uring_write(int fd, const char* data, std::size_t n, std::uint64_t offset) {
+    UringThreadState* st = uring_thread_state();
+    if (!st) return false;
+    constexpr std::size_t piece = 1 << 20;
+    std::size_t done = 0;
+    while (done < n) {
+        std::size_t lengths[UringThreadState::kEntries];
+        unsigned queued = 0;
+        while (done < n && queued < UringThreadState::kEntries) {
+            io_uring_sqe* sqe = st->ring.get_sqe();
+            if (!sqe) break;
+            const std::size_t len = std::min(piece, n - done);
+            sqe->opcode = IORING_OP_WRITE;
+            sqe->fd = fd;
+            sqe->addr = reinterpret_cast<std::uint64_t>(data + done);
+            sqe->len = static_cast<unsigned>(len);
+            sqe->off = offset + done;
+            sqe->user_data = queued;
+            lengths[queued++] = len;
+            done += len;
+        }
+        if (queued == 0 || !st->ring.enter(0)) {
+            st->ready = false;
+            return false;
+        }
+        bool ok = true;
+        for (unsigned completed = 0; completed < queued; ++completed) {
+            io_uring_cqe cqe;
+            if (!st->ring.wait(cqe)) {
+                st->ready = false; // writes may still read `data`; do not touch this ring again
+                return false;
             }
+            if (cqe.user_data >= queued || cqe.res < 0 || static_cast<std::size_t>(cqe.res) != lengths[cqe.user_data]) ok = false;
+        }
+        if (!ok) return false;
+    }
+    return true;
+}
+#endif // ARTWEB_IO_URING
+
+// --- Page cache policy for large transfers ---
+// Large downloads are read sequentially with a deep readahead window; large
+// uploads get their space reserved up front and are dropped from the page
+// cache behind the write cursor (or bypass it with O_DIRECT), so multi-GB
+// transfers don't evict the small hot files of listings and static pages.
+
+std::uint64_t g_readahead = 8ull << 20;         // --readahead MB, ahead of large downloads (0 = kernel default)
+std::uint64_t g_direct_io_threshold = 0;        // --direct-io MB: O_DIRECT upload writes from this size on (0 = off)
+
+// Keeps the kernel reading g_readahead bytes ahead of one large download.
+class ReadaheadWindow {
+public:
+    ReadaheadWindow(int fd, std::uint64_t size) : fd_(fd), size_(size) {
+        active_ = fd >= 0 && size >= g_bulk_threshold;
+#ifdef POSIX_FADV_SEQUENTIAL
+        if (active_) posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    }
 
-            if (static_cast<std::uintmax_t>(offset) != current_size) {
-                res.status = 409;
-                res.set_content("Unexpected chunk offset", "text/plain");
-                return;
-            }
+    // The download has reached `offset`: top the window up once half of it is consumed.
+    void advance(std::uint64_t offset) {
+#ifdef POSIX_FADV_WILLNEED
+        if (!active_ || g_readahead == 0) return;
+        const bool inside = offset >= from_ && offset <= until_;
+        if (inside && until_ - offset > g_readahead / 2) return;
+        const std::uint64_t start = inside ? until_ : offset;
+        const std::uint64_t end = std::min(size_, offset + g_readahead);
+        if (end > start) posix_fadvise(fd_, static_cast<off_t>(start), static_cast<off_t>(end - start), POSIX_FADV_WILLNEED);
+        if (!inside) from_ = offset;
+        until_ = std::max(end, inside ? until_ : end);
+#endif
+    }
 
-            std::ios::openmode mode = std::ios::binary;
-            mode |= (chunk_index == 0) ? std::ios::trunc : std::ios::app;
+private:
+    int fd_;
+    std::uint64_t size_;
+    bool active_ = false;
+    std::uint64_t from_ = 0, until_ = 0;   // range already requested
+};
+
+// Destination file of an upload. POSIX writes at explicit offsets through the
+// I/O engine and the page cache policy; Windows keeps the stream (upload
+// writes are sequential anyway).
+class UploadFile {
+public:
+    UploadFile() = default;
+    UploadFile(const UploadFile&) = delete;
+    UploadFile& operator=(const UploadFile&) = delete;
+    ~UploadFile() { close(); }
+
+    // Open for writing, creating the file; `truncate` starts it over.
+    bool open(const fs::path& path, bool truncate) {
+#ifndef _WIN32
+        path_ = path;
+        fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC | (truncate ? O_TRUNC : 0), 0666);
+        return fd_ >= 0;
+#else
+        out_.open(path, std::ios::binary | (truncate ? std::ios::trunc : std::ios::app));
+        return static_cast<bool>(out_);
+#endif
+    }
 
-            std::ofstream ofs(partPath, mode);
-            if (!ofs) {
-                res.status = 500;
-                res.set_content("Failed to save chunk", "text/plain");
-                return;
+    // Apply the page cache policy for a file that will be `total` bytes long,
+    // with writes starting at `offset`. Every step is best effort.
+    void prepare(std::uint64_t offset, std::uint64_t total) {
+#ifndef _WIN32
+#ifdef __linux__
+        // Reserve the rest of the file now (less fragmentation, early ENOSPC)
+        // without changing its size, which chunked uploads check against the offset.
+        if (total > offset && fallocate(fd_, FALLOC_FL_KEEP_SIZE, static_cast<off_t>(offset), static_cast<off_t>(total - offset)) == 0) {
+            reserved_end_ = total;
+        }
+#endif
+#ifdef O_DIRECT
+        if (g_direct_io_threshold && total >= g_direct_io_threshold) {
+            direct_fd_ = ::open(path_.c_str(), O_WRONLY | O_CLOEXEC | O_DIRECT);
+            if (direct_fd_ >= 0) {
+                void* p = nullptr;
+                if (posix_memalign(&p, kDirectAlign, kDirectBuffer) == 0) bounce_.reset(static_cast<char*>(p));
+                else close_direct();
             }
+        }
+#endif
+        drop_behind_ = direct_fd_ < 0 && total >= g_bulk_threshold;
+#else
+        (void)offset;
+        (void)total;
+#endif
+    }
 
-            ofs.write(file.content.data(), static_cast<std::streamsize>(file.content.size()));
-            if (!ofs) {
-                res.status = 500;
-                res.set_content("Failed to write chunk", "text/plain");
-                return;
+    bool write_at(const char* data, std::size_t n, std::uint64_t offset) {
+#ifndef _WIN32
+        // Large uploads go out in windows: each one is handed to writeback right
+        // away and dropped from the cache once the next one has been written.
+        const std::size_t window = drop_behind_ ? kDropWindow : std::max<std::size_t>(n, 1);
+        for (std::size_t done = 0; done < n;) {
+            const std::size_t len = std::min(window, n - done);
+            if (!write_range(data + done, len, offset + done)) return false;
+            if (drop_behind_) {
+                start_writeback(offset + done, len);
+                drop_cache(offset + done);
             }
-            ofs.close();
-
-            if (chunk_index + 1 == total_chunks) {
-                // Best-effort sanity check: final size should match declared file size.
-                std::error_code ec2;
-                const auto final_part_size = fs::file_size(partPath, ec2);
-                if (!ec2 && final_part_size != declared_file_size) {
-                    res.status = 500;
-                    res.set_content("Final size mismatch", "text/plain");
-                    return;
-                }
+            done += len;
+        }
+        return true;
+#else
+        out_.write(data, static_cast<std::streamsize>(n));
+        return static_cast<bool>(out_);
+#endif
+    }
 
-                std::error_code ec3;
-                fs::rename(partPath, fullPath, ec3);
-                if (ec3) {
-                    res.status = (fs::exists(fullPath) ? 409 : 500);
-                    res.set_content("Failed to finalize upload", "text/plain");
-                    return;
-                }
-                res.set_content("File uploaded successfully", "text/plain");
-                return;
-            }
+    // Give back space prepare() reserved past the end of the data: the upload
+    // was aborted, or the size hint overstated it (e.g. multipart overhead).
+    void trim() {
+#ifdef __linux__
+        struct stat st;
+        if (fd_ >= 0 && reserved_end_ > 0 && fstat(fd_, &st) == 0 && reserved_end_ > static_cast<std::uint64_t>(st.st_size)) {
+            // Truncating to the current size frees blocks past EOF (punching a
+            // hole there is a no-op on ext4). Best effort, like the reservation.
+            const int r = ftruncate(fd_, st.st_size);
+            (void)r;
         }
+        reserved_end_ = 0;
+#endif
+    }
 
-        res.set_content("Chunk uploaded", "text/plain");
-        return;
+    bool close() {
+#ifndef _WIN32
+        close_direct();
+        if (fd_ < 0) return true;
+        const int r = ::close(fd_);
+        fd_ = -1;
+        return r == 0;
+#else
+        if (!out_.is_open()) return true;
+        out_.close();
+        return !out_.fail();
+#endif
     }
 
-    std::ofstream ofs(fullPath, std::ios::binary);
-    if (!ofs) {
-        // Before creating the directory, ensure the parent path is still safe.
-        // This is a defense-in-depth check.
-        if (fullPath.parent_path().string().rfind(canonical_root.string(), 0) != 0) {
-            res.status = 403;
-            res.set_content("Forbidden: Cannot create directory in this location.", "text/plain");
-            return;
+private:
+#ifndef _WIN32
+    static constexpr std::size_t kDropWindow = 8 * 1024 * 1024;
+    static constexpr std::size_t kDirectAlign = 4096;        // covers 512-byte and 4K logical blocks
+    static constexpr std::size_t kDirectBuffer = 1024 * 1024;
+
+    struct FreeDeleter { void operator()(char* p) const { std::free(p); } };
+
+    bool write_buffered(const char* data, std::size_t n, std::uint64_t offset) {
+#ifdef ARTWEB_IO_URING
+        if (g_io_engine == IoEngine::Uring) {
+            if (uring_write(fd_, data, n, offset)) return true;
+            g_io_fallbacks.fetch_add(1, std::memory_order_relaxed);
         }
-        // Attempt to create the directory if it doesn't exist.
-        fs::create_directories(fullPath.parent_path());
-        ofs.open(fullPath, std::ios::binary); // Try again
-        if (!ofs) {
-            res.status = 500;
-            res.set_content("Failed to save file", "text/plain");
-            return;
+#endif
+        return pwrite_full(fd_, data, n, offset);
+    }
+
+    // O_DIRECT for the aligned part (copied through an aligned buffer), the
+    // unaligned tail through the cache. Falls back to buffered writes if the
+    // filesystem refuses direct I/O.
+    bool write_range(const char* data, std::size_t n, std::uint64_t offset) {
+        if (direct_fd_ < 0 || offset % kDirectAlign != 0) return write_buffered(data, n, offset);
+        const std::size_t aligned = n - n % kDirectAlign;
+        for (std::size_t done = 0; done < aligned;) {
+            const std::size_t len = std::min(kDirectBuffer, aligned - done);
+            std::memcpy(bounce_.get(), data + done, len);
+            if (!pwrite_full(direct_fd_, bounce_.get(), len, offset + done)) {
+                close_direct();
+                return write_buffered(data + done, n - done, offset + done);
+            }
+            done += len;
         }
+        return aligned == n || write_buffered(data + aligned, n - aligned, offset + aligned);
     }
 
-    ofs.write(file.content.data(), file.content.size());
-    ofs.close();
-    res.set_content("File uploaded successfully", "text/plain");
-}
+    void start_writeback(std::uint64_t offset, std::size_t n) {
+#ifdef __linux__
+        sync_file_range(fd_, static_cast<off_t>(offset), static_cast<off_t>(n), SYNC_FILE_RANGE_WRITE);
+#else
+        (void)offset;
+        (void)n;
+#endif
+    }
 
-// Unified Browse/Download Handler (for non-root paths)
-void browse_handler(const httplib::Request& req, httplib::Response& res) {
-    if (!authenticate(req, res)) return;
+    // Drop [dropped_, upto) from the page cache; pages must be clean first.
+    void drop_cache(std::uint64_t upto) {
+        if (upto <= dropped_) return;
+        const off_t from = static_cast<off_t>(dropped_), len = static_cast<off_t>(upto - dropped_);
+#ifdef __linux__
+        sync_file_range(fd_, from, len, SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+#endif
+#ifdef POSIX_FADV_DONTNEED
+        posix_fadvise(fd_, from, len, POSIX_FADV_DONTNEED);
+#else
+        (void)from;
+        (void)len;
+#endif
+        dropped_ = upto;
+    }
 
-    std::string dir = req.matches[1];
-    dir = url_decode(dir);
-    if (dir.empty()) dir = ".";
+    void close_direct() {
+        if (direct_fd_ >= 0) ::close(direct_fd_);
+        direct_fd_ = -1;
+        bounce_.reset();
+    }
 
-    fs::path reqPath(dir);
-    if (reqPath.is_absolute() || dir.find("..") != std::string::npos) {
-        res.status = 400;
-        res.set_content("Invalid path", "text/plain");
-        return;
+    fs::path path_;
+    int fd_ = -1;
+    int direct_fd_ = -1;
+    std::unique_ptr<char, FreeDeleter> bounce_;
+    bool drop_behind_ = false;
+    std::uint64_t dropped_ = 0;     // cache already dropped below this offset
+    std::uint64_t reserved_end_ = 0; // end of the fallocate()d range, 0 if none
+#else
+    std::ofstream out_;
+#endif
+};
+
+// --- Hashing whole files (GET /path?hash=ALGO) ---
+// Files are read in 4 MB segments. CRC-32C and BLAKE3 hash the segments on up
+// to hardware_concurrency threads (shared by all requests) and join them
+// afterwards; SHA-256 reads sequentially behind a readahead window.
+
+constexpr std::size_t DIGEST_SEGMENT = 4u << 20;   // = 2^12 BLAKE3 chunks
+static_assert(DIGEST_SEGMENT % blake3::CHUNK_LEN == 0, "segments must be whole BLAKE3 chunks");
+
+// Reads a resolved file at explicit offsets; one per hashing thread.
+class SegmentReader {
+public:
+    explicit SegmentReader(const ResolvedFile& file) : file_(file) {
+#ifdef _WIN32
+        in_.open(file.path, std::ios::binary);
+#endif
     }
-    fs::path fs_path = fs::u8path(dir);
-    if (!fs::exists(fs_path)) {
-        res.status = 404;
-        res.set_content("Not found", "text/plain");
-        return;
+
+    std::size_t read(char* buf, std::size_t n, std::uint64_t offset) {
+#ifndef _WIN32
+        return pread_full(file_.fd(), buf, n, offset);
+#else
+        in_.clear();
+        in_.seekg(static_cast<std::streamoff>(offset));
+        in_.read(buf, static_cast<std::streamsize>(n));
+        return static_cast<std::size_t>(in_.gcount());
+#endif
     }
-    if (fs::is_regular_file(fs_path)) {
-        std::ifstream ifs(fs_path, std::ios::binary);
-        if (!ifs) {
-            res.status = 500;
-            res.set_content("Error reading file", "text/plain");
-            return;
+
+private:
+    const ResolvedFile& file_;
+#ifdef _WIN32
+    std::ifstream in_;
+#endif
+};
+
+// Extra hashing threads currently running, across all requests.
+std::mutex g_hash_threads_mutex;
+unsigned g_hash_threads_busy = 0;
+
+unsigned claim_hash_threads(unsigned want) {
+    const unsigned limit = std::max(1u, std::thread::hardware_concurrency());
+    std::lock_guard<std::mutex> lock(g_hash_threads_mutex);
+    const unsigned granted = std::min(want, limit > g_hash_threads_busy ? limit - g_hash_threads_busy : 0u);
+    g_hash_threads_busy += granted;
+    return granted;
+}
+
+void release_hash_threads(unsigned n) {
+    std::lock_guard<std::mutex> lock(g_hash_threads_mutex);
+    g_hash_threads_busy -= n;
+}
+
+// Run job(i) for i in [0, count) on the calling thread plus whatever helpers
+// are free; false if any job failed.
+bool for_each_segment(std::size_t count, const std::function<bool(std::size_t, std::vector<char>&)>& job) {
+    std::atomic<std::size_t> next{ 0 };
+    std::atomic<bool> ok{ true };
+    auto worker = [&] {
+        std::vector<char> buf(DIGEST_SEGMENT);
+        for (std::size_t i; ok.load(std::memory_order_relaxed) && (i = next.fetch_add(1)) < count;) {
+            if (!job(i, buf)) ok = false;
         }
-        std::ostringstream oss;
-        oss << ifs.rdbuf();
+    };
+    const unsigned helpers = count > 1 ? claim_hash_threads(static_cast<unsigned>(std::min<std::size_t>(count - 1, 64))) : 0;
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < helpers; ++t) threads.emplace_back(worker);
+    worker();
+    for (auto& t : threads) t.join();
+    release_hash_threads(helpers);
+    return ok;
+}
 
-        const auto mime = get_mime_type(fs_path.string());
-        const auto content_type = add_charset_if_text(mime);
+bool hash_sha256(const ResolvedFile& file, std::string& raw) {
+    SegmentReader reader(file);
+    ReadaheadWindow readahead(file.fd(), file.size);
+    std::vector<char> buf(1024 * 1024);
+    Sha256 hash;
+    for (std::uint64_t offset = 0; offset < file.size;) {
+        readahead.advance(offset);
+        const std::size_t want = static_cast<std::size_t>(std::min<std::uint64_t>(buf.size(), file.size - offset));
+        const std::size_t got = reader.read(buf.data(), want, offset);
+        if (got != want) return false;
+        hash.update(buf.data(), got);
+        offset += got;
+    }
+    raw = hash.digest();
+    return true;
+}
 
-        res.status = 200;
-        res.set_content(oss.str(), content_type.c_str());
+bool hash_crc32c(const ResolvedFile& file, std::string& raw) {
+    const std::size_t segments = static_cast<std::size_t>((file.size + DIGEST_SEGMENT - 1) / DIGEST_SEGMENT);
+    std::vector<std::uint32_t> crcs(segments);
+    const bool ok = for_each_segment(segments, [&](std::size_t i, std::vector<char>& buf) {
+        const std::uint64_t offset = static_cast<std::uint64_t>(i) * DIGEST_SEGMENT;
+        const std::size_t want = static_cast<std::size_t>(std::min<std::uint64_t>(DIGEST_SEGMENT, file.size - offset));
+        if (SegmentReader(file).read(buf.data(), want, offset) != want) return false;
+        crcs[i] = crc32c_update(0, buf.data(), want);
+        return true;
+    });
+    if (!ok) return false;
+    std::uint32_t crc = 0;
+    for (std::size_t i = 0; i < segments; ++i) {
+        const std::uint64_t len = std::min<std::uint64_t>(DIGEST_SEGMENT, file.size - static_cast<std::uint64_t>(i) * DIGEST_SEGMENT);
+        crc = crc32c_combine(crc, crcs[i], len);
+    }
+    raw.assign(4, '\0');
+    for (int b = 0; b < 4; ++b) raw[b] = static_cast<char>(crc >> (24 - 8 * b)); // big-endian: the hex reads as the usual 32-bit value
+    return true;
+}
 
-        // Only force download for unknown/binary types
-        const bool likely_binary =
-            (mime == "application/octet-stream") ||
-            (mime.rfind("application/", 0) == 0 &&
-                mime != "application/json" &&
-                mime != "application/javascript" &&
-                mime != "application/xml" &&
-                mime != "application/pdf");
+bool hash_blake3(const ResolvedFile& file, std::string& raw) {
+    // Every segment but the last is a complete, non-root subtree: hash those in
+    // parallel, then feed the last one through the hasher so it can finish the root.
+    const std::size_t segments = file.size == 0 ? 1 : static_cast<std::size_t>((file.size + DIGEST_SEGMENT - 1) / DIGEST_SEGMENT);
+    const std::size_t parallel = segments - 1;
+    constexpr std::size_t chunks_per_segment = DIGEST_SEGMENT / blake3::CHUNK_LEN;
+    std::vector<blake3::Cv> cvs(parallel);
+    const bool ok = for_each_segment(parallel, [&](std::size_t i, std::vector<char>& buf) {
+        const std::uint64_t offset = static_cast<std::uint64_t>(i) * DIGEST_SEGMENT;
+        if (SegmentReader(file).read(buf.data(), DIGEST_SEGMENT, offset) != DIGEST_SEGMENT) return false;
+        cvs[i] = blake3::subtree_cv(buf.data(), chunks_per_segment, static_cast<std::uint64_t>(i) * chunks_per_segment);
+        return true;
+    });
+    if (!ok) return false;
+
+    blake3::Hasher hasher;
+    for (std::size_t i = 0; i < parallel; ++i) hasher.push_subtree(cvs[i], i + 1);
+    hasher.set_chunk_counter(static_cast<std::uint64_t>(parallel) * chunks_per_segment);
+    const std::uint64_t offset = static_cast<std::uint64_t>(parallel) * DIGEST_SEGMENT;
+    const std::size_t want = static_cast<std::size_t>(file.size - offset);
+    std::vector<char> buf(want);
+    if (want > 0 && SegmentReader(file).read(buf.data(), want, offset) != want) return false;
+    hasher.update(buf.data(), want);
+    raw = hasher.digest();
+    return true;
+}
 
-        if (likely_binary) {
-            res.set_header("Content-Disposition",
-                "attachment; filename=\"" + fs_path.filename().u8string() + "\"");
-        }
-        return;
+// Raw digest of a resolved regular file, from the cache when its identity is known.
+bool file_digest(const ResolvedFile& file, DigestAlgo algo, std::string& raw) {
+    const std::string identity = file_identity(file);
+    if (g_digests.lookup(identity, algo, raw)) return true;
+    bool ok = false;
+    switch (algo) {
+    case DigestAlgo::Sha256: ok = hash_sha256(file, raw); break;
+    case DigestAlgo::Blake3: ok = hash_blake3(file, raw); break;
+    case DigestAlgo::Crc32c: ok = hash_crc32c(file, raw); break;
     }
+    if (!ok) return false;
+    g_digests.bytes_hashed.fetch_add(file.size, std::memory_order_relaxed);
+    g_digests.store(identity, algo, raw);
+    return true;
+}
 
-    // --- HTML directory listing ---
-    std::stringstream html;
-    html << "<!DOCTYPE html>\n"
-        << "<html lang='en'>\n"
+// GET /path?hash=sha256|blake3|crc32c: answer with "<hex>  <name>" (sha256sum
+// format) instead of the content. Returns false when the query has no hash.
+bool answer_hash_query(const httplib::Request& req, httplib::Response& res,
+    const ResolvedFile& file, const std::string& name) {
+    if (!req.has_param("hash")) return false;
+    DigestAlgo algo;
+    if (!parse_digest_algo(req.get_param_value("hash"), algo)) {
+        res.status = 400;
+        res.set_content("Invalid hash (expected sha256, blake3 or crc32c)", "text/plain");
+        return true;
+    }
+    std::string raw;
+    if (!file_digest(file, algo, raw)) {
+        res.status = 500;
+        res.set_content("Could not read file", "text/plain");
+        return true;
+    }
+    if (algo == DigestAlgo::Sha256) res.set_header("Repr-Digest", repr_digest_sha256(raw));
+    res.set_header("Cache-Control", "no-cache");
+    res.set_content(to_hex(raw) + "  " + name + "\n", "text/plain; charset=utf-8");
+    return true;
+}
+
+// Stream a resolved regular file in chunks (ranges are cut by httplib), pacing
+// each chunk through the download limits. The provider keeps the descriptor alive.
+void stream_resolved_file(const httplib::Request& req, httplib::Response& res,
+    const ResolvedFile& file, std::string_view content_type) {
+    const bool throttled = g_outbound.enabled() || g_limit_rate_conn != 0;
+    const std::size_t chunk = throttled ? 64 * 1024 : 256 * 1024;
+    auto conn_bucket = g_limit_rate_conn ? std::make_shared<TokenBucket>(g_limit_rate_conn) : nullptr;
+    const std::string ip = req.remote_addr;
+#ifdef _WIN32
+    auto in = std::make_shared<std::ifstream>(file.path, std::ios::binary);
+#endif
+    auto readahead = std::make_shared<ReadaheadWindow>(file.fd(), file.size);
+#ifdef ARTWEB_IO_URING
+    auto ring = g_io_engine == IoEngine::Uring ? std::make_shared<UringFileReader>(file.fd(), chunk) : nullptr;
+#endif
+
+    // Status left unset: httplib answers 200, or 206 for a Range request.
+    res.set_content_provider(static_cast<size_t>(file.size), std::string(content_type),
+        [=](size_t offset, size_t length, httplib::DataSink& sink) {
+            const std::size_t want = std::min(length, chunk);
+            if (conn_bucket) {
+                const double wait = conn_bucket->take(want);
+                if (wait > 0) std::this_thread::sleep_for(std::chrono::duration<double>(wait));
+            }
+            if (g_outbound.enabled()) g_outbound.acquire(ip, want);
+            readahead->advance(offset);
+
+#ifdef ARTWEB_IO_URING
+            if (ring) {
+                std::size_t ready = 0;
+                if (const char* data = ring->acquire(offset, length, want, ready)) {
+                    const bool ok = sink.write(data, ready);
+                    ring->release();
+                    return ok;
+                }
+            }
+#endif
+            thread_local std::vector<char> buf;
+            if (buf.size() < want) buf.resize(want);
+#ifndef _WIN32
+            const std::size_t got = pread_full(file.fd(), buf.data(), want, offset);
+#else
+            in->clear();
+            in->seekg(static_cast<std::streamoff>(offset));
+            in->read(buf.data(), static_cast<std::streamsize>(want));
+            const std::size_t got = static_cast<std::size_t>(in->gcount());
+#endif
+            if (got == 0) return false; // file shrank or read error: abort the response
+            return sink.write(buf.data(), got);
+        });
+}
+
+// --- Tail and follow (GET /file?tail=N, ?follow=1) ---
+// tail=N answers with the last N lines, found by scanning blocks backwards from
+// the end. follow=1 keeps the response open and streams what is appended, as
+// chunked output: inotify wakes the follower on Linux, elsewhere it polls.
+// Truncation restarts at offset 0, and a file replaced under the same name
+// (log rotation) is reopened. Followers are capped (--max-followers) and
+// leave the interactive worker lane while they wait.
+
+std::size_t g_max_followers = 16;            // --max-followers N (0 disables follow)
+std::atomic<std::size_t> g_followers{ 0 };
+constexpr std::size_t TAIL_BLOCK = 64 * 1024;
+
+// Offset at which the last `lines` lines of the first `size` bytes start.
+std::uint64_t tail_offset(const ResolvedFile& file, std::uint64_t size, std::uint64_t lines) {
+    if (lines == 0) return size;
+    SegmentReader reader(file);
+    std::vector<char> buf(TAIL_BLOCK);
+    std::uint64_t end = size;
+    bool skip_final = true; // a newline at EOF ends the last line rather than starting one
+    while (end > 0) {
+        const std::size_t n = static_cast<std::size_t>(std::min<std::uint64_t>(TAIL_BLOCK, end));
+        const std::uint64_t start = end - n;
+        if (reader.read(buf.data(), n, start) != n) return start;
+        std::size_t limit = n;
+        if (skip_final) {
+            if (buf[n - 1] == '\n') --limit;
+            skip_final = false;
+        }
+        while (limit > 0) {
+            const char* hit = last_newline(buf.data(), limit);
+            if (!hit) break;
+            const std::size_t at = static_cast<std::size_t>(hit - buf.data());
+            if (--lines == 0) return start + at + 1;
+            limit = at;
+        }
+        end = start;
+    }
+    return 0;
+}
+
+// State of one follower, kept alive by its content provider.
+class FileFollower {
+public:
+    FileFollower(const ResolvedFile& file, std::string rel, std::uint64_t offset)
+        : file_(file), rel_(std::move(rel)), offset_(offset), buf_(TAIL_BLOCK) {
+        watch();
+    }
+    FileFollower(const FileFollower&) = delete;
+    FileFollower& operator=(const FileFollower&) = delete;
+    ~FileFollower() {
+#ifdef __linux__
+        if (inotify_fd_ >= 0) ::close(inotify_fd_);
+#endif
+        g_followers.fetch_sub(1, std::memory_order_relaxed); // slot taken by answer_tail_query
+    }
+
+    // One step of the chunked response: send the next appended bytes, or wait
+    // (at most a second) for the file to change. False ends the response.
+    bool step(httplib::DataSink& sink, const std::string& ip) {
+        const std::uint64_t size = current_size();
+        if (size < offset_) offset_ = 0; // truncated in place (copytruncate)
+        if (size > offset_) {
+            const std::size_t want = static_cast<std::size_t>(std::min<std::uint64_t>(buf_.size(), size - offset_));
+            const std::size_t got = SegmentReader(file_).read(buf_.data(), want, offset_);
+            if (got == 0) return wait(sink);
+            if (g_outbound.enabled()) g_outbound.acquire(ip, got);
+            offset_ += got;
+            return sink.write(buf_.data(), got);
+        }
+        if (reopen_if_replaced()) return true;
+        return wait(sink);
+    }
+
+private:
+    std::uint64_t current_size() const {
+#ifndef _WIN32
+        struct stat st;
+        return fstat(file_.fd(), &st) == 0 ? static_cast<std::uint64_t>(st.st_size) : 0;
+#else
+        std::error_code ec;
+        const auto size = fs::file_size(file_.path, ec);
+        return ec ? 0 : size;
+#endif
+    }
+
+    // Caught up: if the name now refers to another file (rotated), continue with that one.
+    bool reopen_if_replaced() {
+        if (!replaced_ && std::chrono::steady_clock::now() < next_check_) return false;
+        next_check_ = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+        replaced_ = false;
+        ResolvedFile latest;
+        if (resolve_beneath(g_root, rel_, latest) != ResolveStatus::Ok || !latest.is_regular) return false;
+#ifndef _WIN32
+        if (latest.ino == file_.ino && latest.dev == file_.dev) return false;
+#else
+        return false; // open files cannot be renamed on Windows
+#endif
+        file_ = latest;
+        offset_ = 0;
+        watch();
+        return true;
+    }
+
+    void watch() {
+#ifdef __linux__
+        if (inotify_fd_ < 0) inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (inotify_fd_ < 0) return;
+        if (wd_ >= 0) inotify_rm_watch(inotify_fd_, wd_);
+        wd_ = inotify_add_watch(inotify_fd_, file_.path.c_str(), IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE | IN_MOVE_SELF | IN_DELETE_SELF);
+#endif
+    }
+
+    bool wait(httplib::DataSink& sink) {
+        if (!sink.is_writable()) return false; // client went away while idle
+#ifdef __linux__
+        if (inotify_fd_ >= 0 && wd_ >= 0) {
+            pollfd pfd{ inotify_fd_, POLLIN, 0 };
+            if (poll(&pfd, 1, 1000) > 0) {
+                alignas(inotify_event) char events[4096];
+                ssize_t n;
+                while ((n = read(inotify_fd_, events, sizeof(events))) > 0) {
+                    for (ssize_t i = 0; i < n;) {
+                        const auto* ev = reinterpret_cast<const inotify_event*>(events + i);
+                        if (ev->mask & (IN_MOVE_SELF | IN_DELETE_SELF | IN_IGNORED)) replaced_ = true;
+                        i += static_cast<ssize_t>(sizeof(inotify_event) + ev->len);
+                    }
+                }
+            }
+            return true;
+        }
+#endif
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        return true;
+    }
+
+    ResolvedFile file_;
+    std::string rel_;
+    std::uint64_t offset_;
+    std::vector<char> buf_;            // one chunk: memory per follower stays bounded
+    bool replaced_ = false;
+    std::chrono::steady_clock::time_point next_check_{};
+#ifdef __linux__
+    int inotify_fd_ = -1;
+    int wd_ = -1;
+#endif
+};
+
+// GET /file?tail=N and/or ?follow=1 on a resolved regular file; false when the
+// query asks for neither.
+bool answer_tail_query(const httplib::Request& req, httplib::Response& res, const ResolvedFile& file, const std::string& rel) {
+    const bool follow = req.get_param_value("follow") == "1";
+    if (!req.has_param("tail") && !follow) return false;
+
+    std::uint64_t lines = 0;
+    if (req.has_param("tail")) {
+        const std::string value = req.get_param_value("tail");
+        if (value.empty() || value.find_first_not_of("0123456789") != std::string::npos || value.size() > 18) {
+            res.status = 400;
+            res.set_content("Invalid tail (expected a line count)", "text/plain");
+            return true;
+        }
+        lines = std::stoull(value);
+    }
+    const std::uint64_t size = file.size;
+    const std::uint64_t start = req.has_param("tail") ? tail_offset(file, size, lines) : size;
+    const std::string ip = req.remote_addr;
+    res.set_header("Cache-Control", "no-cache");
+    res.set_header("X-Content-Type-Options", "nosniff");
+
+    if (!follow) {
+        auto keep = std::make_shared<ResolvedFile>(file); // the reader refers to it
+        auto reader = std::make_shared<SegmentReader>(*keep);
+        res.set_content_provider(static_cast<size_t>(size - start), "text/plain; charset=utf-8",
+            [reader, keep, start, ip](size_t offset, size_t length, httplib::DataSink& sink) {
+                std::vector<char> buf(std::min<std::size_t>(length, TAIL_BLOCK));
+                const std::size_t got = reader->read(buf.data(), buf.size(), start + offset);
+                if (got == 0) return false;
+                if (g_outbound.enabled()) g_outbound.acquire(ip, got);
+                return sink.write(buf.data(), got);
+            });
+        return true;
+    }
+
+    if (g_followers.fetch_add(1) >= g_max_followers) {
+        g_followers.fetch_sub(1);
+        res.status = 503;
+        res.set_header("Retry-After", "10");
+        res.set_content(g_max_followers == 0 ? "Follow is disabled" : "Too many followers, retry later", "text/plain");
+        return true;
+    }
+    auto follower = std::make_shared<FileFollower>(file, rel, start);
+    res.set_chunked_content_provider("text/plain; charset=utf-8",
+        [follower, ip](size_t, httplib::DataSink& sink) { return follower->step(sink, ip); });
+    return true;
+}
+
+// --- Line index (GET /file?lines=A-B) ---
+// A sparse index of line start offsets (one mark every LINE_INDEX_STRIDE
+// lines) lets ?lines=A-B seek close to line A and scan at most one stride
+// forward. Indexes are built on first use by a background thread, which
+// extends them as the file grows. A request never waits for the build: it
+// scans forward from the last mark available. With --line-index DIR they are
+// saved there and reloaded after a restart. A checksum of the bytes just
+// before the indexed end detects files rewritten in place.
+
+constexpr std::uint64_t LINE_INDEX_STRIDE = 4096;    // lines per mark
+constexpr std::size_t LINE_INDEX_CHECK = 4096;       // bytes covered by the rewrite check
+constexpr std::size_t LINE_INDEX_MAX_FILES = 256;
+
+struct LineIndexData {
+    std::uint64_t scanned = 0;            // bytes indexed
+    std::uint64_t lines = 0;              // newlines in [0, scanned)
+    std::uint32_t check = 0;              // crc32c of the LINE_INDEX_CHECK bytes before `scanned`
+    std::vector<std::uint64_t> marks{ 0 }; // marks[i] = offset of line i * STRIDE (0-based)
+};
+
+class LineIndexStore {
+public:
+    struct Entry {
+        std::mutex mutex;
+        LineIndexData data;
+        bool building = false;
+        std::uint64_t generation = 0;   // bumped when the file turns out rewritten
+        std::uint64_t tick = 0;
+    };
+
+    fs::path dir;   // --line-index DIR; empty keeps indexes in memory only
+
+    // Index entry for a file, checked against its current content; queues an
+    // update when the file has grown past the indexed part.
+    std::shared_ptr<Entry> get(const ResolvedFile& file) {
+        const std::string key = key_of(file);
+        std::shared_ptr<Entry> entry;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto& slot = entries_[key];
+            if (!slot) {
+                if (entries_.size() > LINE_INDEX_MAX_FILES) evict_locked(key);
+                slot = std::make_shared<Entry>();
+                load(key, slot->data);
+            }
+            slot->tick = ++tick_;
+            entry = slot;
+        }
+        bool stale = false, grow = false;
+        {
+            std::lock_guard<std::mutex> lock(entry->mutex);
+            stale = entry->data.scanned > file.size || !check_matches(file, entry->data);
+            if (stale) {
+                // Lines are found from the start until a build for the new content is done;
+                // a build still running on the old content discards its result.
+                entry->data = LineIndexData();
+                ++entry->generation;
+            }
+            grow = !entry->building && file.size > entry->data.scanned;
+            if (grow) entry->building = true;
+        }
+        if (grow) enqueue(key, entry, file);
+        return entry;
+    }
+
+    static std::uint32_t tail_check(const ResolvedFile& file, std::uint64_t end) {
+        const std::size_t n = static_cast<std::size_t>(std::min<std::uint64_t>(LINE_INDEX_CHECK, end));
+        std::vector<char> buf(n);
+        if (n > 0 && SegmentReader(file).read(buf.data(), n, end - n) != n) return 0;
+        return crc32c_update(0, buf.data(), n);
+    }
+
+private:
+    struct Job {
+        std::string key;
+        std::shared_ptr<Entry> entry;
+        ResolvedFile file;
+    };
+
+    static std::string key_of(const ResolvedFile& file) {
+#ifndef _WIN32
+        return std::to_string(file.dev) + "-" + std::to_string(file.ino);
+#else
+        return file.path.u8string();
+#endif
+    }
+
+    static bool check_matches(const ResolvedFile& file, const LineIndexData& data) {
+        return data.scanned == 0 || tail_check(file, data.scanned) == data.check;
+    }
+
+    void evict_locked(const std::string& keep) {
+        auto oldest = entries_.end();
+        for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+            if (it->first != keep && it->second && (oldest == entries_.end() || it->second->tick < oldest->second->tick)) oldest = it;
+        }
+        if (oldest != entries_.end()) entries_.erase(oldest);
+    }
+
+    void enqueue(const std::string& key, const std::shared_ptr<Entry>& entry, const ResolvedFile& file) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.push_back(Job{ key, entry, file });
+        if (!worker_started_) {
+            worker_started_ = true;
+            std::thread([this] { run(); }).detach();
+        }
+        jobs_cv_.notify_one();
+    }
+
+    void run() {
+        for (;;) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                jobs_cv_.wait(lock, [this] { return !jobs_.empty(); });
+                job = std::move(jobs_.front());
+                jobs_.pop_front();
+            }
+            build(job);
+        }
+    }
+
+    // Extend the index over what the file holds now, in 4 MB reads.
+    void build(const Job& job) {
+        LineIndexData data;
+        std::uint64_t generation = 0;
+        {
+            std::lock_guard<std::mutex> lock(job.entry->mutex);
+            data = job.entry->data;
+            generation = job.entry->generation;
+        }
+        SegmentReader reader(job.file);
+        // The check covers the last bytes this build indexed, so a file rewritten
+        // meanwhile fails it later. Its starting bytes confirm the part indexed before.
+        std::string tail(static_cast<std::size_t>(std::min<std::uint64_t>(LINE_INDEX_CHECK, data.scanned)), '\0');
+        if (!tail.empty() && (reader.read(&tail[0], tail.size(), data.scanned - tail.size()) != tail.size() ||
+            crc32c_update(0, tail.data(), tail.size()) != data.check)) {
+            data = LineIndexData();
+            tail.clear();
+        }
+        std::vector<char> buf(DIGEST_SEGMENT);
+        std::uint64_t end = data.scanned;
+#ifndef _WIN32
+        struct stat st;
+        const std::uint64_t size = fstat(job.file.fd(), &st) == 0 ? static_cast<std::uint64_t>(st.st_size) : job.file.size;
+#else
+        const std::uint64_t size = job.file.size;
+#endif
+        while (end < size) {
+            const std::size_t n = static_cast<std::size_t>(std::min<std::uint64_t>(buf.size(), size - end));
+            const std::size_t got = reader.read(buf.data(), n, end);
+            if (got == 0) break;
+            for (std::size_t pos = 0; pos < got;) {
+                const std::uint64_t want = LINE_INDEX_STRIDE - data.lines % LINE_INDEX_STRIDE;
+                std::uint64_t seen = 0;
+                pos += skip_lines(buf.data() + pos, got - pos, want, seen);
+                data.lines += seen;
+                if (seen == want) data.marks.push_back(end + pos);
+            }
+            if (got >= LINE_INDEX_CHECK) tail.assign(buf.data() + got - LINE_INDEX_CHECK, LINE_INDEX_CHECK);
+            else {
+                tail.append(buf.data(), got);
+                if (tail.size() > LINE_INDEX_CHECK) tail.erase(0, tail.size() - LINE_INDEX_CHECK);
+            }
+            end += got;
+            data.scanned = end;
+        }
+        data.check = crc32c_update(0, tail.data(), tail.size());
+        {
+            std::lock_guard<std::mutex> lock(job.entry->mutex);
+            job.entry->building = false;
+            if (job.entry->generation != generation) return; // rewritten while building
+            job.entry->data = data;
+        }
+        save(job.key, data);
+    }
+
+    fs::path file_for(const std::string& key) const {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.idx", static_cast<unsigned long long>(fnv1a64(key.data(), key.size())));
+        return dir / name;
+    }
+
+    // Persisted form: magic, key, then scanned/lines/check/mark count and the marks (little-endian u64).
+    void save(const std::string& key, const LineIndexData& data) const {
+        if (dir.empty()) return;
+        std::string out = "AWLIDX1\n" + key + "\n";
+        auto put = [&out](std::uint64_t v) { for (int i = 0; i < 8; ++i) out.push_back(static_cast<char>(v >> (8 * i))); };
+        put(data.scanned);
+        put(data.lines);
+        put(data.check);
+        put(data.marks.size());
+        for (std::uint64_t m : data.marks) put(m);
+        const fs::path path = file_for(key);
+        fs::path tmp = path;
+        tmp += ".tmp";
+        {
+            std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+            f.write(out.data(), static_cast<std::streamsize>(out.size()));
+            if (!f) return;
+        }
+        std::error_code ec;
+        fs::rename(tmp, path, ec);
+    }
+
+    void load(const std::string& key, LineIndexData& data) const {
+        if (dir.empty()) return;
+        std::ifstream f(file_for(key), std::ios::binary);
+        std::string magic, stored_key;
+        if (!std::getline(f, magic) || magic != "AWLIDX1" || !std::getline(f, stored_key) || stored_key != key) return;
+        auto get = [&f](std::uint64_t& v) {
+            unsigned char b[8];
+            if (!f.read(reinterpret_cast<char*>(b), 8)) return false;
+            v = 0;
+            for (int i = 7; i >= 0; --i) v = (v << 8) | b[i];
+            return true;
+        };
+        LineIndexData loaded;
+        std::uint64_t check = 0, count = 0;
+        if (!get(loaded.scanned) || !get(loaded.lines) || !get(check) || !get(count)) return;
+        if (count == 0 || count != loaded.lines / LINE_INDEX_STRIDE + 1) return;
+        loaded.check = static_cast<std::uint32_t>(check);
+        loaded.marks.resize(static_cast<std::size_t>(count));
+        for (auto& m : loaded.marks) if (!get(m)) return;
+        data = std::move(loaded);
+    }
+
+    std::mutex mutex_;
+    std::condition_variable jobs_cv_;
+    std::deque<Job> jobs_;
+    bool worker_started_ = false;
+    std::unordered_map<std::string, std::shared_ptr<Entry>> entries_;
+    std::uint64_t tick_ = 0;
+};
+
+// Never destroyed: its worker thread is detached and may still be waiting at exit.
+LineIndexStore& g_line_index = *new LineIndexStore();
+
+// Offset where 1-based line `line` starts, or false when the file has fewer lines.
+bool find_line_start(const ResolvedFile& file, std::uint64_t line, std::uint64_t& offset) {
+    std::uint64_t skip = line - 1; // newlines before it
+    offset = 0;
+    {
+        auto entry = g_line_index.get(file);
+        std::lock_guard<std::mutex> lock(entry->mutex);
+        const auto& marks = entry->data.marks;
+        const std::size_t i = static_cast<std::size_t>(std::min<std::uint64_t>(skip / LINE_INDEX_STRIDE, marks.size() - 1));
+        offset = marks[i];
+        skip -= static_cast<std::uint64_t>(i) * LINE_INDEX_STRIDE;
+    }
+    SegmentReader reader(file);
+    std::vector<char> buf(TAIL_BLOCK);
+    while (skip > 0) {
+        const std::size_t got = reader.read(buf.data(), buf.size(), offset);
+        if (got == 0) return false;
+        std::uint64_t seen = 0;
+        const std::size_t pos = skip_lines(buf.data(), got, skip, seen);
+        offset += pos;
+        skip -= seen;
+    }
+    return offset < file.size;
+}
+
+// GET /file?lines=A-B (1-based, inclusive; "A" alone is one line, "A-" runs to
+// the end). Returns false when the query has no lines parameter.
+bool answer_lines_query(const httplib::Request& req, httplib::Response& res, const ResolvedFile& file) {
+    if (!req.has_param("lines")) return false;
+    const std::string spec = req.get_param_value("lines");
+    const std::size_t dash = spec.find('-');
+    std::uint64_t first = 0, last = 0;
+    try {
+        first = std::stoull(spec.substr(0, dash));
+        last = dash == std::string::npos ? first
+            : dash + 1 == spec.size() ? (std::numeric_limits<std::uint64_t>::max)() : std::stoull(spec.substr(dash + 1));
+    }
+    catch (...) { first = 0; }
+    if (first == 0 || last < first || spec.find_first_not_of("0123456789-") != std::string::npos) {
+        res.status = 400;
+        res.set_content("Invalid lines (expected A-B, 1-based)", "text/plain");
+        return true;
+    }
+
+    std::uint64_t start = 0;
+    if (!find_line_start(file, first, start)) {
+        res.status = 416;
+        res.set_content("The file has fewer than " + std::to_string(first) + " lines", "text/plain");
+        return true;
+    }
+
+    struct Cursor {
+        ResolvedFile file;
+        std::uint64_t offset;
+        std::uint64_t left;   // lines still to send
+        std::vector<char> buf;
+    };
+    auto cur = std::make_shared<Cursor>(Cursor{ file, start, last - first + 1, std::vector<char>(TAIL_BLOCK) });
+    const std::string ip = req.remote_addr;
+    res.set_header("Cache-Control", "no-cache");
+    res.set_header("X-Content-Type-Options", "nosniff");
+    res.set_chunked_content_provider("text/plain; charset=utf-8", [cur, ip](size_t, httplib::DataSink& sink) {
+        const std::size_t got = cur->left == 0 ? 0 : SegmentReader(cur->file).read(cur->buf.data(), cur->buf.size(), cur->offset);
+        if (got == 0) {
+            sink.done();
+            return true;
+        }
+        std::uint64_t seen = 0;
+        const std::size_t n = skip_lines(cur->buf.data(), got, cur->left, seen);
+        cur->left -= seen;
+        cur->offset += n;
+        if (g_outbound.enabled()) g_outbound.acquire(ip, n);
+        return sink.write(cur->buf.data(), n);
+    });
+    return true;
+}
+
+// --- Server-side grep (GET /dir?grep=PATTERN) ---
+// A walker thread lists regular files under the directory and worker threads,
+// drawn from the hashing budget, search them. Matching lines come back as
+// "path:line:text" while the search runs; each file's matches stay together.
+// Files with a NUL byte in their first 8 KB are taken as binary and skipped.
+// The search stops at the match limit, at GREP_MAX_OUTPUT bytes, after
+// --grep-timeout seconds or when the regex engine gives up on a line, and
+// names the reason in a Grep-Stopped trailer.
+
+int g_grep_timeout = 30;   // seconds; 0 disables ?grep=
+
+constexpr std::size_t GREP_BLOCK = 1 << 20;               // bytes searched per read
+constexpr std::size_t GREP_MAX_LINE = 512;                // longer lines are cut in the output
+constexpr std::size_t GREP_REGEX_SPAN = 4 * 1024;         // regex sees at most this much of a line
+constexpr std::size_t GREP_MAX_REGEX = 256;               // pattern length, for regexes
+constexpr std::uint64_t GREP_DEFAULT_MATCHES = 1000;
+constexpr std::uint64_t GREP_MAX_MATCHES = 100000;
+constexpr std::uint64_t GREP_MAX_OUTPUT = 64ull << 20;
+constexpr std::size_t GREP_QUEUE_BYTES = 1 << 20;         // unsent output before workers wait
+constexpr std::size_t GREP_QUEUE_FILES = 4096;
+
+struct GrepPattern {
+    std::string literal;    // occurs in every matching line (lowercase with icase); may be empty for a regex
+    bool icase = false;
+    bool use_regex = false;
+    std::regex re;
+    std::regex_constants::match_flag_type match_flags = std::regex_constants::match_default;
+};
+
+// Longest run of plain characters every match of `pattern` must contain; empty
+// when there is none or the pattern has alternatives.
+std::string regex_required_literal(const std::string& pattern) {
+    if (pattern.find('|') != std::string::npos) return std::string();
+    std::string best, run;
+    auto cut = [&] {
+        if (run.size() > best.size()) best = run;
+        run.clear();
+    };
+    for (std::size_t i = 0; i < pattern.size(); ++i) {
+        const char c = pattern[i];
+        if (c == '\\' && i + 1 < pattern.size()) {
+            const char next = pattern[++i];
+            if (std::isalnum(static_cast<unsigned char>(next))) cut(); // \d, \w, \b...
+            else run.push_back(next);
+        }
+        else if (c == '*' || c == '?' || c == '{') {
+            if (!run.empty()) run.pop_back(); // the previous character may be absent
+            cut();
+            if (c == '{') while (i + 1 < pattern.size() && pattern[i] != '}') ++i;
+        }
+        else if (c == '+') {
+            cut();
+        }
+        else if (c == '[' || c == '(') {
+            cut(); // classes and groups (which may be optional) contribute nothing
+            const char close = c == '[' ? ']' : ')';
+            for (int depth = 1; depth > 0 && ++i < pattern.size();) {
+                if (pattern[i] == '\\') ++i;
+                else if (pattern[i] == c && c == '(') ++depth;
+                else if (pattern[i] == close) --depth;
+            }
+        }
+        else if (c == '.' || c == '^' || c == '$' || c == ')' || c == ']') {
+            cut();
+        }
+        else {
+            run.push_back(c);
+        }
+    }
+    cut();
+    return best;
+}
+
+// True when a quantifier applies to a group that itself contains one, as in
+// (a+)* or (a|b?){2,}: the classic catastrophic-backtracking shapes.
+bool regex_nested_quantifier(const std::string& pattern) {
+    std::vector<bool> groups{ false };   // per open group: contains a quantifier
+    bool closed_quantified = false;      // the atom just closed was a group with one
+    for (std::size_t i = 0; i < pattern.size(); ++i) {
+        const char c = pattern[i];
+        const bool quantifier = c == '*' || c == '+' || c == '?' || c == '{';
+        if (quantifier) {
+            if (closed_quantified) return true;
+            groups.back() = true;
+            if (c == '{') while (i + 1 < pattern.size() && pattern[i] != '}') ++i;
+            continue;
+        }
+        closed_quantified = false;
+        if (c == '\\') {
+            ++i;
+        }
+        else if (c == '[') {
+            if (i + 1 < pattern.size() && pattern[i + 1] == ']') ++i;
+            while (++i < pattern.size() && pattern[i] != ']') if (pattern[i] == '\\') ++i;
+        }
+        else if (c == '(') {
+            groups.push_back(false);
+        }
+        else if (c == ')' && groups.size() > 1) {
+            closed_quantified = groups.back();
+            groups.pop_back();
+            if (closed_quantified) groups.back() = true;
+        }
+    }
+    return false;
+}
+
+bool parse_grep_pattern(const httplib::Request& req, GrepPattern& out, std::string& error) {
+    const std::string pattern = req.get_param_value("grep");
+    if (pattern.empty()) {
+        error = "Empty grep pattern";
+        return false;
+    }
+    out.icase = req.get_param_value("i") == "1";
+    out.use_regex = req.get_param_value("regex") == "1";
+    out.literal = out.use_regex ? regex_required_literal(pattern) : pattern;
+    if (out.icase) {
+        for (char& c : out.literal) if (ascii_alpha(c)) c = static_cast<char>(c | 0x20);
+    }
+    if (!out.use_regex) return true;
+    // Matching must stay bounded in time and stack: short patterns, no nested
+    // quantifiers, and with libstdc++ its non-backtracking executor, whose
+    // recursion depends on the pattern rather than the line (the backtracking
+    // one overflows the stack on long lines). That one has no backreferences,
+    // and searches by restarting at every offset, so the pattern gets a lazy
+    // any-prefix and is matched once from the line start instead: one pass.
+    // Other standard libraries backtrack; line_matches() ends the search if
+    // theirs gives up on a line.
+    if (pattern.size() > GREP_MAX_REGEX) {
+        error = "Grep regex too long (at most 256 characters)";
+        return false;
+    }
+    if (regex_nested_quantifier(pattern)) {
+        error = "Grep regex has nested quantifiers";
+        return false;
+    }
+    try {
+        auto flags = std::regex::ECMAScript | std::regex::optimize;
+        if (out.icase) flags |= std::regex::icase;
+#ifdef __GLIBCXX__
+        out.re = std::regex(pattern, flags | std::regex_constants::__polynomial); // validates it as written
+        out.re = std::regex("[\\s\\S]*?(?:" + pattern + ")", flags | std::regex_constants::__polynomial);
+        out.match_flags = std::regex_constants::match_continuous;
+#else
+        out.re = std::regex(pattern, flags);
+#endif
+    }
+    catch (const std::regex_error&) {
+        error = "Invalid grep regex";
+        return false;
+    }
+    return true;
+}
+
+// One search, shared by the walker, the workers and the content provider.
+class GrepSearch {
+public:
+    GrepSearch(GrepPattern pattern, std::uint64_t max_matches)
+        : pattern_(std::move(pattern)), max_matches_(max_matches),
+        deadline_(std::chrono::steady_clock::now() + std::chrono::seconds(g_grep_timeout)) {}
+
+    // Walk `dir` (paths reported with `prefix`) on a new thread and search on
+    // one more plus `helpers` claimed from the hashing budget.
+    static void start(const std::shared_ptr<GrepSearch>& self, const fs::path& dir, const std::string& prefix, unsigned helpers) {
+        self->workers_left_ = 1 + helpers;
+        std::thread([self, dir, prefix] { self->walk(dir, prefix); }).detach();
+        for (unsigned t = 0; t <= helpers; ++t) {
+            std::thread([self, helper = t > 0] {
+                self->work();
+                if (helper) release_hash_threads(1);
+            }).detach();
+        }
+    }
+
+    // Next piece of output for the client; false at the end (reason set when a limit cut it short).
+    bool next(std::string& out, std::string& reason) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        out_cv_.wait_until(lock, deadline_, [this] { return !out_.empty() || finished_locked(); });
+        if (out_.empty() && !finished_locked()) stop_locked("time");
+        out.swap(out_);
+        out_.clear();
+        space_cv_.notify_all();
+        reason = reason_;
+        return !out.empty();
+    }
+
+    void cancel() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_locked("cancelled");
+    }
+
+private:
+    struct Item {
+        fs::path path;
+        std::string rel;
+    };
+
+    bool stopped() const { return stop_.load(std::memory_order_relaxed); }
+
+    void stop_locked(const char* reason) {
+        if (!stop_) reason_ = reason;
+        stop_ = true;
+        files_cv_.notify_all();
+        space_cv_.notify_all();
+        out_cv_.notify_all();
+    }
+
+    void stop(const char* reason) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_locked(reason);
+    }
+
+    bool finished_locked() const { return workers_left_ == 0 || (stop_ && out_.empty()); }
+
+    bool past_deadline() {
+        if (std::chrono::steady_clock::now() < deadline_) return false;
+        stop("time");
+        return true;
+    }
+
+    void walk(const fs::path& dir, const std::string& prefix) {
+        std::error_code ec;
+        for (auto it = fs::recursive_directory_iterator(dir, fs::directory_options::skip_permission_denied, ec);
+            !ec && it != fs::recursive_directory_iterator() && !stopped(); it.increment(ec)) {
+            if (!fs::is_regular_file(it->symlink_status(ec))) continue; // symlinks may point outside the root
+            Item item{ it->path(), prefix + it->path().lexically_relative(dir).generic_u8string() };
+            std::unique_lock<std::mutex> lock(mutex_);
+            files_cv_.wait(lock, [this] { return files_.size() < GREP_QUEUE_FILES || stop_; });
+            files_.push_back(std::move(item));
+            files_cv_.notify_one();
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        walked_ = true;
+        files_cv_.notify_all();
+    }
+
+    void work() {
+        std::vector<char> buf(GREP_BLOCK);
+        for (;;) {
+            Item item;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                files_cv_.wait(lock, [this] { return !files_.empty() || walked_ || stop_; });
+                if (stop_ || files_.empty()) break;
+                item = std::move(files_.front());
+                files_.pop_front();
+                files_cv_.notify_all();
+            }
+            search(item, buf);
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        --workers_left_;
+        out_cv_.notify_all();
+    }
+
+    // Queue a file's output, waiting while the client is behind. Matches found
+    // before a limit stopped the search are still sent.
+    void emit(std::string& text) {
+        if (text.empty()) return;
+        std::unique_lock<std::mutex> lock(mutex_);
+        space_cv_.wait(lock, [this] { return out_.size() < GREP_QUEUE_BYTES || stop_; });
+        if (reason_ != "cancelled") out_ += text;
+        out_cv_.notify_one();
+        text.clear();
+    }
+
+    bool add_match(std::string& pending, const std::string& rel, std::uint64_t line, const char* text, std::size_t n) {
+        if (matches_.fetch_add(1) >= max_matches_) {
+            stop("matches");
+            return false;
+        }
+        if (n > 0 && text[n - 1] == '\r') --n;
+        const bool cut = n > GREP_MAX_LINE;
+        const std::size_t before = pending.size();
+        pending += rel;
+        pending += ':';
+        pending += std::to_string(line);
+        pending += ':';
+        pending.append(text, cut ? GREP_MAX_LINE : n);
+        if (cut) pending += "...";
+        pending += '\n';
+        if (output_bytes_.fetch_add(pending.size() - before) + (pending.size() - before) > GREP_MAX_OUTPUT) {
+            pending.resize(before);
+            stop("bytes");
+            return false;
+        }
+        if (pending.size() >= 64 * 1024) emit(pending);
+        return true;
+    }
+
+    bool line_matches(const char* line, std::size_t n) {
+        if (!pattern_.use_regex) return true; // the literal hit is the match
+        const std::size_t span = std::min(n, GREP_REGEX_SPAN);
+        try {
+            return std::regex_search(line, line + span, pattern_.re, pattern_.match_flags);
+        }
+        catch (const std::regex_error&) {
+            stop("regex"); // error_complexity / error_stack from a backtracking engine
+            return false;
+        }
+    }
+
+    void search(const Item& item, std::vector<char>& buf) {
+        std::ifstream in(item.path, std::ios::binary);
+        if (!in) return;
+        std::string pending;
+        std::uint64_t line_no = 1;     // line number at buf[0]
+        std::size_t have = 0;
+        bool first = true, eof = false;
+        while (!eof && !stopped() && !past_deadline()) {
+            in.read(buf.data() + have, static_cast<std::streamsize>(buf.size() - have));
+            const std::size_t got = static_cast<std::size_t>(in.gcount());
+            eof = got < buf.size() - have;
+            have += got;
+            if (first) {
+                first = false;
+                if (std::memchr(buf.data(), '\0', std::min<std::size_t>(have, 8192))) return;
+            }
+            // Search whole lines; a line longer than the buffer is searched in pieces.
+            std::size_t end = have;
+            if (!eof) {
+                const char* nl = last_newline(buf.data(), have);
+                if (nl) end = static_cast<std::size_t>(nl - buf.data()) + 1;
+            }
+            const char* p = buf.data();
+            std::size_t pos = 0, counted = 0;
+            while (pos < end) {
+                std::size_t line_start = pos, hit = pos;
+                if (!pattern_.literal.empty()) {
+                    const std::size_t at = find_literal(p + pos, end - pos, pattern_.literal, pattern_.icase);
+                    if (at == std::string::npos) break;
+                    hit = pos + at;
+                    const char* nl = last_newline(p + pos, hit - pos);
+                    if (nl) line_start = static_cast<std::size_t>(nl - p) + 1;
+                }
+                const void* nl = std::memchr(p + hit, '\n', end - hit);
+                const std::size_t line_end = nl ? static_cast<std::size_t>(static_cast<const char*>(nl) - p) : end;
+                if (line_matches(p + line_start, line_end - line_start)) {
+                    std::uint64_t seen = 0;
+                    skip_lines(p + counted, line_start - counted, (std::numeric_limits<std::uint64_t>::max)(), seen);
+                    line_no += seen;
+                    counted = line_start;
+                    if (!add_match(pending, item.rel, line_no, p + line_start, line_end - line_start)) break;
+                }
+                else if (stopped()) {
+                    break;
+                }
+                pos = line_end + 1;
+            }
+            std::uint64_t seen = 0;
+            skip_lines(p + counted, end - counted, (std::numeric_limits<std::uint64_t>::max)(), seen);
+            line_no += seen;
+            std::memmove(buf.data(), buf.data() + end, have - end);
+            have -= end;
+        }
+        emit(pending);
+    }
+
+    const GrepPattern pattern_;
+    const std::uint64_t max_matches_;
+    const std::chrono::steady_clock::time_point deadline_;
+    std::atomic<bool> stop_{ false };
+    std::atomic<std::uint64_t> matches_{ 0 };
+    std::atomic<std::uint64_t> output_bytes_{ 0 };
+
+    std::mutex mutex_;
+    std::condition_variable files_cv_;  // files_ changed, walked_ set or stopped
+    std::condition_variable space_cv_;  // out_ drained
+    std::condition_variable out_cv_;    // out_ filled or a worker finished
+    std::deque<Item> files_;
+    bool walked_ = false;
+    unsigned workers_left_ = 0;
+    std::string out_;
+    std::string reason_;
+};
+
+// GET /dir?grep=PATTERN[&regex=1][&i=1][&max=N] on a directory; false when the
+// query has no grep parameter.
+bool answer_grep_query(const httplib::Request& req, httplib::Response& res, const fs::path& dir, const std::string& rel) {
+    if (!req.has_param("grep")) return false;
+    if (g_grep_timeout == 0) {
+        res.status = 403;
+        res.set_content("Grep is disabled", "text/plain");
+        return true;
+    }
+    GrepPattern pattern;
+    std::string error;
+    if (!parse_grep_pattern(req, pattern, error)) {
+        res.status = 400;
+        res.set_content(error, "text/plain");
+        return true;
+    }
+    std::uint64_t max_matches = GREP_DEFAULT_MATCHES;
+    if (req.has_param("max")) {
+        const std::string value = req.get_param_value("max");
+        if (value.empty() || value.size() > 18 || value.find_first_not_of("0123456789") != std::string::npos) {
+            res.status = 400;
+            res.set_content("Invalid max (expected a match count)", "text/plain");
+            return true;
+        }
+        max_matches = std::min<std::uint64_t>(std::stoull(value), GREP_MAX_MATCHES);
+    }
+
+    auto search = std::make_shared<GrepSearch>(std::move(pattern), max_matches);
+    const unsigned helpers = claim_hash_threads(std::max(1u, std::thread::hardware_concurrency()) - 1);
+    GrepSearch::start(search, dir, rel == "." ? std::string() : rel + "/", helpers);
+
+    const std::string ip = req.remote_addr;
+    res.set_header("Cache-Control", "no-cache");
+    res.set_header("X-Content-Type-Options", "nosniff");
+    res.set_header("Trailer", "Grep-Stopped");
+    res.set_chunked_content_provider("text/plain; charset=utf-8",
+        [search, ip](size_t, httplib::DataSink& sink) {
+            std::string out, reason;
+            if (!search->next(out, reason)) {
+                httplib::Headers trailer;
+                if (!reason.empty()) trailer.emplace("Grep-Stopped", reason);
+                sink.done_with_trailer(trailer);
+                return true;
+            }
+            if (g_outbound.enabled()) g_outbound.acquire(ip, out.size());
+            return sink.write(out.data(), out.size());
+        },
+        [search](bool) { search->cancel(); });
+    return true;
+}
+
+// --- Tree index (--tree-index: listings, ?find=, ?du=1) ---
+// With --tree-index the served directory is mirrored in memory and kept
+// current through inotify, so directory listings, name searches and recursive
+// sizes don't touch the disk.
+// - Nodes live in parallel arrays (struct of arrays) and refer to interned
+//   names. A directory's size is the total of its subtree, kept up to date as
+//   files change.
+// - Events are coalesced and applied once the tree has been quiet for
+//   TREE_SETTLE_MS (or TREE_MAX_DELAY_MS at the latest). A queue overflow
+//   rebuilds the index.
+// - Symbolic links are listed but never followed.
+// - New directories are read from the disk outside the lock and then added.
+// Until the first scan completes, and without inotify, the same queries read
+// the disk; so do queries covering a directory that could not be read or is
+// still being scanned.
+
+bool g_tree_index_enabled = false;   // --tree-index
+
+constexpr std::size_t FIND_DEFAULT_RESULTS = 1000;
+constexpr std::size_t FIND_MAX_RESULTS = 100000;
+
+#ifdef __linux__
+class TreeIndex {
+public:
+    void start(const std::string& root) {
+        root_ = root;
+        std::thread([this] { run(); }).detach();
+    }
+
+    // Subdirectories and files of `rel` ("." is the root), as the disk listing shows them.
+    bool list(const std::string& rel, std::vector<std::string>& dirs, std::vector<std::string>& files) const {
+        if (!ready_.load(std::memory_order_acquire)) return false;
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        const std::uint32_t dir = lookup(rel);
+        if (dir == NONE || !(kind_[dir] & IS_DIR) || (kind_[dir] & UNLISTED)) return false;
+        for (std::uint32_t c = first_child_[dir]; c != NONE; c = next_[c]) {
+            if (kind_[c] & SHOWN_DIR) dirs.push_back(names_[name_[c]]);
+            else if (kind_[c] & SHOWN_FILE) files.push_back(names_[name_[c]]);
+        }
+        return true;
+    }
+
+    // Paths below `rel` whose name contains `needle` (lowercase, matched ignoring ASCII case).
+    bool find(const std::string& rel, const std::string& needle, std::size_t max, std::vector<std::string>& out) const {
+        if (!ready_.load(std::memory_order_acquire)) return false;
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        const std::uint32_t dir = lookup(rel);
+        if (dir == NONE || !(kind_[dir] & IS_DIR) || !complete(dir)) return false;
+        std::vector<std::pair<std::uint32_t, std::string>> stack{ { dir, rel == "." ? std::string() : rel + "/" } };
+        while (!stack.empty() && out.size() < max) {
+            const auto top = std::move(stack.back());
+            stack.pop_back();
+            for (std::uint32_t c = first_child_[top.first]; c != NONE && out.size() < max; c = next_[c]) {
+                const std::string& name = names_[name_[c]];
+                if (!(kind_[c] & (SHOWN_DIR | SHOWN_FILE))) continue;
+                if (find_literal(name.data(), name.size(), needle, true) != std::string::npos) {
+                    out.push_back(top.second + name + (kind_[c] & SHOWN_DIR ? "/" : ""));
+                }
+                if (kind_[c] & IS_DIR) stack.emplace_back(c, top.second + name + "/");
+            }
+        }
+        return true;
+    }
+
+    // Recursive size of `rel` and of each entry in it (symlinks count as 0).
+    bool usage(const std::string& rel, std::vector<std::pair<std::string, std::uint64_t>>& entries, std::uint64_t& total) const {
+        if (!ready_.load(std::memory_order_acquire)) return false;
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        const std::uint32_t dir = lookup(rel);
+        if (dir == NONE || !(kind_[dir] & IS_DIR) || !complete(dir)) return false;
+        for (std::uint32_t c = first_child_[dir]; c != NONE; c = next_[c]) {
+            if (!(kind_[c] & (SHOWN_DIR | SHOWN_FILE))) continue;
+            entries.emplace_back(names_[name_[c]] + (kind_[c] & SHOWN_DIR ? "/" : ""), size_[c]);
+        }
+        total = size_[dir];
+        return true;
+    }
+
+private:
+    static constexpr std::uint32_t NONE = 0xFFFFFFFFu;
+    static constexpr int TREE_SETTLE_MS = 100;
+    static constexpr int TREE_MAX_DELAY_MS = 1000;
+    static constexpr std::uint32_t WATCH_MASK = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_MODIFY |
+        IN_CLOSE_WRITE | IN_ATTRIB | IN_ONLYDIR | IN_DONT_FOLLOW | IN_EXCL_UNLINK;
+
+    enum : std::uint8_t {
+        IS_DIR = 1,      // a real directory, indexed below
+        IS_FILE = 2,     // a regular file, counted in sizes
+        SHOWN_DIR = 4,   // listed as a directory (directories and links to them)
+        SHOWN_FILE = 8,  // listed as a file (files and links to them)
+        UNLISTED = 16,   // a directory whose contents are not indexed (unreadable, or not scanned yet)
+    };
+
+    // An entry found by read_tree(); `parent` is its directory's position in
+    // the same list, or NONE for entries of the directory read.
+    struct ScannedEntry {
+        std::uint32_t parent;
+        std::string name;
+        std::uint64_t ino;
+        std::uint64_t size;
+        std::uint8_t kind;
+        int wd = -1;          // directories: their watch, if one could be added
+        bool listed = false;  // directories: contents read
+    };
+
+    static std::uint64_t child_key(std::uint32_t parent, std::uint32_t name) {
+        return (static_cast<std::uint64_t>(parent) << 32) | name;
+    }
+
+    std::uint32_t lookup(const std::string& rel) const {
+        std::uint32_t node = 0;
+        std::size_t pos = 0;
+        while (pos < rel.size() && node != NONE) {
+            std::size_t slash = rel.find('/', pos);
+            if (slash == std::string::npos) slash = rel.size();
+            const std::string_view part = std::string_view(rel).substr(pos, slash - pos);
+            pos = slash + 1;
+            if (part.empty() || part == ".") continue;
+            const auto name = intern_.find(part);
+            if (name == intern_.end()) return NONE;
+            const auto child = children_.find(child_key(node, name->second));
+            node = child == children_.end() ? NONE : child->second;
+        }
+        return node;
+    }
+
+    // False when a directory at or below `dir` is unlisted.
+    bool complete(std::uint32_t dir) const {
+        for (std::uint32_t n : unlisted_) {
+            for (std::uint32_t p = n; p != NONE; p = parent_[p]) {
+                if (p == dir) return false;
+            }
+        }
+        return true;
+    }
+
+    std::uint32_t intern(const std::string& name) {
+        const auto it = intern_.find(name);
+        if (it != intern_.end()) {
+            ++name_refs_[it->second];
+            return it->second;
+        }
+        std::uint32_t id;
+        if (!free_names_.empty()) {
+            id = free_names_.back();
+            free_names_.pop_back();
+            names_[id] = name;
+            name_refs_[id] = 1;
+        }
+        else {
+            id = static_cast<std::uint32_t>(names_.size());
+            names_.push_back(name);
+            name_refs_.push_back(1);
+        }
+        intern_.emplace(names_[id], id);
+        return id;
+    }
+
+    void release_name(std::uint32_t id) {
+        if (--name_refs_[id] > 0) return;
+        intern_.erase(names_[id]);
+        names_[id].clear();
+        free_names_.push_back(id);
+    }
+
+    std::string path_of(std::uint32_t node) const {
+        std::vector<std::uint32_t> chain;
+        for (; node != 0; node = parent_[node]) chain.push_back(node);
+        std::string path = root_;
+        for (auto it = chain.rbegin(); it != chain.rend(); ++it) path += "/" + names_[name_[*it]];
+        return path;
+    }
+
+    // Kind bits for an entry, from its lstat(); 0 for entries the listing hides.
+    static std::uint8_t kind_of(int dirfd, const char* name, const struct stat& st) {
+        if (S_ISDIR(st.st_mode)) return IS_DIR | SHOWN_DIR;
+        if (S_ISREG(st.st_mode)) return IS_FILE | SHOWN_FILE;
+        struct stat target;
+        if (!S_ISLNK(st.st_mode) || fstatat(dirfd, name, &target, 0) != 0) return 0;
+        return S_ISDIR(target.st_mode) ? SHOWN_DIR : S_ISREG(target.st_mode) ? SHOWN_FILE : 0;
+    }
+
+    void add_size(std::uint32_t node, std::int64_t delta) {
+        for (; node != NONE; node = parent_[node]) size_[node] += static_cast<std::uint64_t>(delta);
+    }
+
+    std::uint32_t add_node(std::uint32_t parent, const std::string& name, std::uint64_t ino, std::uint64_t size, std::uint8_t kind) {
+        std::uint32_t n;
+        if (!free_nodes_.empty()) {
+            n = free_nodes_.back();
+            free_nodes_.pop_back();
+        }
+        else {
+            n = static_cast<std::uint32_t>(kind_.size());
+            parent_.push_back(NONE);
+            name_.push_back(0);
+            first_child_.push_back(NONE);
+            next_.push_back(NONE);
+            prev_.push_back(NONE);
+            kind_.push_back(0);
+            ino_.push_back(0);
+            size_.push_back(0);
+        }
+        parent_[n] = parent;
+        name_[n] = intern(name);
+        first_child_[n] = NONE;
+        kind_[n] = kind;
+        ino_[n] = ino;
+        size_[n] = 0;
+        prev_[n] = NONE;
+        if (parent != NONE) {
+            next_[n] = first_child_[parent];
+            if (next_[n] != NONE) prev_[next_[n]] = n;
+            first_child_[parent] = n;
+            children_[child_key(parent, name_[n])] = n;
+        }
+        else {
+            next_[n] = NONE;
+        }
+        if (kind & IS_FILE) add_size(n, static_cast<std::int64_t>(size));
+        return n;
+    }
+
+    void set_listed(std::uint32_t node, bool listed) {
+        if (listed) {
+            kind_[node] = static_cast<std::uint8_t>(kind_[node] & ~UNLISTED);
+            unlisted_.erase(node);
+        }
+        else {
+            kind_[node] |= UNLISTED;
+            unlisted_.insert(node);
+        }
+    }
+
+    void remove_node(std::uint32_t node) {
+        const std::uint32_t parent = parent_[node];
+        add_size(parent, -static_cast<std::int64_t>(size_[node]));
+        if (prev_[node] != NONE) next_[prev_[node]] = next_[node];
+        else first_child_[parent] = next_[node];
+        if (next_[node] != NONE) prev_[next_[node]] = prev_[node];
+
+        std::vector<std::uint32_t> stack{ node };
+        while (!stack.empty()) {
+            const std::uint32_t n = stack.back();
+            stack.pop_back();
+            for (std::uint32_t c = first_child_[n]; c != NONE; c = next_[c]) stack.push_back(c);
+            const auto wd = wd_of_.find(n);
+            if (wd != wd_of_.end()) {
+                // Watches are per inode: a directory renamed within the tree keeps
+                // its watch, which the node under the new name may own already.
+                const auto owner = node_of_.find(wd->second);
+                if (owner != node_of_.end() && owner->second == n) {
+                    inotify_rm_watch(fd_, wd->second);
+                    node_of_.erase(owner);
+                }
+                wd_of_.erase(wd);
+            }
+            if (kind_[n] & UNLISTED) {
+                unlisted_.erase(n);
+                unscanned_.erase(std::remove(unscanned_.begin(), unscanned_.end(), n), unscanned_.end());
+            }
+            children_.erase(child_key(parent_[n], name_[n]));
+            release_name(name_[n]);
+            kind_[n] = 0;
+            free_nodes_.push_back(n);
+        }
+    }
+
+    // Watch and read the directory at `path` and everything below it, without
+    // touching the index; false when inotify runs out of watches.
+    bool read_tree(const std::string& path, int& wd, bool& listed, std::vector<ScannedEntry>& out) const {
+        std::vector<std::pair<std::uint32_t, std::string>> stack{ { NONE, path } };
+        while (!stack.empty()) {
+            const auto top = std::move(stack.back());
+            stack.pop_back();
+            const int w = inotify_add_watch(fd_, top.second.c_str(), WATCH_MASK);
+            if (w < 0 && errno == ENOSPC) return false;
+            DIR* d = w >= 0 ? opendir(top.second.c_str()) : nullptr;
+            bool ok = d != nullptr;
+            while (d) {
+                const dirent* e = readdir(d);
+                if (!e) break;
+                if (std::strcmp(e->d_name, ".") == 0 || std::strcmp(e->d_name, "..") == 0) continue;
+                struct stat st;
+                if (fstatat(dirfd(d), e->d_name, &st, AT_SYMLINK_NOFOLLOW) != 0) {
+                    if (errno != EACCES) continue;
+                    ok = false; // readable but not searchable
+                    break;
+                }
+                const std::uint8_t kind = kind_of(dirfd(d), e->d_name, st);
+                if (!kind) continue;
+                out.push_back({ top.first, e->d_name, static_cast<std::uint64_t>(st.st_ino), static_cast<std::uint64_t>(st.st_size), kind });
+                if (kind & IS_DIR) stack.emplace_back(static_cast<std::uint32_t>(out.size() - 1), top.second + "/" + e->d_name);
+            }
+            if (d) closedir(d);
+            (top.first == NONE ? wd : out[top.first].wd) = w;
+            (top.first == NONE ? listed : out[top.first].listed) = ok;
+        }
+        return true;
+    }
+
+    void set_watch(std::uint32_t dir, int wd) {
+        if (wd < 0) return;
+        node_of_[wd] = dir;
+        wd_of_[dir] = wd;
+    }
+
+    // Read the directories added since the last call (their nodes are still
+    // empty) without holding the lock, then add what was found; false when
+    // inotify runs out of watches.
+    bool scan_pending() {
+        if (unscanned_.empty()) return true;
+        struct Scan {
+            int wd = -1;
+            bool listed = false;
+            std::vector<ScannedEntry> entries;
+        };
+        // Only this thread changes the index, so it can be read here unlocked.
+        std::vector<Scan> scans(unscanned_.size());
+        for (std::size_t i = 0; i < scans.size(); ++i) {
+            if (!read_tree(path_of(unscanned_[i]), scans[i].wd, scans[i].listed, scans[i].entries)) return false;
+        }
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        for (std::size_t i = 0; i < scans.size(); ++i) {
+            const std::uint32_t dir = unscanned_[i];
+            set_watch(dir, scans[i].wd);
+            set_listed(dir, scans[i].listed);
+            const auto& entries = scans[i].entries;
+            std::vector<std::uint32_t> node(entries.size());
+            for (std::size_t k = 0; k < entries.size(); ++k) {
+                const ScannedEntry& e = entries[k];
+                node[k] = add_node(e.parent == NONE ? dir : node[e.parent], e.name, e.ino, e.size, e.kind);
+                if (!(e.kind & IS_DIR)) continue;
+                set_watch(node[k], e.wd);
+                if (!e.listed) set_listed(node[k], false);
+            }
+        }
+        unscanned_.clear();
+        return true;
+    }
+
+    // Bring entry `name` of directory node `dir` in line with the disk; a new
+    // directory is left for scan_pending().
+    void apply(std::uint32_t dir, const std::string& name) {
+        std::uint32_t existing = NONE;
+        const auto id = intern_.find(name);
+        if (id != intern_.end()) {
+            const auto child = children_.find(child_key(dir, id->second));
+            if (child != children_.end()) existing = child->second;
+        }
+        const std::string parent_path = path_of(dir);
+        const int dfd = open(parent_path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        struct stat st;
+        const std::uint8_t kind = dfd >= 0 && fstatat(dfd, name.c_str(), &st, AT_SYMLINK_NOFOLLOW) == 0 ? kind_of(dfd, name.c_str(), st) : 0;
+        if (dfd >= 0) close(dfd);
+        if (existing != NONE && kind != 0 && kind == kind_[existing] && ino_[existing] == static_cast<std::uint64_t>(st.st_ino)) {
+            if (kind & IS_FILE) {
+                add_size(existing, static_cast<std::int64_t>(st.st_size) - static_cast<std::int64_t>(size_[existing]));
+            }
+            return; // a directory's contents are kept current by its own watch (an unlisted one is read again)
+        }
+        if (existing != NONE) remove_node(existing);
+        if (kind == 0) return;
+        const std::uint32_t node = add_node(dir, name, static_cast<std::uint64_t>(st.st_ino), static_cast<std::uint64_t>(st.st_size), kind);
+        if (kind & IS_DIR) {
+            set_listed(node, false);
+            unscanned_.push_back(node);
+        }
+    }
+
+    bool rebuild() {
+        {
+            std::unique_lock<std::shared_mutex> lock(mutex_);
+            if (fd_ >= 0) close(fd_);
+            fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            parent_.clear(); name_.clear(); first_child_.clear(); next_.clear(); prev_.clear();
+            kind_.clear(); ino_.clear(); size_.clear();
+            free_nodes_.clear();
+            names_.clear(); name_refs_.clear(); free_names_.clear(); intern_.clear();
+            children_.clear(); node_of_.clear(); wd_of_.clear();
+            unlisted_.clear(); unscanned_.clear();
+            struct stat st;
+            if (fd_ < 0 || stat(root_.c_str(), &st) != 0) return false;
+            const std::uint32_t root = add_node(NONE, std::string(), static_cast<std::uint64_t>(st.st_ino), 0, IS_DIR | SHOWN_DIR);
+            set_listed(root, false);
+            unscanned_.push_back(root);
+        }
+        return scan_pending();
+    }
+
+    void disable(const char* why) {
+        ready_.store(false, std::memory_order_release);
+        std::cerr << "Warning: --tree-index disabled (" << why << "); listings read the disk." << std::endl;
+        if (fd_ >= 0) close(fd_);
+        fd_ = -1;
+    }
+
+    void run() {
+        if (!rebuild()) return disable("cannot watch the served directory; see fs.inotify.max_user_watches");
+        ready_.store(true, std::memory_order_release);
+
+        alignas(inotify_event) char buf[64 * 1024];
+        std::set<std::pair<int, std::string>> pending; // (watch, entry name)
+        bool overflow = false;
+        auto first_pending = std::chrono::steady_clock::now();
+        for (;;) {
+            pollfd p{ fd_, POLLIN, 0 };
+            const bool waiting = overflow || !pending.empty();
+            if (poll(&p, 1, waiting ? TREE_SETTLE_MS : -1) > 0) {
+                const ssize_t n = read(fd_, buf, sizeof(buf));
+                for (ssize_t off = 0; n > 0 && off < n;) {
+                    const auto* e = reinterpret_cast<const inotify_event*>(buf + off);
+                    off += static_cast<ssize_t>(sizeof(inotify_event) + e->len);
+                    if (e->mask & IN_Q_OVERFLOW) overflow = true;
+                    else if (e->len > 0) pending.emplace(e->wd, std::string(e->name));
+                }
+                if (!waiting) first_pending = std::chrono::steady_clock::now();
+                if (std::chrono::steady_clock::now() - first_pending < std::chrono::milliseconds(TREE_MAX_DELAY_MS)) continue;
+            }
+            if (overflow) {
+                pending.clear();
+                overflow = false;
+                ready_.store(false, std::memory_order_release);
+                if (!rebuild()) return disable("rebuild after an event queue overflow failed");
+                ready_.store(true, std::memory_order_release);
+                continue;
+            }
+            {
+                std::unique_lock<std::shared_mutex> lock(mutex_);
+                for (const auto& item : pending) {
+                    const auto dir = node_of_.find(item.first); // gone when its directory was removed meanwhile
+                    if (dir != node_of_.end()) apply(dir->second, item.second);
+                }
+            }
+            pending.clear();
+            if (!scan_pending()) return disable("out of inotify watches; see fs.inotify.max_user_watches");
+        }
+    }
+
+    std::string root_;
+    int fd_ = -1;
+    std::atomic<bool> ready_{ false };
+    mutable std::shared_mutex mutex_;
+
+    // Nodes, struct of arrays; node 0 is the root.
+    std::vector<std::uint32_t> parent_, name_, first_child_, next_, prev_;
+    std::vector<std::uint8_t> kind_;
+    std::vector<std::uint64_t> ino_;
+    std::vector<std::uint64_t> size_;   // file size, or subtree total for directories
+    std::vector<std::uint32_t> free_nodes_;
+
+    // Interned names (reference counted) and the lookups built on them.
+    std::deque<std::string> names_;
+    std::vector<std::uint32_t> name_refs_;
+    std::vector<std::uint32_t> free_names_;
+    std::unordered_map<std::string_view, std::uint32_t> intern_;
+    std::unordered_map<std::uint64_t, std::uint32_t> children_;  // (parent, name) -> node
+    std::unordered_map<int, std::uint32_t> node_of_;             // watch -> directory node
+    std::unordered_map<std::uint32_t, int> wd_of_;
+    std::set<std::uint32_t> unlisted_;                           // directory nodes marked UNLISTED
+    std::vector<std::uint32_t> unscanned_;                       // new directory nodes, for scan_pending()
+};
+#else
+class TreeIndex {
+public:
+    void start(const std::string&) {}
+    bool list(const std::string&, std::vector<std::string>&, std::vector<std::string>&) const { return false; }
+    bool find(const std::string&, const std::string&, std::size_t, std::vector<std::string>&) const { return false; }
+    bool usage(const std::string&, std::vector<std::pair<std::string, std::uint64_t>>&, std::uint64_t&) const { return false; }
+};
+#endif
+
+// Never destroyed: its watcher thread is detached and may still be running at exit.
+TreeIndex& g_tree_index = *new TreeIndex();
+
+// GET /dir?find=TEXT[&max=N]: paths below the directory whose name contains
+// TEXT (ignoring ASCII case), one per line, directories with a trailing '/'.
+bool answer_find_query(const httplib::Request& req, httplib::Response& res, const fs::path& dir, const std::string& rel) {
+    if (!req.has_param("find")) return false;
+    std::string needle = req.get_param_value("find");
+    if (needle.empty()) {
+        res.status = 400;
+        res.set_content("Empty find pattern", "text/plain");
+        return true;
+    }
+    for (char& c : needle) if (ascii_alpha(c)) c = static_cast<char>(c | 0x20);
+    std::size_t max = FIND_DEFAULT_RESULTS;
+    if (req.has_param("max")) {
+        const std::string value = req.get_param_value("max");
+        if (value.empty() || value.size() > 18 || value.find_first_not_of("0123456789") != std::string::npos) {
+            res.status = 400;
+            res.set_content("Invalid max (expected a result count)", "text/plain");
+            return true;
+        }
+        max = static_cast<std::size_t>(std::min<std::uint64_t>(std::stoull(value), FIND_MAX_RESULTS));
+    }
+
+    std::vector<std::string> found;
+    if (!g_tree_index.find(rel, needle, max, found)) {
+        const std::string prefix = rel == "." ? std::string() : rel + "/";
+        std::error_code ec;
+        for (auto it = fs::recursive_directory_iterator(dir, fs::directory_options::skip_permission_denied, ec);
+            !ec && it != fs::recursive_directory_iterator() && found.size() < max; it.increment(ec)) {
+            const std::string name = it->path().filename().u8string();
+            if (find_literal(name.data(), name.size(), needle, true) == std::string::npos) continue;
+            std::error_code type_ec; // broken links: skip the entry, keep walking
+            const bool is_dir = it->is_directory(type_ec);
+            if (!is_dir && !it->is_regular_file(type_ec)) continue;
+            found.push_back(prefix + it->path().lexically_relative(dir).generic_u8string() + (is_dir ? "/" : ""));
+        }
+    }
+    std::sort(found.begin(), found.end());
+    std::string body;
+    for (const auto& path : found) body += path + "\n";
+    res.set_header("Cache-Control", "no-cache");
+    res.set_content(body, "text/plain; charset=utf-8");
+    return true;
+}
+
+// GET /dir?du=1: "<bytes>\t<name>" for each entry (directories recursively,
+// symlinks as 0), then "<total>\t." for the directory itself.
+bool answer_du_query(const httplib::Request& req, httplib::Response& res, const fs::path& dir, const std::string& rel) {
+    if (req.get_param_value("du") != "1") return false;
+    std::vector<std::pair<std::string, std::uint64_t>> entries;
+    std::uint64_t total = 0;
+    if (!g_tree_index.usage(rel, entries, total)) {
+        entries.clear();
+        total = 0;
+        std::error_code ec;
+        for (auto it = fs::directory_iterator(dir, fs::directory_options::skip_permission_denied, ec); !ec && it != fs::directory_iterator(); it.increment(ec)) {
+            std::error_code entry_ec;
+            const auto st = it->symlink_status(entry_ec);
+            std::uint64_t size = 0;
+            if (fs::is_regular_file(st)) {
+                size = it->file_size(entry_ec);
+            }
+            else if (fs::is_directory(st)) {
+                for (auto sub = fs::recursive_directory_iterator(it->path(), fs::directory_options::skip_permission_denied, entry_ec);
+                    !entry_ec && sub != fs::recursive_directory_iterator(); sub.increment(entry_ec)) {
+                    std::error_code sub_ec;
+                    if (fs::is_regular_file(sub->symlink_status(sub_ec))) size += sub->file_size(sub_ec);
+                }
+            }
+            entry_ec.clear();
+            const bool shown_dir = it->is_directory(entry_ec);
+            if (!shown_dir && !it->is_regular_file(entry_ec)) continue;
+            entries.emplace_back(it->path().filename().u8string() + (shown_dir ? "/" : ""), size);
+            total += size;
+        }
+    }
+    std::sort(entries.begin(), entries.end());
+    std::string body;
+    for (const auto& e : entries) body += std::to_string(e.second) + "\t" + e.first + "\n";
+    body += std::to_string(total) + "\t.\n";
+    res.set_header("Cache-Control", "no-cache");
+    res.set_content(body, "text/plain; charset=utf-8");
+    return true;
+}
+
+// Pace `n` received upload bytes through --limit-upload.
+inline void throttle_inbound(const httplib::Request& req, std::size_t n) {
+    if (g_inbound.enabled()) g_inbound.acquire(req.remote_addr, n);
+}
+
+
+// ANSI color support
+inline bool supports_color() {
+#ifdef _WIN32
+    // Enable Virtual Terminal Processing (VT) if possible
+    HANDLE hOut = GetStdHandle(STD_OUTPUT_HANDLE);
+    if (hOut == INVALID_HANDLE_VALUE) return false;
+
+    DWORD mode = 0;
+    if (!GetConsoleMode(hOut, &mode)) {
+        // Not a console (redirected) OR very old console host -> no color
+        return false;
+    }
+
+    DWORD newMode = mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING;
+    if (!SetConsoleMode(hOut, newMode)) {
+        // Classic cmd.exe (without VT) will fail here -> no color
+        return false;
+    }
+    return true;
+#else
+    // Respect NO_COLOR spec and avoid coloring when not a TTY or in "dumb" term
+    if (std::getenv("NO_COLOR")) return false;
+#include <unistd.h>
+    if (!isatty(STDOUT_FILENO)) return false;
+    const char* term = std::getenv("TERM");
+    if (!term || std::string(term) == "dumb") return false;
+    return true;
+#endif
+}
+
+inline std::string colorize_blue(const std::string& s) {
+    static const char* BLUE = "\x1b[34m";
+    static const char* RESET = "\x1b[0m";
+    return std::string(BLUE) + s + RESET;
+}
+inline std::string colorize_green(const std::string& s) {
+    static const char* GREEN = "\x1b[32m";
+    static const char* RESET = "\x1b[0m";
+    return std::string(GREEN) + s + RESET;
+}
+inline std::string colorize_yellow(const std::string& s) {
+    static const char* YELLOW = "\x1b[33m";
+    static const char* RESET = "\x1b[0m";
+    return std::string(YELLOW) + s + RESET;
+}
+
+
+
+//Logo
+inline std::string make_startup_logo() {
+    std::string ver = VERSION;
+    if (!ver.empty() && (ver[0] == 'v' || ver[0] == 'V')) {
+        ver.erase(0, 1);
+    }
+
+    std::ostringstream s;
+    s <<
+        R"(
+ _____     _   _ _ _     _        
+|  _  |___| |_| | | |___| |_
+|     |  _|  _| | | | -_| . |
+|__|__|_| |_| |_____|___|___| 
+)";
+    return s.str();
+}
+
+
+inline std::string make_startup_footer() {
+    std::string ver = VERSION;                // e.g., "v2.1"
+    if (!ver.empty() && (ver[0] == 'v' || ver[0] == 'V')) ver.erase(0, 1);
+
+    std::ostringstream s;
+    s << "ArtWeb by @art3x      ver " << ver << "\n"
+        << "https://github.com/art3x\n\n";
+    return s.str();
+}
+
+inline void print_logo() {
+    std::string logo = make_startup_logo();
+    std::string footer = make_startup_footer();
+
+    if (supports_color()) {
+        logo = colorize_green(logo);
+        footer = colorize_blue(footer);
+    }
+
+#ifdef _WIN32
+    std::wcout << utf8_to_wstring(logo);
+    std::wcout << utf8_to_wstring(footer);
+#else
+    std::cout << logo << footer;
+#endif
+}
+
+
+#ifdef _WIN32
+inline std::wstring to_lower(std::wstring s) {
+    std::transform(s.begin(), s.end(), s.begin(),
+        [](wchar_t c) { return std::towlower(c); });
+    return s;
+}
+
+inline bool starts_with_icase(const std::wstring& s, const std::wstring& pref) {
+    if (s.size() < pref.size()) return false;
+    auto sl = to_lower(s);
+    auto pl = to_lower(pref);
+    return std::equal(pl.begin(), pl.end(), sl.begin());
+}
+
+inline bool contains_icase(const std::wstring& s, const std::wstring& needle) {
+    auto sl = to_lower(s);
+    auto nl = to_lower(needle);
+    return sl.find(nl) != std::wstring::npos;
+}
+#endif
+
+
+inline void print_ipv4_list_after_logo() {
+#ifdef _WIN32
+    // Enumerate adapters (IPv4 only)
+    ULONG flags = GAA_FLAG_SKIP_ANYCAST | GAA_FLAG_SKIP_MULTICAST | GAA_FLAG_SKIP_DNS_SERVER;
+    ULONG fam = AF_UNSPEC; // we'll filter per unicast addr
+    ULONG sz = 0;
+    if (GetAdaptersAddresses(fam, flags, nullptr, nullptr, &sz) != ERROR_BUFFER_OVERFLOW || sz == 0) {
+        return;
+    }
+    std::vector<unsigned char> buf(sz);
+    IP_ADAPTER_ADDRESSES* addrs = reinterpret_cast<IP_ADAPTER_ADDRESSES*>(buf.data());
+    if (GetAdaptersAddresses(fam, flags, nullptr, addrs, &sz) != NO_ERROR) {
+        return;
+    }
+
+    // Collect (name, ip) pairs, filtered by interface name
+    std::vector<std::pair<std::wstring, std::wstring>> entries;
+
+    for (auto* a = addrs; a; a = a->Next) {
+        if (a->OperStatus != IfOperStatusUp) continue;
+
+        std::wstring name = a->FriendlyName ? a->FriendlyName : L"";
+        if (name.empty()) continue;
+
+        // Filter: Linux-like prefixes + common Windows equivalents
+        bool match =
+            starts_with_icase(name, L"eth") ||
+            starts_with_icase(name, L"ens") ||
+            starts_with_icase(name, L"tun") ||
+            starts_with_icase(name, L"ethernet") ||
+            starts_with_icase(name, L"vEthernet") ||
+            contains_icase(name, L"Wi-Fi") ||
+            contains_icase(name, L"TAP") ||
+            contains_icase(name, L"TUN") ||
+            contains_icase(name, L"WireGuard") ||
+            contains_icase(name, L"OpenVPN");
+
+        if (!match) continue;
+
+        for (auto* ua = a->FirstUnicastAddress; ua; ua = ua->Next) {
+            if (!ua->Address.lpSockaddr) continue;
+            if (ua->Address.lpSockaddr->sa_family != AF_INET) continue;
+
+            auto* sin = reinterpret_cast<sockaddr_in*>(ua->Address.lpSockaddr);
+            wchar_t ipw[64] = L"";
+            if (InetNtopW(AF_INET, &sin->sin_addr, ipw, 64)) {
+                entries.emplace_back(name, std::wstring(ipw));
+            }
+        }
+    }
+
+    std::sort(entries.begin(), entries.end());
+    std::wostringstream oss;
+    if (!entries.empty()) {
+        oss << L"Listening on:\n";
+        for (auto& e : entries) {
+            oss << L"  " << e.first << L": " << e.second << L"\n";
+        }
+    }
+    else {
+        oss << L"Listening on: can't find any\n";
+    }
+
+    std::wstring out = oss.str();
+
+    // Optional: colorize blue if VT is enabled
+    if (supports_color()) {
+        std::wcout << L"\x1b[33m" << out << L"\x1b[0m";
+    }
+    else {
+        std::wcout << out;
+    }
+
+
+#else
+    // POSIX: use getifaddrs for eth*/ens*/tun*
+    ifaddrs* ifaddr = nullptr;
+    if (getifaddrs(&ifaddr) != 0 || !ifaddr) return;
+
+    std::vector<std::pair<std::string, std::string>> entries;
+
+    for (ifaddrs* ifa = ifaddr; ifa; ifa = ifa->ifa_next) {
+        if (!ifa || !ifa->ifa_name || !ifa->ifa_addr) continue;
+        if (!(ifa->ifa_flags & IFF_UP)) continue;
+        if (ifa->ifa_addr->sa_family != AF_INET) continue;
+
+        std::string name = ifa->ifa_name;
+        if (!(name.rfind("eth", 0) == 0 || name.rfind("ens", 0) == 0 || name.rfind("tun", 0) == 0)) {
+            continue;
+        }
+
+        char buf[INET_ADDRSTRLEN] = { 0 };
+        auto* sin = reinterpret_cast<sockaddr_in*>(ifa->ifa_addr);
+        if (inet_ntop(AF_INET, &sin->sin_addr, buf, sizeof(buf))) {
+            entries.emplace_back(name, std::string(buf));
+        }
+    }
+    freeifaddrs(ifaddr);
+
+    std::sort(entries.begin(), entries.end());
+
+    std::ostringstream oss;
+    if (!entries.empty()) {
+        oss << "Listening on:\n";
+        for (auto& e : entries) {
+            oss << "  " << e.first << ": " << e.second << "\n";
+        }
+    }
+    else {
+        oss << "Listening on: can't find any\n";
+    }
+
+    std::string out = oss.str();
+    if (supports_color()) out = colorize_yellow(out);
+    std::cout << out;
+#endif
+}
+
+
+
+// Help/usage
+void print_usage(const char* progname) {
+#ifdef _WIN32
+    std::wstring wprogname = utf8_to_wstring(std::string(progname));
+    std::wcout << L"Usage: " << wprogname << L" [options]\n"
+        << L"Options:\n"
+        << L"  -h, --help               Print this help message\n"
+        << L"  -p, --port PORT          Set the port (default: 80 for HTTP, 443 for HTTPS)\n"
+        << L"  -i, --index DIR_PATH     Serve static files from a directory. `index.html` is the default page.\n"
+        << L"  --embedded               Serve the site compiled into this binary (ARTWEB_EMBED builds); -i is the fallback\n"
+        << L"  --embed-gen DIR HEADER   Generate the embedded site header from DIR and exit\n"
+        << L"  --bundle FILE            Serve a site bundle (memory-mapped, built with --bundle-build)\n"
+        << L"  --bundle-build DIR FILE  Pack DIR into a site bundle file and exit\n"
+        << L"  --pass PASSWORD          Enable HTTP Basic authentication (username is 'admin')\n"
+        << L"  --proxy                  Use proxy-safe (chunked) uploads (slower, but proxy friendly)\n"
+        << L"  --unlim                  Unlimited upload size (more than 1 Gb)\n"
+        << L"  --dedup DIR              Store uploads by SHA-256 in DIR and link duplicates (same filesystem)\n"
+        << L"  --file-cache N           Cache up to N open files / lookups, incl. misses (default: 1/4 of the fd limit, max 1024; 0 = off)\n"
+        << L"  --file-cache-ttl SEC     Lifetime of file cache entries in seconds (default: 5)\n"
+        << L"  --mime-types FILE        Extra MIME types (mime.types format), checked before the built-in table\n"
+        << L"  --workers N              Worker threads for interactive requests (default: CPU threads - 1, at least 8)\n"
+        << L"  --bulk-workers N         Concurrent large transfers, run outside those workers (default: 8, 0 = off)\n"
+        << L"  --bulk-threshold MB      Transfers from this size on count as large (default: 8)\n"
+        << L"  --limit-rate RATE        Cap total download bandwidth, shared fairly between clients (e.g. 50M)\n"
+        << L"  --limit-rate-ip RATE     Cap download bandwidth per client IP\n"
+        << L"  --limit-rate-conn RATE   Cap bandwidth of each single download\n"
+        << L"  --limit-upload RATE      Cap total upload bandwidth\n"
+        << L"  --rate-weight IP=W       Bandwidth share of IP relative to others (default: 1, repeatable)\n"
+        << L"  --io-engine sync|uring   File I/O for downloads and uploads (default: sync; uring on Linux 5.6+)\n"
+        << L"  --readahead MB           Read ahead of large downloads (default: 8, 0 = kernel default)\n"
+        << L"  --max-followers N        Concurrent ?follow=1 streams of growing files (default: 16, 0 = off)\n"
+        << L"  --line-index DIR         Keep the line indexes behind ?lines=A-B in DIR across restarts\n"
+        << L"  --grep-timeout S         Time limit for ?grep= searches of a directory (default: 30, 0 = off)\n"
+        << L"  --tree-index             Keep an inotify-updated in-memory index of the tree for listings, ?find= and ?du=1\n"
+        << L"  --direct-io MB           Write uploads from this size on with O_DIRECT, bypassing the page cache (default: 0 = off)\n"
+        << L"  --mime-gen SRC HEADER    Regenerate the built-in MIME table from a mime.types file and exit\n"
+        << L"  --delta-upload FILE URL  Update the file at URL to FILE's content, sending only changed blocks, and exit\n"
+        << L"  --metrics PATH           Serve Prometheus metrics on PATH (e.g. /metrics)\n"
+        << L"  --metrics-port PORT      Serve Prometheus metrics on a separate port (path: --metrics or /metrics; HTTPS with --ssl)\n"
+        << L"  -s, --ssl                Enable HTTPS mode\n"
+        << L"  -c, --cert CERT_PATH     Path to SSL certificate file (required for --ssl)\n"
+        << L"  -k, --key KEY_PATH       Path to SSL private key file (required for --ssl)\n";
+#else
+    std::cout << "Usage: " << progname << " [options]\n"
+        << "Options:\n"
+        << "  -h, --help               Print this help message\n"
+        << "  -p, --port PORT          Set the port (default: 80 for HTTP, 443 for HTTPS)\n"
+        << "  -i, --index DIR_PATH     Serve static files from a directory. `index.html` is the default page.\n"
+        << "  --embedded               Serve the site compiled into this binary (ARTWEB_EMBED builds); -i is the fallback\n"
+        << "  --embed-gen DIR HEADER   Generate the embedded site header from DIR and exit\n"
+        << "  --bundle FILE            Serve a site bundle (memory-mapped, built with --bundle-build)\n"
+        << "  --bundle-build DIR FILE  Pack DIR into a site bundle file and exit\n"
+        << "  --pass PASSWORD          Enable HTTP Basic authentication (username is 'admin')\n"
+        << "  --proxy                  Use proxy-safe (chunked) uploads (slower, but proxy friendly)\n"
+        << "  --unlim                  Unlimited upload size (more than 1 Gb)\n"
+        << "  --dedup DIR              Store uploads by SHA-256 in DIR and link duplicates (same filesystem)\n"
+        << "  --file-cache N           Cache up to N open files / lookups, incl. misses (default: 1/4 of the fd limit, max 1024; 0 = off)\n"
+        << "  --file-cache-ttl SEC     Lifetime of file cache entries in seconds (default: 5)\n"
+        << "  --mime-types FILE        Extra MIME types (mime.types format), checked before the built-in table\n"
+        << "  --workers N              Worker threads for interactive requests (default: CPU threads - 1, at least 8)\n"
+        << "  --bulk-workers N         Concurrent large transfers, run outside those workers (default: 8, 0 = off)\n"
+        << "  --bulk-threshold MB      Transfers from this size on count as large (default: 8)\n"
+        << "  --limit-rate RATE        Cap total download bandwidth, shared fairly between clients (e.g. 50M)\n"
+        << "  --limit-rate-ip RATE     Cap download bandwidth per client IP\n"
+        << "  --limit-rate-conn RATE   Cap bandwidth of each single download\n"
+        << "  --limit-upload RATE      Cap total upload bandwidth\n"
+        << "  --rate-weight IP=W       Bandwidth share of IP relative to others (default: 1, repeatable)\n"
+        << "  --io-engine sync|uring   File I/O for downloads and uploads (default: sync; uring on Linux 5.6+)\n"
+        << "  --readahead MB           Read ahead of large downloads (default: 8, 0 = kernel default)\n"
+        << "  --max-followers N        Concurrent ?follow=1 streams of growing files (default: 16, 0 = off)\n"
+        << "  --line-index DIR         Keep the line indexes behind ?lines=A-B in DIR across restarts\n"
+        << "  --grep-timeout S         Time limit for ?grep= searches of a directory (default: 30, 0 = off)\n"
+        << "  --tree-index             Keep an inotify-updated in-memory index of the tree for listings, ?find= and ?du=1\n"
+        << "  --direct-io MB           Write uploads from this size on with O_DIRECT, bypassing the page cache (default: 0 = off)\n"
+        << "  --mime-gen SRC HEADER    Regenerate the built-in MIME table from a mime.types file and exit\n"
+        << "  --delta-upload FILE URL  Update the file at URL to FILE's content, sending only changed blocks, and exit\n"
+        << "  --metrics PATH           Serve Prometheus metrics on PATH (e.g. /metrics)\n"
+        << "  --metrics-port PORT      Serve Prometheus metrics on a separate port (path: --metrics or /metrics; HTTPS with --ssl)\n"
+        << "  -s, --ssl                Enable HTTPS mode\n"
+        << "  -c, --cert CERT_PATH     Path to SSL certificate file (required for --ssl)\n"
+        << "  -k, --key KEY_PATH       Path to SSL private key file (required for --ssl)\n";
+#endif
+}
+
+// HTTP Basic Auth check
+bool authenticate(const httplib::Request& req, httplib::Response& res) {
+    if (!require_auth) return true;
+    auto auth = req.get_header_value("Authorization");
+    if (auth != g_expected_auth_header) {
+        res.status = 401;
+        res.set_header("WWW-Authenticate", "Basic realm=\"User Visible Realm\"");
+        res.set_content("Unauthorized", "text/plain");
+        return false;
+    }
+    return true;
+}
+
+// Resolve an upload target directory below the root.
+// Existing directories go through resolve_beneath(); missing ones (created on
+// demand by the upload) fall back to the canonical-prefix check.
+bool resolve_upload_dir(const std::string& dir, fs::path& target) {
+    ResolvedFile resolved;
+    switch (resolve_beneath(g_root, dir, resolved)) {
+    case ResolveStatus::Ok:
+        if (!resolved.is_dir) return false;
+        target = resolved.path;
+        return true;
+    case ResolveStatus::NotFound: {
+        std::error_code ec;
+        target = fs::weakly_canonical(g_root.path / fs::u8path(dir), ec);
+        return !ec && target.string().rfind(g_root.canonical, 0) == 0;
+    }
+    default:
+        return false;
+    }
+}
+
+// --- Upload write pipeline ---
+// The connection thread only receives: it copies the body into 1 MB buffers
+// and hands them to the writer thread of the target's device, which does the
+// disk writes. At most UploadPipeline::kDepth buffers per upload are queued,
+// so a slow disk pushes back on the socket (and over TCP on the client)
+// instead of growing memory, and a slow client never stalls the disk.
+
+// One writer thread per device; jobs run in order, so each upload's buffers
+// reach the file in sequence.
+class DiskWriter {
+public:
+    using Job = std::function<void()>;
+
+    void post(Job job) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            jobs_.push_back(std::move(job));
+        }
+        cv_.notify_one();
+    }
+
+    // Writer for the device holding `dir`, started on first use.
+    static DiskWriter& for_directory(const fs::path& dir) {
+        static std::mutex registry_mutex;
+        // Never destroyed: the detached writer threads wait on their DiskWriter until exit.
+        static auto* writers = new std::map<std::string, std::unique_ptr<DiskWriter>>();
+#ifndef _WIN32
+        struct stat st {};
+        const std::string device = stat(dir.c_str(), &st) == 0 ? std::to_string(st.st_dev) : std::string();
+#else
+        const std::string device = dir.root_name().string();
+#endif
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        auto& writer = (*writers)[device];
+        if (!writer) writer.reset(new DiskWriter());
+        return *writer;
+    }
+
+private:
+    DiskWriter() {
+        // Lives as long as the process, like the server itself.
+        std::thread([this] { run(); }).detach();
+    }
+
+    void run() {
+        for (;;) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this] { return !jobs_.empty(); });
+                job = std::move(jobs_.front());
+                jobs_.pop_front();
+            }
+            job();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<Job> jobs_;
+};
+
+// Double/ring buffering between one upload's connection thread and its disk writer.
+class UploadPipeline {
+public:
+    static constexpr unsigned kDepth = 4;
+    static constexpr std::size_t kBufferSize = 1024 * 1024;
+
+    UploadPipeline(UploadFile& file, std::uint64_t offset, DiskWriter& writer)
+        : file_(file), offset_(offset), writer_(writer), state_(std::make_shared<State>()) {}
+    UploadPipeline(const UploadPipeline&) = delete;
+    UploadPipeline& operator=(const UploadPipeline&) = delete;
+    ~UploadPipeline() { wait_idle(); } // queued jobs point at file_
+
+    // Append received bytes; false once a disk write has failed.
+    bool write(const char* data, std::size_t n) {
+        while (n > 0) {
+            if (current_.capacity() == 0 && !take_buffer()) return false;
+            const std::size_t len = std::min(n, kBufferSize - current_.size());
+            current_.insert(current_.end(), data, data + len);
+            data += len;
+            n -= len;
+            if (current_.size() == kBufferSize && !submit()) return false;
+        }
+        return true;
+    }
+
+    // Queue the partial last buffer and wait for the writer; true if every write succeeded.
+    bool finish() {
+        if (!current_.empty() && !submit()) return false;
+        wait_idle();
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        return !state_->failed;
+    }
+
+private:
+    struct State {
+        std::mutex mutex;
+        std::condition_variable cv;
+        unsigned in_flight = 0;
+        bool failed = false;
+        std::vector<std::vector<char>> spare;
+    };
+
+    // Reuse a buffer the writer has finished with, waiting while kDepth are queued.
+    bool take_buffer() {
+        std::unique_lock<std::mutex> lock(state_->mutex);
+        state_->cv.wait(lock, [this] { return state_->in_flight < kDepth || state_->failed; });
+        if (state_->failed) return false;
+        if (!state_->spare.empty()) {
+            current_ = std::move(state_->spare.back());
+            state_->spare.pop_back();
+            current_.clear();
+        }
+        current_.reserve(kBufferSize);
+        return true;
+    }
+
+    bool submit() {
+        std::shared_ptr<State> state = state_;
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if (state->failed) return false;
+            ++state->in_flight;
+        }
+        UploadFile* file = &file_;
+        const std::uint64_t offset = offset_;
+        offset_ += current_.size();
+        auto buffer = std::make_shared<std::vector<char>>(std::move(current_));
+        current_ = std::vector<char>();
+        writer_.post([state, file, offset, buffer] {
+            bool skip;
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                skip = state->failed;
+            }
+            const bool ok = skip || file->write_at(buffer->data(), buffer->size(), offset);
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if (!ok) state->failed = true;
+            state->spare.push_back(std::move(*buffer));
+            --state->in_flight;
+            state->cv.notify_all();
+        });
+        return true;
+    }
+
+    void wait_idle() {
+        std::unique_lock<std::mutex> lock(state_->mutex);
+        state_->cv.wait(lock, [this] { return state_->in_flight == 0; });
+    }
+
+    UploadFile& file_;
+    std::uint64_t offset_;
+    DiskWriter& writer_;
+    std::shared_ptr<State> state_;
+    std::vector<char> current_;   // being filled by the connection thread
+};
+
+// --- Upload digests ---
+// Uploads are hashed with SHA-256 while they arrive, so clients don't have to
+// read multi-GB files back to verify them. The digest is returned with the
+// response, stored with the file as a user xattr (where supported; always in
+// the digest cache) and checked against ?sha256=<hex> if given. There is no
+// sidecar file, which would show up in listings, ?find= and ?grep=.
+
+// Hash the first `n` bytes of a file; false if it is shorter or unreadable.
+bool hash_file_prefix(const fs::path& path, std::uint64_t n, Sha256& out) {
+    std::ifstream in(path, std::ios::binary);
+    std::vector<char> buf(1024 * 1024);
+    while (n > 0 && in) {
+        in.read(buf.data(), static_cast<std::streamsize>(std::min<std::uint64_t>(n, buf.size())));
+        const std::size_t got = static_cast<std::size_t>(in.gcount());
+        if (got == 0) break;
+        out.update(buf.data(), got);
+        n -= got;
+    }
+    return n == 0;
+}
+
+const char* const UPLOAD_DIGEST_XATTR = "user.artweb.sha256";
+
+// Keep the hex digest with the uploaded file (best effort).
+void store_upload_digest([[maybe_unused]] const fs::path& file, [[maybe_unused]] const std::string& hex) {
+#ifdef __linux__
+    setxattr(file.c_str(), UPLOAD_DIGEST_XATTR, hex.data(), hex.size(), 0);
+#endif
+}
+
+// The file's content was replaced: a stored digest no longer applies.
+void forget_upload_digest([[maybe_unused]] const fs::path& file) {
+#ifdef __linux__
+    removexattr(file.c_str(), UPLOAD_DIGEST_XATTR);
+#endif
+}
+
+// Hash state of chunked uploads between their requests, keyed by .part path.
+// Lost state (restart, eviction) is rebuilt by hashing the part file so far.
+class ChunkHashStore {
+public:
+    // Hash of the part's first `offset` bytes, for a chunk starting there.
+    Sha256 resume(const fs::path& part, std::uint64_t offset) {
+        if (offset == 0) return Sha256();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = states_.find(part.string());
+            if (it != states_.end() && it->second.offset == offset) return it->second.hash;
+        }
+        Sha256 hash;
+        hash_file_prefix(part, offset, hash);
+        return hash;
+    }
+
+    void save(const fs::path& part, std::uint64_t offset, const Sha256& hash) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const std::string key = part.string();
+        if (states_.size() >= kMaxEntries && states_.find(key) == states_.end()) {
+            auto oldest = std::min_element(states_.begin(), states_.end(),
+                [](const auto& a, const auto& b) { return a.second.tick < b.second.tick; });
+            states_.erase(oldest);
+        }
+        Entry& e = states_[key];
+        e.hash = hash;
+        e.offset = offset;
+        e.tick = ++tick_;
+    }
+
+    void forget(const fs::path& part) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        states_.erase(part.string());
+    }
+
+private:
+    static constexpr std::size_t kMaxEntries = 1024;
+    struct Entry {
+        Sha256 hash;
+        std::uint64_t offset = 0;
+        std::uint64_t tick = 0;
+    };
+    std::mutex mutex_;
+    std::unordered_map<std::string, Entry> states_;
+    std::uint64_t tick_ = 0;
+};
+
+ChunkHashStore g_chunk_hashes;
+
+// --- Deduplicating upload store (--dedup DIR) ---
+// Uploaded content is filed under DIR/<first 2 hex digits>/<sha256>. A later
+// upload of the same bytes is replaced by a link to the stored copy, and
+// clients that know the digest can ask for the link up front (/upload_link)
+// instead of sending the data at all. Links are reflinks (copy-on-write
+// clones): never hard links, since a shared inode would let an in-place write
+// to one file change the blob and every other file made from it.
+// Where reflinks are unsupported, storing a copy would only cost disk and
+// writes. The store then keeps a reference instead (<sha256>.ref: the identity
+// and path of the uploaded file), and /upload_link copies from that file as
+// long as it is unchanged. DIR should be on the same filesystem as the served root.
+class DedupStore {
+public:
+    bool enabled() const { return !dir_.empty(); }
+
+    bool open(const fs::path& dir) {
+        std::error_code ec;
+        fs::create_directories(dir, ec);
+        if (!fs::is_directory(dir, ec)) return false;
+        dir_ = fs::absolute(dir, ec);
+        return !ec;
+    }
+
+    fs::path blob_path(const std::string& hex) const { return dir_ / hex.substr(0, 2) / hex; }
+
+    bool has(const std::string& hex) const {
+        std::error_code ec;
+        if (fs::is_regular_file(blob_path(hex), ec)) return true;
+        fs::path source;
+        return referenced(hex, source);
+    }
+
+    // Create `target` (which must not exist) with the stored content of `hex`.
+    bool link_to(const std::string& hex, const fs::path& target) const {
+        const fs::path blob = blob_path(hex);
+        if (clone(blob, target) || copy(blob, target)) return true;
+        fs::path source;
+        std::string identity;
+        if (!referenced(hex, source, &identity) || !copy(source, target)) return false;
+        // The source may have been written to while it was copied.
+        std::string after;
+        if (file_identity_of(source, after) && after == identity) return true;
+        std::error_code ec;
+        fs::remove(target, ec);
+        return false;
+    }
+
+    // A finished upload: point it at identical stored content, or store it.
+    void adopt(const fs::path& file, const std::string& hex) {
+        const fs::path blob = blob_path(hex);
+        std::error_code ec;
+        if (fs::is_regular_file(blob, ec)) {
+            // Same content already stored: share its extents.
+            const fs::path tmp = temp_name(file);
+            if (!clone(blob, tmp)) return;
+            const std::uintmax_t size = fs::file_size(file, ec);
+            fs::rename(tmp, file, ec);
+            if (ec) {
+                fs::remove(tmp, ec);
+                return;
+            }
+            saved_bytes.fetch_add(size, std::memory_order_relaxed);
+            return;
+        }
+
+        // Filed under a temporary name first, so has() never sees a partial blob.
+        fs::create_directories(blob.parent_path(), ec);
+        const fs::path tmp = temp_name(blob);
+        if (clone(file, tmp)) {
+            fs::rename(tmp, blob, ec);
+            if (ec) fs::remove(tmp, ec);
+            return;
+        }
+        fs::path source;
+        if (referenced(hex, source)) return; // an earlier upload holds the content
+        std::string identity;
+        if (!file_identity_of(file, identity)) return;
+        {
+            std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+            out << identity << '\n' << file.lexically_normal().u8string() << '\n';
+            if (!out) {
+                out.close();
+                fs::remove(tmp, ec);
+                return;
+            }
+        }
+        fs::path ref = blob;
+        ref += ".ref";
+        fs::rename(tmp, ref, ec);
+        if (ec) fs::remove(tmp, ec);
+    }
+
+    std::atomic<std::uint64_t> saved_bytes{ 0 };
+
+private:
+    // The file a reference names, when it still has the recorded identity.
+    bool referenced(const std::string& hex, fs::path& source, std::string* identity = nullptr) const {
+        fs::path ref = blob_path(hex);
+        ref += ".ref";
+        std::ifstream in(ref, std::ios::binary);
+        std::string recorded, path, current;
+        if (!std::getline(in, recorded) || !std::getline(in, path)) return false;
+        source = fs::u8path(path);
+        if (!file_identity_of(source, current) || current != recorded) return false;
+        if (identity) *identity = recorded;
+        return true;
+    }
+
+    // A name next to `path` that no other adopt() uses at the same time.
+    static fs::path temp_name(const fs::path& path) {
+        static std::atomic<unsigned> seq{ 0 };
+        fs::path tmp = path;
+        tmp += ".dedup-" + std::to_string(std::time(nullptr)) + "-" + std::to_string(seq.fetch_add(1));
+        return tmp;
+    }
+
+    // Reflink `from` to a new file `to`; false (and no `to`) where unsupported.
+    static bool clone([[maybe_unused]] const fs::path& from, [[maybe_unused]] const fs::path& to) {
+#if defined(__linux__) && defined(FICLONE)
+        const int src = ::open(from.c_str(), O_RDONLY | O_CLOEXEC);
+        if (src < 0) return false;
+        const int dst = ::open(to.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666);
+        bool cloned = false;
+        if (dst >= 0) {
+            cloned = ioctl(dst, FICLONE, src) == 0;
+            ::close(dst);
+            if (!cloned) ::unlink(to.c_str());
+        }
+        ::close(src);
+        return cloned;
+#else
+        return false;
+#endif
+    }
+
+    static bool copy(const fs::path& from, const fs::path& to) {
+        std::error_code ec;
+        if (fs::copy_file(from, to, ec)) return true;
+        if (ec != std::errc::file_exists) fs::remove(to, ec); // drop a partial copy
+        return false;
+    }
+
+    fs::path dir_;
+};
+
+DedupStore g_dedup;
+
+// Query parameters of an /upload request; chunked uploads carry their state here.
+struct UploadParams {
+    bool chunked = false;
+    std::string upload_id;
+    std::size_t chunk_index = 0;
+    std::size_t total_chunks = 0;
+    std::size_t offset = 0;
+    std::size_t declared_file_size = 0;
+    fs::path target_dir;          // canonical, inside the root
+    std::string expected_sha256;  // ?sha256=, lowercase hex; empty if not sent
+};
+
+// Validate the query string before any body byte is read; on failure the response is filled in.
+bool parse_upload_params(const httplib::Request& req, httplib::Response& res, UploadParams& p) {
+    // Proxy uploads can be slow/fragile; support chunked uploads where the browser
+    // sends many small multipart requests and we append them server-side.
+    p.chunked =
+        req.has_param("upload_id") &&
+        req.has_param("chunk_index") &&
+        req.has_param("total_chunks") &&
+        req.has_param("offset") &&
+        req.has_param("file_size");
+
+    if (p.chunked) {
+        try {
+            p.upload_id = req.get_param_value("upload_id");
+            p.chunk_index = static_cast<std::size_t>(std::stoull(req.get_param_value("chunk_index")));
+            p.total_chunks = static_cast<std::size_t>(std::stoull(req.get_param_value("total_chunks")));
+            p.offset = static_cast<std::size_t>(std::stoull(req.get_param_value("offset")));
+            p.declared_file_size = static_cast<std::size_t>(std::stoull(req.get_param_value("file_size")));
+        }
+        catch (...) {
+            res.status = 400;
+            res.set_content("Invalid chunk parameters", "text/plain");
+            return false;
+        }
+
+        if (p.upload_id.empty() || p.upload_id.size() > 64 ||
+            std::any_of(p.upload_id.begin(), p.upload_id.end(), [](unsigned char c) {
+                return !(std::isalnum(c) || c == '_' || c == '-');
+                })) {
+            res.status = 400;
+            res.set_content("Invalid upload_id", "text/plain");
+            return false;
+        }
+
+        if (!g_unlimited_upload && p.declared_file_size > MAX_UPLOAD_SIZE) {
+            res.status = 413;
+            res.set_content("Uploaded file is too large", "text/plain");
+            return false;
+        }
+
+        if (p.total_chunks == 0 || p.chunk_index >= p.total_chunks) {
+            res.status = 400;
+            res.set_content("Invalid chunk range", "text/plain");
+            return false;
+        }
+
+        if (p.offset > p.declared_file_size) {
+            res.status = 400;
+            res.set_content("Invalid offset", "text/plain");
+            return false;
+        }
+    }
+
+    if (req.has_param("sha256")) {
+        p.expected_sha256 = req.get_param_value("sha256");
+        std::transform(p.expected_sha256.begin(), p.expected_sha256.end(), p.expected_sha256.begin(),
+            [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        if (p.expected_sha256.size() != 64 ||
+            p.expected_sha256.find_first_not_of("0123456789abcdef") != std::string::npos) {
+            res.status = 400;
+            res.set_content("Invalid sha256 (expected 64 hex digits)", "text/plain");
+            return false;
+        }
+    }
+
+    std::string targetDirStr = ".";
+    if (req.has_param("dir")) {
+        targetDirStr = req.get_param_value("dir");
+    }
+
+    if (!resolve_upload_dir(targetDirStr, p.target_dir)) {
+        res.status = 403;
+        res.set_content("Forbidden: Invalid target directory.", "text/plain");
+        return false;
+    }
+    return true;
+}
+
+// Only one request at a time may append to a given chunked upload.
+class ChunkPartClaim {
+public:
+    bool claim(const std::string& key) {
+        std::lock_guard<std::mutex> lock(mutex());
+        if (!active().insert(key).second) return false;
+        key_ = key;
+        return true;
+    }
+    ~ChunkPartClaim() {
+        if (key_.empty()) return;
+        std::lock_guard<std::mutex> lock(mutex());
+        active().erase(key_);
+    }
+
+private:
+    static std::mutex& mutex() { static std::mutex m; return m; }
+    static std::set<std::string>& active() { static std::set<std::string> s; return s; }
+    std::string key_;
+};
+
+// Receives the "file" part of one /upload request and streams it to disk.
+struct UploadReceiver {
+    UploadParams params;
+    int error_status = 0;
+    std::string error;
+
+    bool started = false;        // the "file" part has begun
+    bool receiving = false;      // current part is the file
+    fs::path full_path;          // final name
+    fs::path write_path;         // file being written: full_path, or the .part file of a chunked upload
+    bool opened = false;         // write_path is ours to clean up on failure
+    std::uint64_t size_hint = 0; // Content-Length: upper bound for a single upload (multipart overhead included)
+    std::uint64_t received = 0;
+    Sha256 hash;                 // of the whole file so far (earlier chunks included)
+    UploadFile out;
+    std::unique_ptr<UploadPipeline> pipeline;
+    ChunkPartClaim claim;
+
+    bool fail(int status, const std::string& msg) {
+        if (error_status == 0) {
+            error_status = status;
+            error = msg;
+        }
+        return false;
+    }
+
+    // A new multipart part: set up the target when it is the first "file" part.
+    bool begin(const httplib::MultipartFormData& part) {
+        receiving = false;
+        if (part.name != "file" || started) return true;
+        started = true;
+        if (part.filename.empty()) return fail(400, "No file uploaded");
+
+        std::string safeFilename = fs::path(part.filename).filename().string();
+        if (safeFilename.empty()) return fail(400, "Invalid file name");
+
+        full_path = params.target_dir / fs::u8path(safeFilename);
+
+        // Check for file overwrite.
+        if (fs::exists(full_path)) return fail(409, "File with this name already exists");
+
+        // Before creating the directory, ensure the parent path is still safe.
+        // This is a defense-in-depth check.
+        if (full_path.parent_path().string().rfind(g_root.canonical, 0) != 0) {
+            return fail(403, "Forbidden: Cannot create directory in this location.");
+        }
+
+        std::uint64_t total = 0;
+        if (params.chunked) {
+            // Write chunks to a temporary file and rename on completion.
+            write_path = full_path;
+            write_path += "." + params.upload_id + ".part";
+            fs::create_directories(full_path.parent_path());
+            if (!claim.claim(write_path.string())) return fail(409, "Chunk upload already in progress");
+
+            // Enforce in-order chunks: current part file size must match declared offset.
+            std::error_code ec;
+            const bool part_exists = fs::exists(write_path, ec);
+            const std::uintmax_t current_size = part_exists ? fs::file_size(write_path, ec) : 0;
+            if (ec) return fail(500, "Failed to query upload state");
+            if (params.chunk_index == 0 && params.offset != 0) return fail(400, "Invalid offset for first chunk");
+            if (params.chunk_index != 0 && !part_exists) return fail(409, "Missing initial chunk");
+            if (static_cast<std::uintmax_t>(params.offset) != current_size) return fail(409, "Unexpected chunk offset");
+
+            if (!out.open(write_path, params.chunk_index == 0)) return fail(500, "Failed to save chunk");
+            total = params.declared_file_size;
+            opened = true;
+            hash = g_chunk_hashes.resume(write_path, params.offset);
+        }
+        else {
+            write_path = full_path;
+            if (!out.open(write_path, true)) {
+                // Attempt to create the directory if it doesn't exist.
+                fs::create_directories(full_path.parent_path());
+                if (!out.open(write_path, true)) return fail(500, "Failed to save file"); // Try again
+            }
+            total = size_hint;
+            opened = true;
+        }
+        out.prepare(params.offset, total);
+        pipeline.reset(new UploadPipeline(out, params.offset, DiskWriter::for_directory(full_path.parent_path())));
+        receiving = true;
+        return true;
+    }
+
+    bool feed(const char* data, std::size_t len) {
+        if (!receiving) return true;
+        received += len;
+        if (!g_unlimited_upload && !params.chunked && received > MAX_UPLOAD_SIZE) {
+            return fail(413, "Uploaded file is too large");
+        }
+        hash.update(data, len);
+        if (!pipeline->write(data, len)) {
+            return fail(500, params.chunked ? "Failed to write chunk" : "Failed to save file");
+        }
+        return true;
+    }
+
+    // Body done (or aborted): drain the pipeline and build the response.
+    void finish(httplib::Response& res, bool body_complete) {
+        if (error_status == 0 && !body_complete) fail(400, "Upload interrupted");
+        if (error_status == 0 && !started) fail(400, "No file uploaded");
+
+        const bool written = pipeline && pipeline->finish();
+        pipeline.reset();
+        // Only a chunk with more to come keeps the rest of the file reserved.
+        if (error_status != 0 || !written || !params.chunked || params.chunk_index + 1 == params.total_chunks) out.trim();
+        const bool closed = out.close();
+        if (error_status == 0 && (!written || !closed)) {
+            fail(500, params.chunked ? "Failed to write chunk" : "Failed to save file");
+        }
+
+        if (error_status != 0) {
+            discard();
+            res.status = error_status;
+            res.set_content(error, "text/plain");
+            return;
+        }
+
+        if (params.chunked && params.chunk_index + 1 != params.total_chunks) {
+            g_chunk_hashes.save(write_path, params.offset + received, hash);
+            res.set_content("Chunk uploaded", "text/plain");
+            return;
+        }
+
+        if (params.chunked) {
+            g_chunk_hashes.forget(write_path);
+            // Best-effort sanity check: final size should match declared file size.
+            std::error_code ec2;
+            const auto final_part_size = fs::file_size(write_path, ec2);
+            if (!ec2 && final_part_size != params.declared_file_size) {
+                res.status = 500;
+                res.set_content("Final size mismatch", "text/plain");
+                return;
+            }
+        }
+
+        const std::string digest = hash.digest();
+        const std::string hex = to_hex(digest);
+        if (!params.expected_sha256.empty() && hex != params.expected_sha256) {
+            std::error_code ec;
+            fs::remove(write_path, ec);
+            res.status = 422;
+            res.set_content("SHA-256 mismatch: expected " + params.expected_sha256 + ", received " + hex, "text/plain");
+            return;
+        }
+
+        if (params.chunked) {
+            std::error_code ec3;
+            fs::rename(write_path, full_path, ec3);
+            if (ec3) {
+                res.status = (fs::exists(full_path) ? 409 : 500);
+                res.set_content("Failed to finalize upload", "text/plain");
+                return;
+            }
+        }
+        if (g_dedup.enabled()) g_dedup.adopt(full_path, hex);
+        store_upload_digest(full_path, hex);
+        std::string identity;
+        if (file_identity_of(full_path, identity)) g_digests.store(identity, DigestAlgo::Sha256, digest);
+        file_cache_clear();
+        res.set_header("Repr-Digest", repr_digest_sha256(digest));
+        res.set_content("File uploaded successfully\nsha256: " + hex, "text/plain");
+    }
+
+    // Undo a failed write: drop a partial file, or cut a .part file back to
+    // where this chunk started so the client can retry it.
+    void discard() {
+        if (!opened) return;
+        std::error_code ec;
+        if (params.chunked) fs::resize_file(write_path, params.offset, ec);
+        else fs::remove(write_path, ec);
+    }
+};
+
+// File Upload Handler: POST /upload?dir=...[&upload_id=..&chunk_index=..&total_chunks=..&offset=..&file_size=..]
+// with a multipart "file" part. The part is written while it is received.
+void upload_handler(const httplib::Request& req, httplib::Response& res, const httplib::ContentReader& content_reader) {
+    if (!authenticate(req, res)) return;
+
+    if (!req.is_multipart_form_data()) {
+        res.status = 400;
+        res.set_content("No file uploaded", "text/plain");
+        return;
+    }
+
+    UploadReceiver upload;
+    if (!parse_upload_params(req, res, upload.params)) return;
+    upload.size_hint = req.get_header_value_u64("Content-Length");
+
+    const bool complete = content_reader(
+        [&](const httplib::MultipartFormData& part) { return upload.begin(part); },
+        [&](const char* data, size_t len) {
+            throttle_inbound(req, len);
+            // Returning false aborts the transfer; the error is reported by finish().
+            return upload.feed(data, len);
+        });
+    upload.finish(res, complete);
+}
+
+// POST /upload_link?sha256=HEX[&dir=DIR&name=NAME] (with --dedup): create DIR/NAME
+// from stored content instead of uploading it again. 404 means "not stored,
+// upload it". Without a name, only answers whether the content is stored.
+void upload_link_handler(const httplib::Request& req, httplib::Response& res) {
+    if (!authenticate(req, res)) return;
+
+    if (!g_dedup.enabled()) {
+        res.status = 404;
+        res.set_content("Deduplication is not enabled", "text/plain");
+        return;
+    }
+
+    UploadParams params;
+    if (!parse_upload_params(req, res, params)) return;
+    const std::string& hex = params.expected_sha256;
+    if (hex.empty()) {
+        res.status = 400;
+        res.set_content("Missing sha256", "text/plain");
+        return;
+    }
+    if (!g_dedup.has(hex)) {
+        res.status = 404;
+        res.set_content("Content not in store", "text/plain");
+        return;
+    }
+    if (!req.has_param("name")) {
+        res.set_content("Content in store", "text/plain");
+        return;
+    }
+
+    std::string safeFilename = fs::u8path(req.get_param_value("name")).filename().u8string();
+    if (safeFilename.empty() || safeFilename == "." || safeFilename == "..") {
+        res.status = 400;
+        res.set_content("Invalid file name", "text/plain");
+        return;
+    }
+
+    fs::path fullPath = params.target_dir / fs::u8path(safeFilename);
+    if (fs::exists(fullPath)) {
+        res.status = 409; // Conflict
+        res.set_content("File with this name already exists", "text/plain");
+        return;
+    }
+    if (fullPath.parent_path().string().rfind(g_root.canonical, 0) != 0) {
+        res.status = 403;
+        res.set_content("Forbidden: Cannot create directory in this location.", "text/plain");
+        return;
+    }
+    std::error_code ec;
+    fs::create_directories(fullPath.parent_path(), ec);
+    if (!g_dedup.link_to(hex, fullPath)) {
+        res.status = 500;
+        res.set_content("Failed to link file", "text/plain");
+        return;
+    }
+    store_upload_digest(fullPath, hex);
+    std::string identity;
+    if (file_identity_of(fullPath, identity)) g_digests.store(identity, DigestAlgo::Sha256, from_hex(hex));
+    g_dedup.saved_bytes.fetch_add(fs::file_size(fullPath, ec), std::memory_order_relaxed);
+    file_cache_clear();
+    res.set_content("File linked from store\nsha256: " + hex, "text/plain");
+}
+
+// ------------------------ Delta uploads ------------------------
+// rsync-style updates of large files. GET /path?signatures=1[&block=N] lists a
+// weak rolling checksum and a strong hash for every block of the current file;
+// the client finds those blocks in its new version and sends
+// POST /upload_delta?path=PATH&size=N[&sha256=HEX] (If-Match: the signatures'
+// ETag) with a script of copy and data operations, little-endian:
+//   'C' u64 offset u64 length    copy bytes of the current file
+//   'D' u64 length, bytes        new bytes
+// The new version is assembled in a temporary file next to the target (copied
+// ranges through copy_file_range, so filesystems that can share extents do)
+// and renamed over it. `ArtWeb --delta-upload FILE URL` is the reference client.
+
+constexpr std::size_t DELTA_DEFAULT_BLOCK = 64 * 1024;
+constexpr std::size_t DELTA_MIN_BLOCK = 1024;
+constexpr std::size_t DELTA_MAX_BLOCK = DIGEST_SEGMENT;   // powers of two in between divide a segment
+constexpr std::size_t DELTA_STRONG_LEN = 16;              // truncated SHA-256
+constexpr std::uint64_t DELTA_MAX_SIGNATURES = 65536;     // blocks listed per file, below DELTA_MAX_BLOCK
+
+// rsync's weak checksum: a = sum of the bytes, b = sum of the running sums (mod 2^16 each).
+class RollingChecksum {
+public:
+    void reset(const unsigned char* p, std::size_t n) {
+        a_ = b_ = 0;
+        n_ = static_cast<std::uint32_t>(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            a_ += p[i];
+            b_ += static_cast<std::uint32_t>(n - i) * p[i];
+        }
+    }
+
+    // Slide the window one byte: `out` leaves at the front, `in` enters at the back.
+    void roll(unsigned char out, unsigned char in) {
+        a_ += in - static_cast<std::uint32_t>(out);
+        b_ += a_ - n_ * out;
+    }
+
+    std::uint32_t value() const { return (a_ & 0xFFFF) | (b_ << 16); }
+
+private:
+    std::uint32_t a_ = 0, b_ = 0, n_ = 0;
+};
+
+std::string delta_strong_hash(const char* data, std::size_t n) {
+    Sha256 hash;
+    hash.update(data, n);
+    return hash.digest().substr(0, DELTA_STRONG_LEN);
+}
+
+// The ETag answer_from_metadata() gives the file.
+bool delta_etag_matches(const ResolvedFile& file, const std::string& etag) {
+    return etag == make_etag(static_cast<std::uint64_t>(file.mtime), file.size);
+}
+
+// GET /path?signatures=1[&block=N]: "artweb-signatures BLOCK SIZE", then one
+// "<weak hex8> <strong hex32>" line per block (the last one may be short).
+// Returns false when the query asks for something else.
+bool answer_signature_query(const httplib::Request& req, httplib::Response& res, const ResolvedFile& file) {
+    if (!req.has_param("signatures")) return false;
+    std::size_t block = DELTA_DEFAULT_BLOCK;
+    if (req.has_param("block")) {
+        try { block = static_cast<std::size_t>(std::stoull(req.get_param_value("block"))); }
+        catch (...) { block = 0; }
+        if (block < DELTA_MIN_BLOCK || block > DELTA_MAX_BLOCK || (block & (block - 1)) != 0) {
+            res.status = 400;
+            res.set_content("Invalid block size (power of two, 1024 to 4194304)", "text/plain");
+            return true;
+        }
+    }
+    // The list is built in memory: larger files get larger blocks (the client
+    // takes the block size from the first line).
+    while (block < DELTA_MAX_BLOCK && file.size / block >= DELTA_MAX_SIGNATURES) block *= 2;
+
+    const std::size_t segments = static_cast<std::size_t>((file.size + DIGEST_SEGMENT - 1) / DIGEST_SEGMENT);
+    std::vector<std::string> lines(segments);
+    const bool ok = for_each_segment(segments, [&](std::size_t i, std::vector<char>& buf) {
+        const std::uint64_t offset = static_cast<std::uint64_t>(i) * DIGEST_SEGMENT;
+        const std::size_t want = static_cast<std::size_t>(std::min<std::uint64_t>(DIGEST_SEGMENT, file.size - offset));
+        if (SegmentReader(file).read(buf.data(), want, offset) != want) return false;
+        std::string& out = lines[i];
+        out.reserve((want / block + 1) * 42);
+        for (std::size_t pos = 0; pos < want; pos += block) {
+            const std::size_t n = std::min(block, want - pos);
+            RollingChecksum weak;
+            weak.reset(reinterpret_cast<const unsigned char*>(buf.data()) + pos, n);
+            char hex[16];
+            std::snprintf(hex, sizeof(hex), "%08x ", static_cast<unsigned>(weak.value()));
+            out += hex;
+            out += to_hex(delta_strong_hash(buf.data() + pos, n));
+            out += '\n';
+        }
+        return true;
+    });
+    if (!ok) {
+        res.status = 500;
+        res.set_content("Could not read file", "text/plain");
+        return true;
+    }
+
+    std::string body = "artweb-signatures " + std::to_string(block) + " " + std::to_string(file.size) + "\n";
+    for (const auto& part : lines) body += part;
+    res.set_header("ETag", make_etag(static_cast<std::uint64_t>(file.mtime), file.size));
+    res.set_header("Cache-Control", "no-cache");
+    res.set_content(body, "text/plain");
+    return true;
+}
+
+#ifndef _WIN32
+// Copy n bytes between descriptors at explicit offsets, in the kernel where possible.
+bool copy_file_bytes(int in_fd, std::uint64_t in_off, int out_fd, std::uint64_t out_off, std::uint64_t n) {
+#ifdef __linux__
+    while (n > 0) {
+        loff_t in_pos = static_cast<loff_t>(in_off), out_pos = static_cast<loff_t>(out_off);
+        const ssize_t r = copy_file_range(in_fd, &in_pos, out_fd, &out_pos, static_cast<std::size_t>(std::min<std::uint64_t>(n, 1u << 30)), 0);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) break; // EXDEV/ENOSYS/EINVAL..., or EOF: finish with pread/pwrite
+        in_off += static_cast<std::uint64_t>(r);
+        out_off += static_cast<std::uint64_t>(r);
+        n -= static_cast<std::uint64_t>(r);
+    }
+#endif
+    std::vector<char> buf(static_cast<std::size_t>(std::min<std::uint64_t>(n, 1024 * 1024)));
+    while (n > 0) {
+        const std::size_t want = static_cast<std::size_t>(std::min<std::uint64_t>(n, buf.size()));
+        if (pread_full(in_fd, buf.data(), want, in_off) != want) return false;
+        if (!pwrite_full(out_fd, buf.data(), want, out_off)) return false;
+        in_off += want;
+        out_off += want;
+        n -= want;
+    }
+    return true;
+}
+#endif
+
+// Applies a delta script to a base file, writing the result to a temporary file.
+class DeltaAssembler {
+public:
+    int error_status = 0;
+    std::string error;
+    std::uint64_t copied = 0;     // bytes taken from the base file
+    std::uint64_t received = 0;   // new bytes sent by the client
+    fs::path temp_path;
+
+    DeltaAssembler(const ResolvedFile& base, std::uint64_t final_size) : base_(base), final_size_(final_size) {}
+    DeltaAssembler(const DeltaAssembler&) = delete;
+    DeltaAssembler& operator=(const DeltaAssembler&) = delete;
+    ~DeltaAssembler() { close(); }
+
+    bool open(const fs::path& target) {
+        static std::atomic<unsigned> seq{ 0 };
+        temp_path = target.parent_path() / fs::u8path("." + target.filename().u8string() + ".delta-" +
+            std::to_string(std::time(nullptr)) + "-" + std::to_string(seq.fetch_add(1)));
+#ifndef _WIN32
+        struct stat st;
+        const mode_t mode = fstat(base_.fd(), &st) == 0 ? (st.st_mode & 07777) : 0644;
+        fd_ = ::open(temp_path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, mode);
+        if (fd_ < 0) return fail(500, "Failed to create temporary file");
+#ifdef __linux__
+        if (final_size_ > 0) fallocate(fd_, FALLOC_FL_KEEP_SIZE, 0, static_cast<off_t>(final_size_));
+#endif
+#else
+        in_.open(base_.path, std::ios::binary);
+        out_.open(temp_path, std::ios::binary | std::ios::trunc);
+        if (!in_ || !out_) return fail(500, "Failed to create temporary file");
+#endif
+        return true;
+    }
+
+    // Parse and apply the next piece of the script; false stops the transfer.
+    bool feed(const char* data, std::size_t n) {
+        while (n > 0) {
+            if (literal_left_ > 0) {
+                const std::size_t take = static_cast<std::size_t>(std::min<std::uint64_t>(n, literal_left_));
+                if (!write(data, take)) return false;
+                received += take;
+                literal_left_ -= take;
+                data += take;
+                n -= take;
+                continue;
+            }
+            const std::size_t need = header_len();
+            const std::size_t take = std::min(n, need - header_size_);
+            std::memcpy(header_ + header_size_, data, take);
+            header_size_ += take;
+            data += take;
+            n -= take;
+            if (header_size_ == need && !apply_header()) return false;
+        }
+        return true;
+    }
+
+    // The whole script arrived: check that it was complete and produced `final_size` bytes.
+    bool finish() {
+        if (error_status != 0) return false;
+        if (header_size_ != 0 || literal_left_ != 0) return fail(400, "Truncated delta script");
+        if (written_ != final_size_) return fail(400, "Delta result has " + std::to_string(written_) + " bytes, expected " + std::to_string(final_size_));
+        return close() || fail(500, "Failed to write file");
+    }
+
+    void discard() {
+        close();
+        std::error_code ec;
+        if (!temp_path.empty()) fs::remove(temp_path, ec);
+    }
+
+private:
+    static std::uint64_t read_u64(const unsigned char* p) {
+        std::uint64_t v = 0;
+        for (int i = 7; i >= 0; --i) v = (v << 8) | p[i];
+        return v;
+    }
+
+    std::size_t header_len() const {
+        if (header_size_ == 0) return 1;
+        return header_[0] == 'C' ? 17 : 9;
+    }
+
+    bool apply_header() {
+        const unsigned char op = header_[0];
+        if (op != 'C' && op != 'D') return fail(400, "Invalid delta operation");
+        if (header_size_ == 1) return true; // operands follow
+        header_size_ = 0;
+        const std::uint64_t a = read_u64(header_ + 1);
+        if (op == 'D') {
+            if (a > final_size_ - written_) return fail(400, "Delta result larger than declared size");
+            literal_left_ = a;
+            return true;
+        }
+        const std::uint64_t len = read_u64(header_ + 9);
+        if (a > base_.size || len > base_.size - a) return fail(400, "Copy outside the current file");
+        if (len > final_size_ - written_) return fail(400, "Delta result larger than declared size");
+        if (!copy(a, len)) return fail(500, "Failed to copy from the current file");
+        copied += len;
+        return true;
+    }
+
+    bool write(const char* data, std::size_t n) {
+#ifndef _WIN32
+        if (!pwrite_full(fd_, data, n, written_)) return fail(500, "Failed to write file");
+#else
+        if (!out_.write(data, static_cast<std::streamsize>(n))) return fail(500, "Failed to write file");
+#endif
+        written_ += n;
+        return true;
+    }
+
+    bool copy(std::uint64_t offset, std::uint64_t len) {
+#ifndef _WIN32
+        if (!copy_file_bytes(base_.fd(), offset, fd_, written_, len)) return false;
+        written_ += len;
+        return true;
+#else
+        std::vector<char> buf(static_cast<std::size_t>(std::min<std::uint64_t>(len, 1024 * 1024)));
+        in_.clear();
+        in_.seekg(static_cast<std::streamoff>(offset));
+        while (len > 0) {
+            const std::size_t want = static_cast<std::size_t>(std::min<std::uint64_t>(len, buf.size()));
+            if (!in_.read(buf.data(), static_cast<std::streamsize>(want)) || !write(buf.data(), want)) return false;
+            len -= want;
+        }
+        return true;
+#endif
+    }
+
+    bool close() {
+#ifndef _WIN32
+        if (fd_ < 0) return true;
+        const bool ok = ::close(fd_) == 0;
+        fd_ = -1;
+        return ok;
+#else
+        in_.close();
+        if (!out_.is_open()) return true;
+        out_.close();
+        return !out_.fail();
+#endif
+    }
+
+    bool fail(int status, const std::string& message) {
+        if (error_status == 0) {
+            error_status = status;
+            error = message;
+        }
+        return false;
+    }
+
+    const ResolvedFile& base_;
+    std::uint64_t final_size_;
+    std::uint64_t written_ = 0;
+    std::uint64_t literal_left_ = 0;
+    unsigned char header_[17] = {};
+    std::size_t header_size_ = 0;
+#ifndef _WIN32
+    int fd_ = -1;
+#else
+    std::ifstream in_;
+    std::ofstream out_;
+#endif
+};
+
+// True when a request path has a ".." component ("a..b" is a valid name).
+bool has_parent_component(const std::string& rel) {
+    std::size_t start = 0;
+    for (;;) {
+        const std::size_t end = rel.find_first_of("/\\", start);
+        if (rel.compare(start, end == std::string::npos ? std::string::npos : end - start, "..") == 0) return true;
+        if (end == std::string::npos) return false;
+        start = end + 1;
+    }
+}
+
+// POST /upload_delta?path=PATH&size=N[&sha256=HEX] with If-Match and the delta
+// script as the raw body: replace PATH with the assembled new version.
+void upload_delta_handler(const httplib::Request& req, httplib::Response& res, const httplib::ContentReader& content_reader) {
+    if (!authenticate(req, res)) return;
+
+    if (req.is_multipart_form_data()) {
+        res.status = 400;
+        res.set_content("Send the delta script as the raw request body", "text/plain");
+        return;
+    }
+    const std::string rel = req.get_param_value("path");
+    std::uint64_t final_size = 0;
+    try { final_size = std::stoull(req.get_param_value("size")); }
+    catch (...) {
+        res.status = 400;
+        res.set_content("Missing or invalid size", "text/plain");
+        return;
+    }
+    if (!g_unlimited_upload && final_size > MAX_UPLOAD_SIZE) {
+        res.status = 413;
+        res.set_content("Uploaded file is too large", "text/plain");
+        return;
+    }
+    std::string expected;
+    if (req.has_param("sha256")) {
+        expected = req.get_param_value("sha256");
+        std::transform(expected.begin(), expected.end(), expected.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        if (expected.size() != 64 || expected.find_first_not_of("0123456789abcdef") != std::string::npos) {
+            res.status = 400;
+            res.set_content("Invalid sha256 (expected 64 hex digits)", "text/plain");
+            return;
+        }
+    }
+    if (rel.empty() || has_parent_component(rel) || fs::u8path(rel).is_absolute()) {
+        res.status = 400;
+        res.set_content("Invalid path", "text/plain");
+        return;
+    }
+
+    ResolvedFile base;
+    const auto status = resolve_beneath(g_root, rel, base);
+    if (status == ResolveStatus::NotFound || (status == ResolveStatus::Ok && !base.is_regular)) {
+        res.status = 404;
+        res.set_content("Not found (upload new files with /upload)", "text/plain");
+        return;
+    }
+    if (status != ResolveStatus::Ok) {
+        res.status = 403;
+        res.set_content("Access denied", "text/plain");
+        return;
+    }
+    if (!delta_etag_matches(base, req.get_header_value("If-Match"))) {
+        res.status = 412;
+        res.set_content("File changed since its signatures were taken", "text/plain");
+        return;
+    }
+
+    DeltaAssembler delta(base, final_size);
+    const bool complete = delta.open(base.path) && content_reader([&](const char* data, size_t len) {
+        throttle_inbound(req, len);
+        // Returning false aborts the transfer; the error is reported below.
+        return delta.feed(data, len);
+        });
+    if (!complete && delta.error_status == 0) {
+        delta.discard();
+        res.status = 400;
+        res.set_content("Delta upload interrupted", "text/plain");
+        return;
+    }
+    if (!delta.finish()) {
+        delta.discard();
+        res.status = delta.error_status;
+        res.set_content(delta.error, "text/plain");
+        return;
+    }
+
+    std::string digest;
+    if (!expected.empty()) {
+        Sha256 hash;
+        hash_file_prefix(delta.temp_path, final_size, hash);
+        digest = hash.digest();
+        if (to_hex(digest) != expected) {
+            delta.discard();
+            res.status = 422;
+            res.set_content("SHA-256 mismatch: expected " + expected + ", received " + to_hex(digest), "text/plain");
+            return;
+        }
+    }
+
+    // Re-check just before replacing: another writer may have changed the file meanwhile.
+    ResolvedFile current;
+    if (resolve_beneath(g_root, rel, current) != ResolveStatus::Ok || file_identity(current) != file_identity(base)) {
+        delta.discard();
+        res.status = 412;
+        res.set_content("File changed while the delta was uploaded", "text/plain");
+        return;
+    }
+    std::error_code ec;
+    fs::rename(delta.temp_path, base.path, ec);
+    if (ec) {
+        delta.discard();
+        res.status = 500;
+        res.set_content("Failed to replace file", "text/plain");
+        return;
+    }
+
+    forget_upload_digest(base.path);
+    if (!digest.empty()) {
+        store_upload_digest(base.path, expected);
+        std::string identity;
+        if (file_identity_of(base.path, identity)) g_digests.store(identity, DigestAlgo::Sha256, digest);
+        res.set_header("Repr-Digest", repr_digest_sha256(digest));
+    }
+    file_cache_clear();
+    res.set_content("File updated: " + std::to_string(delta.copied) + " bytes reused, " +
+        std::to_string(delta.received) + " bytes received", "text/plain");
+}
+
+// ArtWeb --delta-upload FILE URL: reference client for the protocol above.
+// URL is the file on the server: http[s]://[admin:PASSWORD@]host[:port]/path.
+// The script is built in a temporary file (matching FILE against the
+// signatures with the rolling checksum), then posted in one request.
+int run_delta_upload(const std::string& local, const std::string& url) {
+    const std::size_t scheme_end = url.find("://");
+    const std::size_t path_start = scheme_end == std::string::npos ? std::string::npos : url.find('/', scheme_end + 3);
+    if (path_start == std::string::npos || path_start + 1 == url.size()) {
+        std::cerr << "Error: --delta-upload needs a file URL, e.g. http://host:8080/dir/file.img" << std::endl;
+        return 1;
+    }
+    std::string authority = url.substr(scheme_end + 3, path_start - scheme_end - 3);
+    std::string user, password;
+    const std::size_t at = authority.rfind('@');
+    if (at != std::string::npos) {
+        const std::string userinfo = url_decode(authority.substr(0, at));
+        authority = authority.substr(at + 1);
+        const std::size_t colon = userinfo.find(':');
+        user = userinfo.substr(0, colon);
+        if (colon != std::string::npos) password = userinfo.substr(colon + 1);
+    }
+    const std::string url_path = url.substr(path_start);
+    httplib::Client client(url.substr(0, scheme_end + 3) + authority);
+    client.set_read_timeout(3600, 0); // the server hashes large files before answering
+    if (!user.empty()) client.set_basic_auth(user, password);
+
+    std::ifstream in(fs::u8path(local), std::ios::binary);
+    if (!in) {
+        std::cerr << "Error: cannot read " << local << std::endl;
+        return 1;
+    }
+
+    // --- Signatures of the server's version ---
+    auto sig = client.Get(url_path + "?signatures=1");
+    if (!sig || sig->status != 200) {
+        std::cerr << "Error: could not get signatures: " << (sig ? std::to_string(sig->status) + " " + sig->body : httplib::to_string(sig.error())) << std::endl;
+        return 1;
+    }
+    std::istringstream lines(sig->body);
+    std::string magic;
+    std::size_t block = 0;
+    std::uint64_t remote_size = 0;
+    lines >> magic >> block >> remote_size;
+    if (magic != "artweb-signatures" || block == 0) {
+        std::cerr << "Error: unexpected signature format" << std::endl;
+        return 1;
+    }
+    std::vector<std::string> strong;
+    std::unordered_multimap<std::uint32_t, std::size_t> weak_index; // full blocks only
+    std::string weak_hex, strong_hex;
+    while (lines >> weak_hex >> strong_hex) {
+        const std::size_t index = strong.size();
+        strong.push_back(from_hex(strong_hex));
+        if (static_cast<std::uint64_t>(index + 1) * block <= remote_size) {
+            weak_index.emplace(static_cast<std::uint32_t>(std::stoul(weak_hex, nullptr, 16)), index);
+        }
+    }
+    const std::size_t tail_len = static_cast<std::size_t>(remote_size % block);
+
+    // --- Build the script ---
+    std::FILE* script = std::tmpfile();
+    if (!script) {
+        std::cerr << "Error: cannot create a temporary file" << std::endl;
+        return 1;
+    }
+    std::uint64_t script_size = 0, reused = 0, literal = 0;
+    std::uint64_t copy_from = 0, copy_len = 0; // pending copy, merged while contiguous
+    auto put_op = [&](char op, std::uint64_t a, std::uint64_t b, bool two) {
+        unsigned char rec[17];
+        rec[0] = static_cast<unsigned char>(op);
+        for (int i = 0; i < 8; ++i) rec[1 + i] = static_cast<unsigned char>(a >> (8 * i));
+        for (int i = 0; i < 8; ++i) rec[9 + i] = static_cast<unsigned char>(b >> (8 * i));
+        const std::size_t n = two ? 17 : 9;
+        std::fwrite(rec, 1, n, script);
+        script_size += n;
+    };
+    auto flush_copy = [&] {
+        if (copy_len == 0) return;
+        put_op('C', copy_from, copy_len, true);
+        reused += copy_len;
+        copy_len = 0;
+    };
+    auto emit_copy = [&](std::uint64_t from, std::uint64_t len) {
+        if (copy_len > 0 && copy_from + copy_len == from) { copy_len += len; return; }
+        flush_copy();
+        copy_from = from;
+        copy_len = len;
+    };
+    auto emit_data = [&](const char* p, std::size_t n) {
+        if (n == 0) return;
+        flush_copy();
+        put_op('D', n, 0, false);
+        std::fwrite(p, 1, n, script);
+        script_size += n;
+        literal += n;
+    };
+
+    Sha256 whole;
+    std::uint64_t local_size = 0;
+    std::vector<char> buf;
+    std::size_t len = 0, pos = 0, lit = 0; // buffered bytes, window start, pending literal start
+    bool eof = false;
+    auto fill = [&] {
+        if (eof || len - pos > block) return;
+        if (lit > 0) {   // drop what has been emitted already
+            std::memmove(buf.data(), buf.data() + lit, len - lit);
+            len -= lit;
+            pos -= lit;
+            lit = 0;
+        }
+        const std::size_t want = 8u << 20;
+        if (buf.size() < len + want) buf.resize(len + want);
+        in.read(buf.data() + len, static_cast<std::streamsize>(want));
+        const std::size_t got = static_cast<std::size_t>(in.gcount());
+        whole.update(buf.data() + len, got);
+        local_size += got;
+        len += got;
+        if (got < want) eof = true;
+    };
+
+    RollingChecksum weak;
+    bool weak_valid = false;
+    for (;;) {
+        fill();
+        if (len - pos < block) break;
+        const unsigned char* window = reinterpret_cast<const unsigned char*>(buf.data()) + pos;
+        if (!weak_valid) { weak.reset(window, block); weak_valid = true; }
+        std::size_t match = std::string::npos;
+        auto range = weak_index.equal_range(weak.value());
+        if (range.first != range.second) {
+            const std::string hash = delta_strong_hash(buf.data() + pos, block);
+            for (auto it = range.first; it != range.second && match == std::string::npos; ++it) {
+                if (strong[it->second] == hash) match = it->second;
+            }
+        }
+        if (match != std::string::npos) {
+            emit_data(buf.data() + lit, pos - lit);
+            emit_copy(static_cast<std::uint64_t>(match) * block, block);
+            pos += block;
+            lit = pos;
+            weak_valid = false;
+            continue;
+        }
+        if (len - pos > block) weak.roll(window[0], window[block]);
+        else weak_valid = false;
+        ++pos;
+        if (pos - lit >= (1u << 20)) {   // keep literal runs (and the buffer) bounded
+            emit_data(buf.data() + lit, pos - lit);
+            lit = pos;
+        }
+    }
+    // The server's short last block can only match our tail.
+    if (tail_len > 0 && len - pos == tail_len && !strong.empty() &&
+        delta_strong_hash(buf.data() + pos, tail_len) == strong.back()) {
+        emit_data(buf.data() + lit, pos - lit);
+        emit_copy(remote_size - tail_len, tail_len);
+        lit = pos = len;
+    }
+    emit_data(buf.data() + lit, len - lit);
+    flush_copy();
+    if (std::fflush(script) != 0 || !in.eof()) {
+        std::cerr << "Error: failed to build the delta script" << std::endl;
+        std::fclose(script);
+        return 1;
+    }
+    std::rewind(script);
+    std::cout << "Reusing " << reused << " bytes, sending " << literal << " of " << local_size << " bytes ("
+        << script_size << " with the script)" << std::endl;
+
+    // --- Post it ---
+    httplib::Headers headers = { { "If-Match", sig->get_header_value("ETag") } };
+    const std::string target = httplib::append_query_params("/upload_delta", {
+        { "path", url_decode(url_path.substr(1)) },
+        { "size", std::to_string(local_size) },
+        { "sha256", to_hex(whole.digest()) } });
+    auto result = client.Post(target, headers, static_cast<std::size_t>(script_size),
+        [&](size_t, size_t length, httplib::DataSink& sink) {
+            char chunk[64 * 1024];
+            const std::size_t got = std::fread(chunk, 1, std::min(length, sizeof(chunk)), script);
+            return got > 0 && sink.write(chunk, got);
+        }, "application/octet-stream");
+    std::fclose(script);
+    if (!result) {
+        std::cerr << "Error: upload failed: " << httplib::to_string(result.error()) << std::endl;
+        return 1;
+    }
+    std::cout << result->status << " " << result->body << std::endl;
+    return result->status == 200 ? 0 : 1;
+}
+
+// ------------------------ Server-side copy and move ------------------------
+// POST /copy?from=SRC&to=DST and POST /move?from=SRC&to=DST (root-relative
+// paths; files or whole directory trees), optionally &overwrite=1 to replace
+// an existing file. Moves are a rename; copies, and moves across filesystems,
+// clone each file with FICLONE where the filesystem can share extents, else
+// copy it in the kernel with copy_file_range. Copies are built under a
+// temporary name in the destination directory and renamed into place, so an
+// interrupted copy never leaves a half-written DST. With &progress=1 the
+// answer is streamed: "progress DONE TOTAL" lines, then "done ..." or "error ...".
+
+// Copies files and trees, reporting the bytes done so far.
+class TreeCopier {
+public:
+    std::uint64_t total_bytes = 0;
+    std::uint64_t done_bytes = 0;
+    std::uint64_t cloned_bytes = 0;  // shared with the source by a reflink
+    std::uint64_t files = 0;
+    std::uint64_t skipped = 0;       // symlinks and special files inside trees
+    std::string error;
+    std::function<bool()> on_progress; // called between pieces; false cancels
+
+    // Sum up what copying `src` will move.
+    void plan(const fs::path& src) {
+        std::error_code ec;
+        if (!fs::is_directory(fs::symlink_status(src, ec))) {
+            total_bytes = fs::file_size(src, ec);
+            return;
+        }
+        for (auto it = fs::recursive_directory_iterator(src, ec); !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+            if (it->is_regular_file(ec) && !it->is_symlink(ec)) total_bytes += it->file_size(ec);
+        }
+    }
+
+    // Copy `src` (file or directory) to `dst`, which must not exist.
+    bool copy(const fs::path& src, const fs::path& dst) {
+        std::error_code ec;
+        if (!fs::is_directory(fs::symlink_status(src, ec))) return copy_file(src, dst);
+        if (!fs::create_directory(dst, ec)) return fail("Failed to create " + dst.filename().u8string());
+        for (auto it = fs::recursive_directory_iterator(src, ec); it != fs::recursive_directory_iterator(); it.increment(ec)) {
+            if (ec) return fail("Failed to read " + src.filename().u8string());
+            const fs::path target = dst / fs::relative(it->path(), src, ec);
+            const auto st = it->symlink_status(ec);
+            if (fs::is_directory(st)) {
+                if (!fs::create_directory(target, ec)) return fail("Failed to create " + target.filename().u8string());
+            }
+            else if (fs::is_regular_file(st)) {
+                if (!copy_file(it->path(), target)) return false;
+            }
+            else {
+                ++skipped; // symlinks may point outside the root; devices, sockets...
+            }
+        }
+        return true;
+    }
+
+private:
+    static constexpr std::uint64_t kPiece = 8ull << 20;
+
+    bool fail(const std::string& message) {
+        if (error.empty()) error = message;
+        return false;
+    }
+
+    bool report() {
+        if (on_progress && !on_progress()) return fail("Cancelled");
+        return true;
+    }
+
+    bool copy_file(const fs::path& src, const fs::path& dst) {
+        ++files;
+#ifndef _WIN32
+        const int in = ::open(src.c_str(), O_RDONLY | O_CLOEXEC);
+        if (in < 0) return fail("Failed to open " + src.filename().u8string());
+        struct stat st;
+        if (fstat(in, &st) != 0) {
+            ::close(in);
+            return fail("Failed to open " + src.filename().u8string());
+        }
+        const int out = ::open(dst.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, st.st_mode & 07777);
+        if (out < 0) {
+            ::close(in);
+            return fail("Failed to create " + dst.filename().u8string());
+        }
+        const std::uint64_t size = static_cast<std::uint64_t>(st.st_size);
+        bool ok = true;
+#if defined(__linux__) && defined(FICLONE)
+        if (size > 0 && ioctl(out, FICLONE, in) == 0) {
+            done_bytes += size;
+            cloned_bytes += size;
+            ok = report();
+        }
+        else
+#endif
+        {
+            for (std::uint64_t offset = 0; ok && offset < size; offset += kPiece) {
+                const std::uint64_t n = std::min(kPiece, size - offset);
+                if (!copy_file_bytes(in, offset, out, offset, n)) ok = fail("Failed to copy " + src.filename().u8string());
+                else {
+                    done_bytes += n;
+                    ok = report();
+                }
+            }
+        }
+        ::close(in);
+        if (::close(out) != 0 && ok) ok = fail("Failed to write " + dst.filename().u8string());
+        return ok;
+#else
+        std::error_code ec;
+        if (!fs::copy_file(src, dst, ec)) return fail("Failed to copy " + src.filename().u8string());
+        done_bytes += fs::file_size(dst, ec);
+        return report();
+#endif
+    }
+};
+
+// Validated source and destination of a /copy or /move request.
+struct FileOpTarget {
+    fs::path from;       // existing file or directory inside the root
+    fs::path to;         // destination path inside the root
+    bool from_is_dir = false;
+    bool replace = false; // `to` is an existing file that may be replaced
+};
+
+// Checks shared by /copy and /move; answers the request and returns false on error.
+bool parse_file_op(const httplib::Request& req, httplib::Response& res, FileOpTarget& op) {
+    auto reject = [&](int status, const char* message) {
+        res.status = status;
+        res.set_content(message, "text/plain");
+        return false;
+    };
+    const std::string from = req.get_param_value("from");
+    const std::string to = req.get_param_value("to");
+    for (const std::string* p : { &from, &to }) {
+        if (p->empty() || has_parent_component(*p) || fs::u8path(*p).is_absolute()) {
+            return reject(400, "Invalid path (from and to are paths below the root)");
+        }
+    }
+
+    ResolvedFile source;
+    switch (resolve_beneath(g_root, from, source)) {
+    case ResolveStatus::Ok: break;
+    case ResolveStatus::NotFound: return reject(404, "Not found");
+    default: return reject(403, "Access denied");
+    }
+    if (!source.is_dir && !source.is_regular) return reject(400, "Only files and directories can be copied or moved");
+    std::error_code ec;
+    if (fs::equivalent(source.path, g_root.path, ec)) return reject(400, "Cannot copy or move the root");
+
+    const fs::path to_path = fs::u8path(to);
+    const std::string name = to_path.filename().u8string();
+    if (name.empty() || name == "." || name == "..") return reject(400, "Invalid destination name");
+    fs::path parent;
+    const std::string parent_rel = to_path.parent_path().u8string();
+    if (!resolve_upload_dir(parent_rel.empty() ? "." : parent_rel, parent)) {
+        return reject(403, "Forbidden: Invalid target directory.");
+    }
+
+    op.from = source.path;
+    op.to = parent / fs::u8path(name);
+    op.from_is_dir = source.is_dir;
+
+    // A tree cannot go into itself.
+    const std::string from_str = fs::weakly_canonical(op.from, ec).string();
+    const std::string to_str = fs::weakly_canonical(op.to, ec).string();
+    if (to_str == from_str) return reject(400, "Source and destination are the same");
+    if (op.from_is_dir && to_str.rfind(from_str + static_cast<char>(fs::path::preferred_separator), 0) == 0) {
+        return reject(400, "Cannot copy or move a directory into itself");
+    }
+
+    const auto existing = fs::symlink_status(op.to, ec);
+    if (fs::exists(existing)) {
+        const bool overwrite = req.get_param_value("overwrite") == "1";
+        if (!overwrite) return reject(409, "Destination already exists");
+        if (!fs::is_regular_file(existing) || op.from_is_dir) return reject(409, "Only a file can replace an existing file");
+        op.replace = true;
+    }
+    fs::create_directories(parent, ec);
+    if (ec) return reject(500, "Failed to create the destination directory");
+    return true;
+}
+
+// Copy op.from next to op.to under a temporary name, then rename it into place.
+bool copy_into_place(const FileOpTarget& op, TreeCopier& copier) {
+    static std::atomic<unsigned> seq{ 0 };
+    const fs::path temp = op.to.parent_path() / fs::u8path("." + op.to.filename().u8string() + ".copy-" +
+        std::to_string(std::time(nullptr)) + "-" + std::to_string(seq.fetch_add(1)));
+    std::error_code ec;
+    if (!copier.copy(op.from, temp)) {
+        fs::remove_all(temp, ec);
+        return false;
+    }
+    fs::rename(temp, op.to, ec);
+    if (ec) {
+        fs::remove_all(temp, ec);
+        copier.error = "Failed to move the copy into place";
+        return false;
+    }
+    return true;
+}
+
+// Runs a validated copy or move; copier.on_progress, if set, is called between pieces.
+bool run_file_op(const FileOpTarget& op, bool move, TreeCopier& copier, std::string& summary) {
+    std::error_code ec;
+    if (move) {
+        fs::rename(op.from, op.to, ec);
+        if (!ec) {
+            summary = "Moved";
+            return true;
+        }
+        if (ec != std::errc::cross_device_link) {
+            copier.error = "Failed to move: " + ec.message();
+            return false;
+        }
+        // Another filesystem below the root (a mount): copy, then remove the source.
+    }
+    copier.plan(op.from);
+    if (!copy_into_place(op, copier)) return false;
+    if (move) fs::remove_all(op.from, ec);
+    summary = std::string(move ? "Moved" : "Copied") + " " + std::to_string(copier.files) + " files, " +
+        std::to_string(copier.done_bytes) + " bytes (" + std::to_string(copier.cloned_bytes) + " reflinked)";
+    if (copier.skipped) summary += ", " + std::to_string(copier.skipped) + " skipped";
+    if (move && ec) summary += "; the source could not be removed completely";
+    return true;
+}
+
+// Handler for POST /copy and POST /move.
+void file_op_handler(const httplib::Request& req, httplib::Response& res, bool move) {
+    if (!authenticate(req, res)) return;
+
+    FileOpTarget op;
+    if (!parse_file_op(req, res, op)) return;
+
+    if (req.get_param_value("progress") != "1") {
+        TreeCopier copier;
+        std::string summary;
+        const bool ok = run_file_op(op, move, copier, summary);
+        file_cache_clear();
+        if (!ok) {
+            res.status = 500;
+            res.set_content(copier.error, "text/plain");
+            return;
+        }
+        res.set_content(summary, "text/plain");
+        return;
+    }
+
+    // Streamed: the work runs inside the provider, so progress goes out as it happens.
+    res.set_chunked_content_provider("text/plain", [op, move](size_t, httplib::DataSink& sink) {
+        TreeCopier copier;
+        auto last = std::chrono::steady_clock::now();
+        copier.on_progress = [&] {
+            const auto now = std::chrono::steady_clock::now();
+            if (now - last < std::chrono::milliseconds(500)) return sink.is_writable();
+            last = now;
+            const std::string line = "progress " + std::to_string(copier.done_bytes) + " " + std::to_string(copier.total_bytes) + "\n";
+            return sink.write(line.data(), line.size()); // a gone client cancels the copy
+        };
+        std::string summary;
+        const bool ok = run_file_op(op, move, copier, summary);
+        file_cache_clear();
+        const std::string line = ok ? "done " + summary + "\n" : "error " + copier.error + "\n";
+        sink.write(line.data(), line.size());
+        sink.done();
+        return true;
+    });
+}
+
+// ------------------------ Tar ingest ------------------------
+
+// Turn an archive member name into a safe relative path.
+// Leading '/' and '.' segments are dropped, '..' and drive letters are rejected.
+bool sanitize_archive_path(const std::string& name, fs::path& out) {
+    out.clear();
+    std::string seg;
+    auto flush = [&]() -> bool {
+        if (seg.empty() || seg == ".") { seg.clear(); return true; }
+        if (seg == ".." || seg.find(':') != std::string::npos) return false;
+        out /= fs::u8path(seg);
+        seg.clear();
+        return true;
+    };
+    for (char c : name) {
+        if (c == '/' || c == '\\') {
+            if (!flush()) return false;
+        }
+        else {
+            seg.push_back(c);
+        }
+    }
+    if (!flush()) return false;
+    return !out.empty();
+}
+
+// Streaming ustar/GNU/pax extractor used by /upload_tar.
+// Bytes are fed in whatever pieces arrive from the socket; regular files are
+// written straight to disk, so the archive is never held in memory.
+// Links and device entries are skipped on purpose.
+struct TarExtractor {
+    std::string canonical_root;   // upload root (same as upload_handler)
+    fs::path target_dir;       // canonical target directory inside the root
+
+    std::size_t files_written = 0;
+    std::size_t files_skipped = 0;
+    int error_status = 0;
+    std::string error;
+
+    enum class State { Header, Data, LongName, Pax, Skip, Padding, End };
+    State state = State::Header;
+    std::string header;          // accumulates a 512-byte header block
+    std::string meta;            // accumulates GNU long name / pax records
+    std::string long_name;       // name override for the next entry
+    std::uintmax_t remaining = 0;
+    std::uintmax_t padding = 0;
+    int zero_blocks = 0;
+    std::ofstream out;
+    fs::path out_path;
+
+    bool fail(int status, const std::string& msg) {
+        error_status = status;
+        error = msg;
+        if (out.is_open()) {
+            out.close();
+            std::error_code ec;
+            fs::remove(out_path, ec);
+        }
+        return false;
+    }
+
+    static std::uintmax_t parse_number(const char* p, std::size_t n) {
+        // GNU base-256 extension for sizes >= 8 GiB
+        if (static_cast<unsigned char>(p[0]) & 0x80) {
+            std::uintmax_t v = static_cast<unsigned char>(p[0]) & 0x7F;
+            for (std::size_t i = 1; i < n; ++i) v = (v << 8) | static_cast<unsigned char>(p[i]);
+            return v;
+        }
+        std::uintmax_t v = 0;
+        std::size_t i = 0;
+        while (i < n && (p[i] == ' ' || p[i] == '\0')) ++i;
+        for (; i < n && p[i] >= '0' && p[i] <= '7'; ++i) v = (v << 3) + (p[i] - '0');
+        return v;
+    }
+
+    static std::string field(const char* p, std::size_t n) {
+        std::size_t len = 0;
+        while (len < n && p[len] != '\0') ++len;
+        return std::string(p, len);
+    }
+
+    static bool header_checksum_ok(const char* h) {
+        unsigned long sum = 0;
+        for (int i = 0; i < 512; ++i) {
+            sum += (i >= 148 && i < 156) ? ' ' : static_cast<unsigned char>(h[i]);
+        }
+        return sum == parse_number(h + 148, 8);
+    }
+
+    // Resolve an entry name below target_dir, with the same confinement check as upload_handler.
+    bool resolve_entry(const std::string& name, fs::path& full) {
+        fs::path rel;
+        if (!sanitize_archive_path(name, rel)) return false;
+        full = target_dir / rel;
+        auto canonical_parent = fs::weakly_canonical(full.parent_path());
+        return canonical_parent.string().rfind(canonical_root, 0) == 0;
+    }
+
+    bool start_entry(const char* h) {
+        const char type = h[156];
+        std::string name = long_name;
+        long_name.clear();
+        if (name.empty()) {
+            name = field(h, 100);
+            if (std::memcmp(h + 257, "ustar", 5) == 0) {
+                std::string prefix = field(h + 345, 155);
+                if (!prefix.empty()) name = prefix + "/" + name;
+            }
+        }
+        remaining = parse_number(h + 124, 12);
+        padding = (512 - remaining % 512) % 512;
+
+        if (type == 'L' || type == 'x') {
+            meta.clear();
+            state = (type == 'L') ? State::LongName : State::Pax;
+            return remaining > 64 * 1024 ? fail(400, "Archive metadata entry too large") : true;
+        }
+
+        fs::path full;
+        if (type == '5') {
+            if (name.find_first_not_of("./") == std::string::npos) { // "./" as written by `tar -C dir .`
+                state = remaining ? State::Skip : State::Header;
+                return true;
+            }
+            if (!resolve_entry(name, full)) return fail(403, "Forbidden: Invalid path in archive: " + name);
+            std::error_code ec;
+            fs::create_directories(full, ec);
+            if (ec) return fail(500, "Failed to create directory: " + name);
+            state = remaining ? State::Skip : State::Header;
+            return true;
+        }
+
+        if (type != '0' && type != '\0' && type != '7') {
+            // Symlinks, hardlinks, devices, global pax headers: never materialized.
+            if (type != 'g') ++files_skipped;
+            state = remaining ? State::Skip : State::Header;
+            return true;
+        }
+
+        if (!resolve_entry(name, full)) return fail(403, "Forbidden: Invalid path in archive: " + name);
+        if (fs::exists(full)) {
+            // Same no-overwrite rule as upload_handler, but keep going with the rest.
+            ++files_skipped;
+            state = remaining ? State::Skip : State::Header;
+            return true;
+        }
+        std::error_code ec;
+        fs::create_directories(full.parent_path(), ec);
+        out_path = full;
+        out.open(full, std::ios::binary);
+        if (!out) return fail(500, "Failed to save file: " + name);
+        state = State::Data;
+        if (remaining == 0) return finish_file();
+        return true;
+    }
+
+    bool finish_file() {
+        out.close();
+        if (!out) return fail(500, "Failed to write file: " + out_path.u8string());
+        ++files_written;
+        state = padding ? State::Padding : State::Header;
+        return true;
+    }
+
+    void parse_pax() {
+        // Records: "<len> key=value\n"
+        std::size_t pos = 0;
+        while (pos < meta.size()) {
+            std::size_t sp = meta.find(' ', pos);
+            if (sp == std::string::npos) break;
+            std::size_t len = 0;
+            try { len = static_cast<std::size_t>(std::stoul(meta.substr(pos, sp - pos))); }
+            catch (...) { break; }
+            if (len == 0 || pos + len > meta.size()) break;
+            std::string rec = meta.substr(sp + 1, len - (sp + 1 - pos));
+            if (!rec.empty() && rec.back() == '\n') rec.pop_back();
+            if (rec.rfind("path=", 0) == 0) long_name = rec.substr(5);
+            pos += len;
+        }
+    }
+
+    bool feed(const char* data, std::size_t len) {
+        while (len > 0 && error_status == 0) {
+            switch (state) {
+            case State::Header: {
+                std::size_t take = std::min<std::size_t>(512 - header.size(), len);
+                header.append(data, take);
+                data += take; len -= take;
+                if (header.size() < 512) break;
+                if (std::all_of(header.begin(), header.end(), [](char c) { return c == '\0'; })) {
+                    header.clear();
+                    if (++zero_blocks == 2) state = State::End;
+                    break;
+                }
+                zero_blocks = 0;
+                if (!header_checksum_ok(header.data())) return fail(400, "Invalid tar header");
+                std::string h;
+                h.swap(header);
+                if (!start_entry(h.data())) return false;
+                break;
+            }
+            case State::Data: {
+                std::size_t take = static_cast<std::size_t>(std::min<std::uintmax_t>(remaining, len));
+                out.write(data, static_cast<std::streamsize>(take));
+                if (!out) return fail(500, "Failed to write file: " + out_path.u8string());
+                data += take; len -= take; remaining -= take;
+                if (remaining == 0 && !finish_file()) return false;
+                break;
+            }
+            case State::LongName:
+            case State::Pax: {
+                std::size_t take = static_cast<std::size_t>(std::min<std::uintmax_t>(remaining, len));
+                meta.append(data, take);
+                data += take; len -= take; remaining -= take;
+                if (remaining == 0) {
+                    if (state == State::LongName) long_name = field(meta.data(), meta.size());
+                    else parse_pax();
+                    state = padding ? State::Padding : State::Header;
+                }
+                break;
+            }
+            case State::Skip: {
+                std::size_t take = static_cast<std::size_t>(std::min<std::uintmax_t>(remaining, len));
+                data += take; len -= take; remaining -= take;
+                if (remaining == 0) state = padding ? State::Padding : State::Header;
+                break;
+            }
+            case State::Padding: {
+                std::size_t take = static_cast<std::size_t>(std::min<std::uintmax_t>(padding, len));
+                data += take; len -= take; padding -= take;
+                if (padding == 0) state = State::Header;
+                break;
+            }
+            case State::End:
+                return true; // trailing blocks after the end marker are ignored
+            }
+        }
+        return error_status == 0;
+    }
+
+    bool finish() {
+        if (error_status) return false;
+        if (state == State::End) return true;
+        return fail(400, "Truncated tar archive");
+    }
+};
+
+// Optional decompression in front of TarExtractor, picked by the stream magic.
+// The decoded tar stream is held to MAX_UPLOAD_SIZE like any other upload
+// (unless --unlim), so a small compressed body cannot expand without bound.
+struct TarStreamDecoder {
+    enum class Kind { Unknown, Plain, Gzip, Zstd };
+    Kind kind = Kind::Unknown;
+    std::string sniff;
+    std::uintmax_t decoded = 0;
+    bool stream_end = false;     // the compressed stream reached its end marker
+#ifdef CPPHTTPLIB_ZLIB_SUPPORT
+    z_stream zs{};
+    bool zs_init = false;
+#endif
+#ifdef ARTWEB_ZSTD_SUPPORT
+    ZSTD_DStream* zds = nullptr;
+#endif
+
+    ~TarStreamDecoder() {
+#ifdef CPPHTTPLIB_ZLIB_SUPPORT
+        if (zs_init) inflateEnd(&zs);
+#endif
+#ifdef ARTWEB_ZSTD_SUPPORT
+        if (zds) ZSTD_freeDStream(zds);
+#endif
+    }
+
+    bool feed(const char* data, std::size_t len, TarExtractor& tar) {
+        if (kind == Kind::Unknown) {
+            sniff.append(data, len);
+            if (sniff.size() < 4) return true;
+            const auto* m = reinterpret_cast<const unsigned char*>(sniff.data());
+            if (m[0] == 0x1F && m[1] == 0x8B) kind = Kind::Gzip;
+            else if (m[0] == 0x28 && m[1] == 0xB5 && m[2] == 0x2F && m[3] == 0xFD) kind = Kind::Zstd;
+            else kind = Kind::Plain;
+            std::string buffered;
+            buffered.swap(sniff);
+            return decode(buffered.data(), buffered.size(), tar);
+        }
+        return decode(data, len, tar);
+    }
+
+    bool finish(TarExtractor& tar) {
+        if (kind == Kind::Unknown && !sniff.empty()) {
+            kind = Kind::Plain;
+            if (!emit(sniff.data(), sniff.size(), tar)) return false;
+        }
+        if (kind == Kind::Gzip || kind == Kind::Zstd) {
+            // Flush what the decoder still holds, then insist on a complete stream.
+            if (!stream_end && !decode(nullptr, 0, tar)) return false;
+            if (!stream_end) return tar.fail(400, kind == Kind::Gzip ? "Truncated gzip stream" : "Truncated zstd stream");
+        }
+        return tar.finish();
+    }
+
+    bool emit(const char* data, std::size_t len, TarExtractor& tar) {
+        decoded += len;
+        if (!g_unlimited_upload && decoded > MAX_UPLOAD_SIZE) return tar.fail(413, "Extracted archive is too large");
+        return tar.feed(data, len);
+    }
+
+    bool decode(const char* data, std::size_t len, TarExtractor& tar) {
+        switch (kind) {
+        case Kind::Plain:
+            return emit(data, len, tar);
+        case Kind::Gzip: {
+#ifdef CPPHTTPLIB_ZLIB_SUPPORT
+            if (!zs_init) {
+                if (inflateInit2(&zs, 16 + MAX_WBITS) != Z_OK) return tar.fail(500, "Failed to initialize gzip decoder");
+                zs_init = true;
+            }
+            if (stream_end) return true; // anything after the gzip trailer is ignored
+            char buf[64 * 1024];
+            zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+            zs.avail_in = static_cast<uInt>(len);
+            // Loop while input remains or the last call filled the buffer,
+            // since zlib may still hold output for a full buffer.
+            do {
+                zs.next_out = reinterpret_cast<Bytef*>(buf);
+                zs.avail_out = sizeof(buf);
+                int ret = inflate(&zs, Z_NO_FLUSH);
+                if (ret != Z_OK && ret != Z_STREAM_END && ret != Z_BUF_ERROR) return tar.fail(400, "Corrupt gzip stream");
+                std::size_t have = sizeof(buf) - zs.avail_out;
+                if (have && !emit(buf, have, tar)) return false;
+                if (ret == Z_STREAM_END) { stream_end = true; break; }
+                if (ret == Z_BUF_ERROR && have == 0) break;
+            } while (zs.avail_in > 0 || zs.avail_out == 0);
+            return true;
+#else
+            return tar.fail(415, "gzip archives are not supported by this build");
+#endif
+        }
+        case Kind::Zstd: {
+#ifdef ARTWEB_ZSTD_SUPPORT
+            if (!zds) {
+                zds = ZSTD_createDStream();
+                if (!zds || ZSTD_isError(ZSTD_initDStream(zds))) return tar.fail(500, "Failed to initialize zstd decoder");
+            }
+            std::vector<char> buf(ZSTD_DStreamOutSize());
+            ZSTD_inBuffer in{ data, len, 0 };
+            ZSTD_outBuffer out{ buf.data(), buf.size(), 0 };
+            // As with gzip, a full output buffer means more may be pending.
+            do {
+                out.pos = 0;
+                std::size_t ret = ZSTD_decompressStream(zds, &out, &in);
+                if (ZSTD_isError(ret)) return tar.fail(400, "Corrupt zstd stream");
+                stream_end = ret == 0; // 0: a frame is complete and fully flushed
+                if (out.pos && !emit(buf.data(), out.pos, tar)) return false;
+            } while (in.pos < in.size || out.pos == out.size);
+            return true;
+#else
+            return tar.fail(415, "zstd archives are not supported by this build");
+#endif
+        }
+        default:
+            return true;
+        }
+    }
+};
+
+// Tar Upload Handler: POST /upload_tar?dir=... with a (optionally gzip/zstd) tar body.
+// The whole folder arrives in one request instead of one request per file.
+void upload_tar_handler(const httplib::Request& req, httplib::Response& res, const httplib::ContentReader& content_reader) {
+    if (!authenticate(req, res)) return;
+
+    if (req.is_multipart_form_data()) {
+        res.status = 400;
+        res.set_content("Send the tar archive as the raw request body", "text/plain");
+        return;
+    }
+
+    std::string targetDirStr = ".";
+    if (req.has_param("dir")) {
+        targetDirStr = req.get_param_value("dir");
+    }
+
+    fs::path canonical_target_dir;
+    if (!resolve_upload_dir(targetDirStr, canonical_target_dir)) {
+        res.status = 403;
+        res.set_content("Forbidden: Invalid target directory.", "text/plain");
+        return;
+    }
+
+    TarExtractor tar;
+    tar.canonical_root = g_root.canonical;
+    tar.target_dir = canonical_target_dir;
+    TarStreamDecoder decoder;
+
+    const bool complete = content_reader([&](const char* data, size_t len) {
+        throttle_inbound(req, len);
+        // Returning false aborts the transfer; the error is reported below.
+        return decoder.feed(data, len, tar);
+        });
+
+    if (tar.error_status == 0 && !complete) tar.fail(400, "Upload interrupted");
+    if (tar.error_status == 0) decoder.finish(tar);
+    file_cache_clear(); // new files and directories may shadow cached 404s
+    if (tar.error_status != 0) {
+        res.status = tar.error_status;
+        res.set_content(tar.error + " (" + std::to_string(tar.files_written) + " files extracted before the error)", "text/plain");
+        return;
+    }
+
+    res.set_content("Archive extracted: " + std::to_string(tar.files_written) + " files written, " +
+        std::to_string(tar.files_skipped) + " skipped", "text/plain");
+}
+
+// --- Archive browsing (GET /file.zip?archive=MEMBER) ---
+// Zip, tar and tar.gz files can be listed like directories, and single
+// members fetched, without extracting anything to disk:
+// - A zip is indexed from its central directory at the end of the file.
+// - A tar is indexed by hopping from header to header.
+// - A tar.gz is decompressed once to index it. Every ARCHIVE_GZ_SPAN output
+//   bytes an access point is recorded: a compressed offset plus the 32 KB
+//   window before it. A member is later reached by resuming inflate at the
+//   nearest point.
+// Indexes are cached per file identity, so a changed archive is reindexed.
+
+constexpr std::size_t ARCHIVE_MAX_MEMBERS = 1000000;
+constexpr std::uint64_t ARCHIVE_GZ_SPAN = 16ull << 20;
+constexpr std::size_t ARCHIVE_CACHE_SIZE = 16;
+constexpr std::size_t ARCHIVE_BLOCK = 256 * 1024;
+constexpr auto ARCHIVE_INDEX_WAIT = std::chrono::seconds(2); // longer builds answer 503 meanwhile
+constexpr int ARCHIVE_MAX_BUILDS = 4;
+
+struct ArchiveMember {
+    std::string name;           // '/'-separated, without leading "./" or a trailing '/'
+    bool dir = false;
+    bool encrypted = false;
+    std::uint16_t method = 0;   // zip: 0 stored, 8 deflated
+    std::uint64_t size = 0;     // uncompressed
+    std::uint64_t packed = 0;   // zip: compressed size
+    std::uint64_t offset = 0;   // zip: local header; tar: data in the uncompressed tar stream
+    std::time_t mtime = 0;
+};
+
+struct GzipAccessPoint {
+    std::uint64_t in = 0;       // compressed offset of the first whole byte after the point
+    std::uint64_t out = 0;      // uncompressed offset
+    int bits = 0;               // bits of the byte before `in` that are still unread
+    std::string window;         // the (up to) 32 KB of output before `out`, deflated
+};
+
+struct ArchiveIndex {
+    enum class Kind { Zip, Tar, TarGz };
+    Kind kind = Kind::Zip;
+    std::vector<ArchiveMember> members;  // sorted by name
+    std::vector<GzipAccessPoint> points; // tar.gz only, in stream order
+
+    std::vector<ArchiveMember>::const_iterator lower_bound(const std::string& name) const {
+        return std::lower_bound(members.begin(), members.end(), name,
+            [](const ArchiveMember& m, const std::string& n) { return m.name < n; });
+    }
+
+    const ArchiveMember* find(const std::string& name) const {
+        auto it = lower_bound(name);
+        return it != members.end() && it->name == name ? &*it : nullptr;
+    }
+};
+
+inline std::uint16_t load_le16(const unsigned char* p) { return static_cast<std::uint16_t>(p[0] | (p[1] << 8)); }
+inline std::uint32_t load_le32(const unsigned char* p) { return load_le16(p) | (static_cast<std::uint32_t>(load_le16(p + 2)) << 16); }
+inline std::uint64_t load_le64(const unsigned char* p) { return load_le32(p) | (static_cast<std::uint64_t>(load_le32(p + 4)) << 32); }
+
+// Unix time of an MS-DOS date/time pair (local time of the packer, taken as UTC).
+std::time_t dos_time(std::uint16_t date, std::uint16_t time) {
+    int y = 1980 + (date >> 9);
+    const int m = (date >> 5) & 15, d = date & 31;
+    if (m < 1 || m > 12 || d < 1) return 0;
+    y -= m <= 2;
+    const int era = y / 400, yoe = y - era * 400;
+    const int doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const long long days = static_cast<long long>(era) * 146097 + yoe * 365 + yoe / 4 - yoe / 100 + doy - 719468;
+    return static_cast<std::time_t>(days * 86400 + (time >> 11) * 3600 + ((time >> 5) & 63) * 60 + (time & 31) * 2);
+}
+
+// Normalized member name; false for names that cannot be addressed ("", ".", "/").
+bool archive_member_name(std::string name, std::string& out, bool& dir) {
+    std::replace(name.begin(), name.end(), '\\', '/'); // some Windows zip tools
+    dir = !name.empty() && name.back() == '/';
+    while (!name.empty() && name.back() == '/') name.pop_back();
+    std::size_t start = 0;
+    for (;;) {
+        if (name.compare(start, 2, "./") == 0) start += 2;
+        else if (start < name.size() && name[start] == '/') ++start;
+        else break;
+    }
+    out = name.substr(start);
+    return !out.empty() && out != ".";
+}
+
+std::string html_escape(const std::string& s) {
+    std::string out;
+    out.reserve(s.size());
+    for (char c : s) {
+        switch (c) {
+        case '&': out += "&amp;"; break;
+        case '<': out += "&lt;"; break;
+        case '>': out += "&gt;"; break;
+        case '\'': out += "&#39;"; break;
+        case '"': out += "&quot;"; break;
+        default: out += c;
+        }
+    }
+    return out;
+}
+
+bool read_zip_index(const ResolvedFile& file, ArchiveIndex& index, std::string& error) {
+    SegmentReader reader(file);
+    // The end of central directory record is 22 bytes plus a comment of up to 64 KB.
+    const std::size_t tail_len = static_cast<std::size_t>(std::min<std::uint64_t>(file.size, 22 + 65535));
+    std::vector<unsigned char> tail(tail_len);
+    if (reader.read(reinterpret_cast<char*>(tail.data()), tail_len, file.size - tail_len) != tail_len) {
+        error = "Failed to read the archive";
+        return false;
+    }
+    std::size_t eocd = std::string::npos;
+    for (std::size_t i = tail_len >= 22 ? tail_len - 21 : 0; i-- > 0;) {
+        if (load_le32(&tail[i]) == 0x06054b50) {
+            eocd = i;
+            break;
+        }
+    }
+    if (eocd == std::string::npos) {
+        error = "Zip central directory not found";
+        return false;
+    }
+    std::uint64_t count = load_le16(&tail[eocd + 10]);
+    std::uint64_t cd_size = load_le32(&tail[eocd + 12]);
+    std::uint64_t cd_offset = load_le32(&tail[eocd + 16]);
+    if (eocd >= 20 && load_le32(&tail[eocd - 20]) == 0x07064b50) {
+        unsigned char rec[56];
+        const std::uint64_t at = load_le64(&tail[eocd - 20 + 8]);
+        if (reader.read(reinterpret_cast<char*>(rec), sizeof(rec), at) != sizeof(rec) || load_le32(rec) != 0x06064b50) {
+            error = "Invalid zip64 end of central directory";
+            return false;
+        }
+        count = load_le64(rec + 32);
+        cd_size = load_le64(rec + 40);
+        cd_offset = load_le64(rec + 48);
+    }
+    if (cd_offset > file.size || cd_size > file.size - cd_offset || count > ARCHIVE_MAX_MEMBERS) {
+        error = "Corrupt zip central directory";
+        return false;
+    }
+    std::vector<unsigned char> cd(static_cast<std::size_t>(cd_size));
+    if (reader.read(reinterpret_cast<char*>(cd.data()), cd.size(), cd_offset) != cd.size()) {
+        error = "Failed to read the archive";
+        return false;
+    }
+
+    index.kind = ArchiveIndex::Kind::Zip;
+    std::size_t p = 0;
+    for (std::uint64_t i = 0; i < count; ++i) {
+        if (p + 46 > cd.size() || load_le32(&cd[p]) != 0x02014b50) {
+            error = "Corrupt zip central directory";
+            return false;
+        }
+        const unsigned char* e = &cd[p];
+        const std::size_t name_len = load_le16(e + 28), extra_len = load_le16(e + 30), comment_len = load_le16(e + 32);
+        if (p + 46 + name_len + extra_len + comment_len > cd.size()) {
+            error = "Corrupt zip central directory";
+            return false;
+        }
+        ArchiveMember m;
+        m.encrypted = (load_le16(e + 8) & 1) != 0;
+        m.method = load_le16(e + 10);
+        m.mtime = dos_time(load_le16(e + 14), load_le16(e + 12));
+        m.packed = load_le32(e + 20);
+        m.size = load_le32(e + 24);
+        m.offset = load_le32(e + 42);
+        // Zip64 extra field: 64-bit values for whichever of these fields are saturated, in this order.
+        for (std::size_t x = 0; x + 4 <= extra_len;) {
+            const unsigned char* f = e + 46 + name_len + x;
+            const std::size_t id = load_le16(f), len = load_le16(f + 2);
+            if (x + 4 + len > extra_len) break;
+            if (id == 0x0001) {
+                std::size_t k = 4;
+                for (std::uint64_t* v : { &m.size, &m.packed, &m.offset }) {
+                    if (*v != 0xFFFFFFFFu) continue;
+                    if (k + 8 > 4 + len) break;
+                    *v = load_le64(f + k);
+                    k += 8;
+                }
+            }
+            x += 4 + len;
+        }
+        // Local header and data must lie in front of the central directory; stored data is not resized.
+        const bool stored = m.method == 0 && !m.encrypted;
+        if (m.offset > cd_offset || m.packed > cd_offset - m.offset || cd_offset - m.offset - m.packed < 30 || (stored && m.size != m.packed)) {
+            error = "Corrupt zip central directory";
+            return false;
+        }
+        const std::string raw(reinterpret_cast<const char*>(e + 46), name_len);
+        if (archive_member_name(raw, m.name, m.dir)) index.members.push_back(std::move(m));
+        p += 46 + name_len + extra_len + comment_len;
+    }
+    return true;
+}
+
+// Sequential reads of a plain tar file; skipping is free.
+class PlainTarSource {
+public:
+    explicit PlainTarSource(const ResolvedFile& file) : reader_(file), size_(file.size) {}
+
+    bool read_exact(char* buf, std::size_t n) {
+        if (reader_.read(buf, n, pos_) != n) return false;
+        pos_ += n;
+        return true;
+    }
+
+    // False, positioned at the end, when the file is shorter.
+    bool skip(std::uint64_t n) {
+        if (n > size_ - std::min(pos_, size_)) {
+            pos_ = size_;
+            return false;
+        }
+        pos_ += n;
+        return true;
+    }
+
+    std::uint64_t pos() const { return pos_; }
+
+private:
+    SegmentReader reader_;
+    std::uint64_t size_;
+    std::uint64_t pos_ = 0;
+};
+
+#ifdef CPPHTTPLIB_ZLIB_SUPPORT
+// Inflate over part of a file: a whole (possibly multi-member) gzip stream,
+// the same resumed at an access point, or a raw deflate stream (zip member).
+class InflateReader {
+public:
+    // `points`, when given, receives access points while reading from the start of a gzip stream.
+    explicit InflateReader(const ResolvedFile& file, std::vector<GzipAccessPoint>* points = nullptr)
+        : reader_(file), points_(points), in_buf_(ARCHIVE_BLOCK) {}
+
+    ~InflateReader() {
+        if (init_) inflateEnd(&zs_);
+    }
+
+    InflateReader(const InflateReader&) = delete;
+    InflateReader& operator=(const InflateReader&) = delete;
+
+    bool open_gzip() {
+        init_ = inflateInit2(&zs_, 16 + 15) == Z_OK;
+        return init_;
+    }
+
+    bool open_at(const GzipAccessPoint& point) {
+        if (!open_raw(point.in - (point.bits ? 1 : 0), Mode::RawGzip)) return false;
+        out_ = point.out;
+        if (point.bits) {
+            if (zs_.avail_in == 0 && !fill()) return false;
+            const int byte = *zs_.next_in;
+            ++zs_.next_in;
+            --zs_.avail_in;
+            inflatePrime(&zs_, point.bits, byte >> (8 - point.bits));
+        }
+        std::vector<Bytef> window(32768);
+        uLongf len = static_cast<uLongf>(window.size());
+        if (uncompress(window.data(), &len, reinterpret_cast<const Bytef*>(point.window.data()), static_cast<uLong>(point.window.size())) != Z_OK) return false;
+        return inflateSetDictionary(&zs_, window.data(), static_cast<uInt>(len)) == Z_OK;
+    }
+
+    bool open_deflate(std::uint64_t offset) {
+        return open_raw(offset, Mode::Deflate);
+    }
+
+    // Up to n bytes of output; short only at the end of the stream or on an error.
+    std::size_t read(char* buf, std::size_t n) {
+        zs_.next_out = reinterpret_cast<Bytef*>(buf);
+        zs_.avail_out = static_cast<uInt>(n);
+        while (zs_.avail_out > 0 && !ended_ && !failed_) {
+            if (zs_.avail_in == 0 && !fill()) {
+                failed_ = true; // truncated
+                break;
+            }
+            const uInt before = zs_.avail_out;
+            const int ret = inflate(&zs_, points_ ? Z_BLOCK : Z_NO_FLUSH);
+            out_ += before - zs_.avail_out;
+            if (ret == Z_STREAM_END) {
+                ended_ = !next_member();
+            }
+            else if (ret != Z_OK && ret != Z_BUF_ERROR) {
+                failed_ = true;
+            }
+            else if (points_) {
+                mark();
+            }
+        }
+        return n - zs_.avail_out;
+    }
+
+    bool read_exact(char* buf, std::size_t n) { return read(buf, n) == n; }
+
+    bool skip(std::uint64_t n) {
+        char scratch[16 * 1024];
+        while (n > 0) {
+            const std::size_t take = static_cast<std::size_t>(std::min<std::uint64_t>(n, sizeof(scratch)));
+            if (read(scratch, take) != take) return false;
+            n -= take;
+        }
+        return true;
+    }
+
+    std::uint64_t pos() const { return out_; }
+    bool failed() const { return failed_; }
+
+private:
+    enum class Mode { Gzip, RawGzip, Deflate };
+
+    bool open_raw(std::uint64_t offset, Mode mode) {
+        init_ = inflateInit2(&zs_, -15) == Z_OK;
+        in_off_ = offset;
+        mode_ = mode;
+        return init_;
+    }
+
+    // Top up the input buffer, keeping what inflate has not consumed yet.
+    bool fill() {
+        const std::size_t keep = zs_.avail_in;
+        if (keep) std::memmove(in_buf_.data(), zs_.next_in, keep);
+        const std::size_t got = reader_.read(in_buf_.data() + keep, in_buf_.size() - keep, in_off_);
+        in_off_ += got;
+        zs_.next_in = reinterpret_cast<Bytef*>(in_buf_.data());
+        zs_.avail_in = static_cast<uInt>(keep + got);
+        return got > 0;
+    }
+
+    // After the end of a gzip member: continue with the next one, if any.
+    bool next_member() {
+        if (mode_ == Mode::Deflate) return false; // a zip member is a single stream
+        if (mode_ == Mode::RawGzip) {
+            // A raw stream stops in front of the 8-byte gzip trailer.
+            for (std::size_t trailer = 8; trailer > 0;) {
+                if (zs_.avail_in == 0 && !fill()) return false;
+                const uInt take = static_cast<uInt>(std::min<std::size_t>(trailer, zs_.avail_in));
+                zs_.next_in += take;
+                zs_.avail_in -= take;
+                trailer -= take;
+            }
+            mode_ = Mode::Gzip;
+        }
+        while (zs_.avail_in < 2) {
+            if (!fill()) return false;
+        }
+        if (zs_.next_in[0] != 0x1f || zs_.next_in[1] != 0x8b) return false; // padding after the last member
+        return inflateReset2(&zs_, 16 + 15) == Z_OK;
+    }
+
+    void mark() {
+        // Only between deflate blocks, and not after the last block of a member.
+        if (!(zs_.data_type & 128) || (zs_.data_type & 64) || out_ - last_mark_ < ARCHIVE_GZ_SPAN) return;
+        std::vector<Bytef> window(32768);
+        uInt len = static_cast<uInt>(window.size());
+        if (inflateGetDictionary(&zs_, window.data(), &len) != Z_OK) return;
+        GzipAccessPoint point;
+        point.in = in_off_ - zs_.avail_in;
+        point.out = out_;
+        point.bits = zs_.data_type & 7;
+        uLongf packed = compressBound(len);
+        point.window.resize(packed);
+        if (compress2(reinterpret_cast<Bytef*>(&point.window[0]), &packed, window.data(), len, Z_BEST_SPEED) != Z_OK) return;
+        point.window.resize(packed);
+        points_->push_back(std::move(point));
+        last_mark_ = out_;
+    }
+
+    SegmentReader reader_;
+    std::vector<GzipAccessPoint>* points_;
+    std::vector<char> in_buf_;
+    z_stream zs_{};
+    bool init_ = false;
+    Mode mode_ = Mode::Gzip;
+    bool ended_ = false;
+    bool failed_ = false;
+    std::uint64_t in_off_ = 0;
+    std::uint64_t out_ = 0;
+    std::uint64_t last_mark_ = 0;
+};
+#endif
+
+template <class Source>
+bool read_tar_members(Source& src, ArchiveIndex& index, std::string& error) {
+    char h[512];
+    TarExtractor pax; // only its pax record parser is used
+    std::string long_name;
+    for (;;) {
+        if (!src.read_exact(h, sizeof(h))) break; // no end-of-archive blocks
+        if (std::all_of(h, h + sizeof(h), [](char c) { return c == '\0'; })) break;
+        if (!TarExtractor::header_checksum_ok(h)) {
+            error = "Invalid tar header";
+            return false;
+        }
+        const char type = h[156];
+        const std::uint64_t size = TarExtractor::parse_number(h + 124, 12);
+        const std::uint64_t padded = size + (512 - size % 512) % 512;
+        if (type == 'L' || type == 'x') {
+            if (size > 64 * 1024) {
+                error = "Archive metadata entry too large";
+                return false;
+            }
+            std::string data(static_cast<std::size_t>(padded), '\0');
+            if (!src.read_exact(&data[0], data.size())) break;
+            data.resize(static_cast<std::size_t>(size));
+            if (type == 'L') {
+                long_name = TarExtractor::field(data.data(), data.size());
+            }
+            else {
+                pax.meta = data;
+                pax.long_name.clear();
+                pax.parse_pax();
+                if (!pax.long_name.empty()) long_name = pax.long_name;
+            }
+            continue;
+        }
+
+        std::string name;
+        name.swap(long_name);
+        if (name.empty()) {
+            name = TarExtractor::field(h, 100);
+            if (std::memcmp(h + 257, "ustar", 5) == 0) {
+                const std::string prefix = TarExtractor::field(h + 345, 155);
+                if (!prefix.empty()) name = prefix + "/" + name;
+            }
+        }
+        ArchiveMember m;
+        const std::uint64_t data_at = src.pos();
+        if ((type == '0' || type == '\0' || type == '7' || type == '5') && archive_member_name(name, m.name, m.dir)) {
+            m.dir = m.dir || type == '5';
+            m.size = m.dir ? 0 : size;
+            m.offset = data_at;
+            m.mtime = static_cast<std::time_t>(TarExtractor::parse_number(h + 136, 12));
+            index.members.push_back(std::move(m));
+            if (index.members.size() > ARCHIVE_MAX_MEMBERS) {
+                error = "Too many archive members";
+                return false;
+            }
+        }
+        if (!src.skip(padded)) {
+            // Only the padding of the last entry may be missing.
+            if (src.pos() - data_at < size) {
+                error = "Truncated tar archive";
+                return false;
+            }
+            break;
+        }
+    }
+    return true;
+}
+
+// Sort by name; a later entry for the same name replaces the earlier one (tar appends).
+void finish_archive_index(ArchiveIndex& index) {
+    std::stable_sort(index.members.begin(), index.members.end(),
+        [](const ArchiveMember& a, const ArchiveMember& b) { return a.name < b.name; });
+    std::vector<ArchiveMember> unique;
+    unique.reserve(index.members.size());
+    for (auto& m : index.members) {
+        if (!unique.empty() && unique.back().name == m.name) unique.back() = std::move(m);
+        else unique.push_back(std::move(m));
+    }
+    index.members.swap(unique);
+}
+
+bool build_archive_index(const ResolvedFile& file, ArchiveIndex& index, int& status, std::string& error) {
+    char head[512] = {};
+    const std::size_t got = SegmentReader(file).read(head, sizeof(head), 0);
+    const auto* magic = reinterpret_cast<const unsigned char*>(head);
+    status = 422;
+    bool ok = false;
+    if (got >= 4 && magic[0] == 'P' && magic[1] == 'K') {
+        ok = read_zip_index(file, index, error);
+    }
+    else if (got >= 2 && magic[0] == 0x1F && magic[1] == 0x8B) {
+#ifdef CPPHTTPLIB_ZLIB_SUPPORT
+        index.kind = ArchiveIndex::Kind::TarGz;
+        InflateReader gz(file, &index.points);
+        if (!gz.open_gzip()) {
+            status = 500;
+            error = "Failed to initialize gzip decoder";
+            return false;
+        }
+        ok = read_tar_members(gz, index, error);
+        if (ok && gz.failed()) {
+            ok = false;
+            error = "Corrupt gzip stream";
+        }
+#else
+        status = 415;
+        error = "gzip archives are not supported by this build";
+        return false;
+#endif
+    }
+    else if (got == sizeof(head) && TarExtractor::header_checksum_ok(head)) {
+        index.kind = ArchiveIndex::Kind::Tar;
+        PlainTarSource tar(file);
+        ok = read_tar_members(tar, index, error);
+    }
+    else {
+        status = 415;
+        error = "Not a zip or tar archive";
+        return false;
+    }
+    if (ok) finish_archive_index(index);
+    return ok;
+}
+
+// Archive indexes by file identity, least recently used dropped first.
+// Indexes are built on a background thread (a tar.gz is decompressed in full);
+// a request waits for a short while and then gets 503 until the build is done.
+class ArchiveCache {
+public:
+    std::shared_ptr<const ArchiveIndex> get(const ResolvedFile& file, int& status, std::string& error) {
+        auto slot = slot_for(file_identity(file));
+        std::unique_lock<std::mutex> lock(slot->mutex);
+        if (!slot->built && !slot->building) {
+            if (builds_.fetch_add(1) >= ARCHIVE_MAX_BUILDS) {
+                builds_.fetch_sub(1);
+                status = 503;
+                error = "Too many archives being indexed, retry later";
+                return nullptr;
+            }
+            slot->building = true;
+            std::thread([this, slot, file] { build(slot, file); }).detach();
+        }
+        if (!slot->cv.wait_for(lock, ARCHIVE_INDEX_WAIT, [&] { return slot->built; })) {
+            status = 503;
+            error = "Archive is being indexed, retry later";
+            return nullptr;
+        }
+        status = slot->status;
+        error = slot->error;
+        return slot->index;
+    }
+
+    // Size of a member when the archive is already indexed (for lane admission), else 0.
+    std::uint64_t member_size(const ResolvedFile& file, const std::string& name) {
+        std::shared_ptr<Slot> slot;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = slots_.find(file_identity(file));
+            if (it == slots_.end()) return 0;
+            slot = it->second;
+        }
+        std::unique_lock<std::mutex> lock(slot->mutex, std::try_to_lock);
+        if (!lock || !slot->index) return 0;
+        const ArchiveMember* m = slot->index->find(name);
+        return m ? m->size : 0;
+    }
+
+private:
+    struct Slot {
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool building = false;
+        bool built = false;
+        int status = 0;
+        std::string error;
+        std::shared_ptr<const ArchiveIndex> index;
+        std::uint64_t tick = 0;
+    };
+
+    void build(std::shared_ptr<Slot> slot, ResolvedFile file) {
+        auto index = std::make_shared<ArchiveIndex>();
+        int status = 0;
+        std::string error;
+        const bool ok = build_archive_index(file, *index, status, error);
+        {
+            std::lock_guard<std::mutex> lock(slot->mutex);
+            if (ok) slot->index = index;
+            slot->status = status;
+            slot->error = error;
+            slot->built = true;
+            slot->building = false;
+        }
+        slot->cv.notify_all();
+        builds_.fetch_sub(1);
+    }
+
+    std::shared_ptr<Slot> slot_for(const std::string& key) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& slot = slots_[key];
+        if (!slot) {
+            if (slots_.size() > ARCHIVE_CACHE_SIZE) {
+                auto oldest = slots_.end();
+                for (auto it = slots_.begin(); it != slots_.end(); ++it) {
+                    if (it->second && (oldest == slots_.end() || it->second->tick < oldest->second->tick)) oldest = it;
+                }
+                if (oldest != slots_.end()) slots_.erase(oldest);
+            }
+            slot = std::make_shared<Slot>();
+        }
+        slot->tick = ++tick_;
+        return slot;
+    }
+
+    std::mutex mutex_;
+    std::unordered_map<std::string, std::shared_ptr<Slot>> slots_;
+    std::uint64_t tick_ = 0;
+    std::atomic<int> builds_{ 0 };
+};
+
+ArchiveCache g_archives;
+
+// Reads one member at arbitrary offsets (httplib asks in order, or per Range):
+// stored data is read in place; compressed data is inflated, reopening at the
+// best starting point when asked to go back or far ahead.
+class ArchiveMemberStream {
+public:
+    ArchiveMemberStream(std::shared_ptr<const ArchiveIndex> index, const ArchiveMember& member, const ResolvedFile& file)
+        : index_(std::move(index)), member_(member), file_(file), reader_(file_) {}
+
+    bool open(std::string& error) {
+        if (index_->kind == ArchiveIndex::Kind::Tar) {
+            data_at_ = member_.offset;
+            return true;
+        }
+        if (index_->kind == ArchiveIndex::Kind::Zip) {
+            unsigned char local[30];
+            if (reader_.read(reinterpret_cast<char*>(local), sizeof(local), member_.offset) != sizeof(local) || load_le32(local) != 0x04034b50) {
+                error = "Corrupt zip local header";
+                return false;
+            }
+            data_at_ = member_.offset + 30 + load_le16(local + 26) + load_le16(local + 28);
+            if (data_at_ > file_.size || member_.packed > file_.size - data_at_) {
+                error = "Zip member extends past the end of the archive";
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::size_t read(char* buf, std::size_t n, std::uint64_t offset) {
+        if (offset >= member_.size) return 0;
+        n = static_cast<std::size_t>(std::min<std::uint64_t>(n, member_.size - offset));
+        const bool in_place = index_->kind == ArchiveIndex::Kind::Tar ||
+            (index_->kind == ArchiveIndex::Kind::Zip && member_.method == 0);
+        if (in_place) return reader_.read(buf, n, data_at_ + offset);
+#ifdef CPPHTTPLIB_ZLIB_SUPPORT
+        const bool gz = index_->kind == ArchiveIndex::Kind::TarGz;
+        const std::uint64_t target = (gz ? member_.offset : 0) + offset;
+        const GzipAccessPoint* point = gz ? best_point(target) : nullptr;
+        if (!inflate_ || target < inflate_->pos() || (point && point->out > inflate_->pos())) {
+            inflate_ = std::make_unique<InflateReader>(file_);
+            const bool opened = point ? inflate_->open_at(*point) : gz ? inflate_->open_gzip() : inflate_->open_deflate(data_at_);
+            if (!opened) return 0;
+        }
+        if (!inflate_->skip(target - inflate_->pos())) return 0;
+        return inflate_->read(buf, n);
+#else
+        return 0;
+#endif
+    }
+
+private:
+    const GzipAccessPoint* best_point(std::uint64_t target) const {
+        const auto& points = index_->points;
+        auto it = std::upper_bound(points.begin(), points.end(), target,
+            [](std::uint64_t t, const GzipAccessPoint& p) { return t < p.out; });
+        return it == points.begin() ? nullptr : &*(it - 1);
+    }
+
+    std::shared_ptr<const ArchiveIndex> index_;
+    ArchiveMember member_;
+    ResolvedFile file_;
+    SegmentReader reader_;
+    std::uint64_t data_at_ = 0;
+#ifdef CPPHTTPLIB_ZLIB_SUPPORT
+    std::unique_ptr<InflateReader> inflate_;
+#endif
+};
+
+bool is_archive_name(const std::string& name) {
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    for (const char* ext : { ".zip", ".tar", ".tgz", ".tar.gz", ".jar" }) {
+        const std::size_t n = std::strlen(ext);
+        if (lower.size() > n && lower.compare(lower.size() - n, n, ext) == 0) return true;
+    }
+    return false;
+}
+
+// GET /file?archive=MEMBER on a zip/tar/tar.gz: an HTML listing for "" or a
+// directory inside, the member's bytes for a file. False without the parameter.
+bool answer_archive_query(const httplib::Request& req, httplib::Response& res, const ResolvedFile& file, const std::string& rel) {
+    if (!req.has_param("archive")) return false;
+    int status = 0;
+    std::string error;
+    auto index = g_archives.get(file, status, error);
+    if (!index) {
+        res.status = status;
+        if (status == 503) res.set_header("Retry-After", "5");
+        res.set_content(error, "text/plain");
+        return true;
+    }
+    std::string name;
+    bool ignored = false;
+    archive_member_name(req.get_param_value("archive"), name, ignored);
+
+    const ArchiveMember* member = name.empty() ? nullptr : index->find(name);
+    if (member && !member->dir) {
+        if (member->encrypted || (index->kind == ArchiveIndex::Kind::Zip && member->method != 0 && member->method != 8)) {
+            res.status = 415;
+            res.set_content("Unsupported archive member (encrypted or unknown compression method)", "text/plain");
+            return true;
+        }
+#ifndef CPPHTTPLIB_ZLIB_SUPPORT
+        if (member->method == 8) {
+            res.status = 415;
+            res.set_content("Compressed zip members are not supported by this build", "text/plain");
+            return true;
+        }
+#endif
+        auto stream = std::make_shared<ArchiveMemberStream>(index, *member, file);
+        if (!stream->open(error)) {
+            res.status = 422;
+            res.set_content(error, "text/plain");
+            return true;
+        }
+        const std::string ip = req.remote_addr;
+        if (member->mtime > 0) res.set_header("Last-Modified", http_date(member->mtime));
+        res.set_content_provider(static_cast<size_t>(member->size), std::string(get_content_type(member->name)),
+            [stream, ip](size_t offset, size_t length, httplib::DataSink& sink) {
+                std::vector<char> buf(std::min<std::size_t>(length, ARCHIVE_BLOCK));
+                const std::size_t got = stream->read(buf.data(), buf.size(), offset);
+                if (got == 0) return false;
+                if (g_outbound.enabled()) g_outbound.acquire(ip, got);
+                return sink.write(buf.data(), got);
+            });
+        return true;
+    }
+
+    // Directory listing: children of `name`, with directories implied by deeper paths.
+    const std::string prefix = name.empty() ? std::string() : name + "/";
+    std::set<std::string> dirs;
+    std::vector<const ArchiveMember*> files;
+    for (auto it = index->lower_bound(prefix); it != index->members.end() && it->name.compare(0, prefix.size(), prefix) == 0; ++it) {
+        const std::string rest = it->name.substr(prefix.size());
+        const std::size_t slash = rest.find('/');
+        if (slash != std::string::npos) dirs.insert(rest.substr(0, slash));
+        else if (it->dir) dirs.insert(rest);
+        else files.push_back(&*it);
+    }
+    if (!name.empty() && !member && dirs.empty() && files.empty()) {
+        res.status = 404;
+        res.set_content("No such archive member", "text/plain");
+        return true;
+    }
+
+    const std::string self = "/" + url_encode_path(rel);
+    std::string parent_link;
+    if (name.empty()) {
+        const std::string parent = fs::u8path(rel).parent_path().u8string();
+        parent_link = parent.empty() ? "/" : "/" + url_encode_path(parent);
+    }
+    else {
+        const std::size_t slash = name.rfind('/');
+        parent_link = self + "?archive=" + (slash == std::string::npos ? std::string() : url_encode(name.substr(0, slash)));
+    }
+    std::stringstream html;
+    html << "<!DOCTYPE html>\n"
+        << "<html lang='en'>\n"
+        << "<head>\n"
+        << "  <meta charset='UTF-8'>\n"
+        << "  <meta name='viewport' content='width=device-width, initial-scale=1.0'>\n"
+        << "  <title>ArtWeb</title>\n"
+        << "  <style>\n"
+        << "    body { font-family: Arial, sans-serif; background-color: #f0f0f0; margin: 0; padding: 0; }\n"
+        << "    .container { max-width: 800px; margin: 50px auto; background: #fff; padding: 20px; border-radius: 8px; box-shadow: 0 0 10px rgba(0,0,0,0.1); }\n"
+        << "    h1 { color: #333; word-break: break-all; }\n"
+        << "    ul { list-style: none; padding: 0; }\n"
+        << "    ul li { margin-bottom: 8px; }\n"
+        << "    ul li a { text-decoration: none; color: #007ACC; }\n"
+        << "    ul li a:hover { text-decoration: underline; }\n"
+        << "    .size { color: #777; font-size: 0.9em; }\n"
+        << "    .footer { text-align: center; font-size: 0.8em; color: #777; margin-top: 30px; }\n"
+        << "  </style>\n"
+        << "</head>\n"
+        << "<body>\n"
+        << "  <div class='container'>\n"
+        << "    <h1>Files in /" << html_escape(rel) << (name.empty() ? "" : "/" + html_escape(name)) << "</h1>\n"
+        << "    <ul>\n"
+        << "      <li><a href='" << parent_link << u8"'>.. [↩ parent] </a></li>\n";
+    for (const auto& d : dirs) {
+        html << u8"      <li>📁 <a href='" << self << "?archive=" << url_encode(prefix + d) << "'>" << html_escape(d) << "/</a></li>\n";
+    }
+    for (const ArchiveMember* f : files) {
+        html << u8"      <li>🗎 <a href='" << self << "?archive=" << url_encode(f->name) << "'>" << html_escape(f->name.substr(prefix.size()))
+            << "</a> <span class='size'>" << f->size << " bytes</span></li>\n";
+    }
+    html << "    </ul>\n"
+        << "    <div class='footer'>Version " << VERSION << "</div>\n"
+        << "  </div>\n"
+        << "</body>\n"
+        << "</html>\n";
+    res.set_content(html.str(), "text/html; charset=utf-8");
+    return true;
+}
+
+// Unified Browse/Download Handler (for non-root paths)
+void browse_handler(const httplib::Request& req, httplib::Response& res) {
+    if (!authenticate(req, res)) return;
+
+    std::string dir = req.matches[1];
+    dir = url_decode(dir);
+    if (dir.empty()) dir = ".";
+
+    fs::path reqPath(dir);
+    if (reqPath.is_absolute() || dir.find("..") != std::string::npos) {
+        res.status = 400;
+        res.set_content("Invalid path", "text/plain");
+        return;
+    }
+    fs::path fs_path = fs::u8path(dir);
+    ResolvedFile target;
+    const auto status = resolve_cached(g_root, dir, target);
+    if (status == ResolveStatus::NotFound) {
+        res.status = 404;
+        res.set_content("Not found", "text/plain");
+        return;
+    }
+    if (status != ResolveStatus::Ok) {
+        res.status = 403;
+        res.set_content("Access denied", "text/plain");
+        return;
+    }
+    if (target.is_regular) {
+        if (answer_archive_query(req, res, target, dir)) return;
+        const std::string_view content_type = get_content_type(dir);
+
+        // Only force download for unknown/binary types (text-like types carry a charset)
+        const bool likely_binary =
+            (content_type == "application/octet-stream") ||
+            (content_type.rfind("application/", 0) == 0 &&
+                content_type.find("charset=") == std::string_view::npos &&
+                content_type != "application/pdf");
+
+        if (likely_binary) {
+            res.set_header("Content-Disposition",
+                "attachment; filename=\"" + fs_path.filename().u8string() + "\"");
+        }
+        if (answer_hash_query(req, res, target, fs_path.filename().u8string())) return;
+        if (answer_signature_query(req, res, target)) return;
+        if (answer_tail_query(req, res, target, dir)) return;
+        if (answer_lines_query(req, res, target)) return;
+        if (answer_from_metadata(req, res, target, content_type)) return;
+        stream_resolved_file(req, res, target, content_type);
+        return;
+    }
+
+    if (answer_grep_query(req, res, fs_path, dir)) return;
+    if (answer_find_query(req, res, fs_path, dir)) return;
+    if (answer_du_query(req, res, fs_path, dir)) return;
+
+    // --- HTML directory listing ---
+    std::stringstream html;
+    html << "<!DOCTYPE html>\n"
+        << "<html lang='en'>\n"
         << "<head>\n"
         << "  <meta charset='UTF-8'>\n"
         << "  <meta name='viewport' content='width=device-width, initial-scale=1.0'>\n"
@@ -868,250 +7455,1966 @@ void browse_handler(const httplib::Request& req, httplib::Response& res) {
         << "      <input type='submit' value='Upload'/>\n"
         << "      <progress id='uploadProgress' value='0' max='100'></progress>\n"
         << "    </form>\n"
+        << "    <form id='folderForm' method='POST' action='/upload_tar?dir=" << url_encode(dir) << "'>\n"
+        << "      <input type='file' id='folderInput' webkitdirectory multiple/>\n"
+        << "      <input type='submit' value='Upload folder'/>\n"
+        << "    </form>\n"
         << "    <div id='dropZone'>Drag & drop files here to upload</div>\n"
         << "    <h1>Files in " << ((dir == ".") ? "/" : ("/" + dir)) << "</h1>\n"
         << "    <ul>\n";
 
-    if (dir != ".") {
-        fs::path currentPath = fs::u8path(dir);
-        fs::path parent = currentPath.parent_path();
+    if (dir != ".") {
+        fs::path currentPath = fs::u8path(dir);
+        fs::path parent = currentPath.parent_path();
+
+        std::string parent_str = parent.empty() ? "." : parent.u8string();
+        std::string parent_link = (parent_str == ".") ? "/" : ("/" + url_encode_path(parent_str));
+        html << "      <li><a href='" << parent_link << u8"'>.. [↩ parent] </a></li>\n";
+    }
+
+    std::vector<std::pair<std::string, fs::path>> directories, files;
+    std::vector<std::string> indexed_dirs, indexed_files;
+    if (g_tree_index.list(dir, indexed_dirs, indexed_files)) {
+        for (auto& name : indexed_dirs) directories.push_back({ name, fs_path / fs::u8path(name) });
+        for (auto& name : indexed_files) files.push_back({ name, fs_path / fs::u8path(name) });
+    }
+    else try {
+        for (const auto& entry : fs::directory_iterator(fs_path)) {
+            std::string name = entry.path().filename().u8string();
+            if (fs::is_directory(entry.path())) directories.push_back({ name, entry.path() });
+            else if (fs::is_regular_file(entry.path())) files.push_back({ name, entry.path() });
+        }
+    }
+    catch (...) {
+        res.status = 403;
+        res.set_content("Access denied", "text/plain");
+        return;
+    }
+    std::sort(directories.begin(), directories.end(), [](auto const& a, auto const& b) { return a.first < b.first; });
+    std::sort(files.begin(), files.end(), [](auto const& a, auto const& b) { return a.first < b.first; });
+    const std::string base_href = (dir == ".") ? "" : (url_encode_path(dir) + "/");
+    for (const auto& p : directories) html << u8"      <li>📁 <a href='/" << base_href << url_encode(p.first) << "'>" << p.first << "/</a></li>\n";
+    for (const auto& p : files) {
+        html << u8"      <li>🗎 <a href='/" << base_href << url_encode(p.first) << "'>" << p.first << "</a>";
+        if (is_archive_name(p.first)) html << " <a href='/" << base_href << url_encode(p.first) << "?archive='>[browse]</a>";
+        html << "</li>\n";
+    }
+    html << "    </ul>\n"
+        << "    <div class='footer'>Version " << VERSION << "</div>\n"
+        << "  </div>\n"
+        << "  <script>\n";
+
+    if (!g_proxy_upload_mode) {
+        // Old upload behavior: one POST request for the entire file.
+        html
+            << "    document.getElementById('uploadForm').addEventListener('submit', function(event) {\n"
+            << "      event.preventDefault();\n"
+            << "      var fileInput = document.querySelector('input[type=\"file\"]');\n"
+            << "      if (!fileInput.files.length) { alert('Please select a file.'); return; }\n"
+            << "      var formData = new FormData(); formData.append('file', fileInput.files[0]);\n"
+            << "      var xhr = new XMLHttpRequest(); xhr.open('POST', document.getElementById('uploadForm').action, true);\n"
+            << "      xhr.upload.addEventListener('progress', function(e) {\n"
+            << "        if (e.lengthComputable) {\n"
+            << "          var percentComplete = Math.round((e.loaded / e.total) * 100);\n"
+            << "          document.getElementById('uploadProgress').value = percentComplete;\n"
+            << "        }\n"
+            << "      });\n"
+            << "      xhr.onloadstart = function() { document.getElementById('uploadProgress').style.display = 'block'; };\n"
+            << "      xhr.onloadend = function() {\n"
+            << "        document.getElementById('uploadProgress').style.display = 'none';\n"
+            << "        if (xhr.status === 200) { alert('Upload complete!'); window.location.reload(); }\n"
+            << "        else { alert('Upload failed.'); }\n"
+            << "      };\n"
+            << "      xhr.send(formData);\n"
+            << "    });\n"
+            << "    var dropZone = document.getElementById('dropZone');\n"
+            << "    dropZone.addEventListener('dragover', function(e) { e.preventDefault(); dropZone.style.backgroundColor = '#e0e0e0'; });\n"
+            << "    dropZone.addEventListener('dragleave', function(e) { e.preventDefault(); dropZone.style.backgroundColor = ''; });\n"
+            << "    dropZone.addEventListener('drop', function(e) {\n"
+            << "      e.preventDefault(); dropZone.style.backgroundColor = '';\n"
+            << "      var files = e.dataTransfer.files; if (files.length === 0) return;\n"
+            << "      var formData = new FormData(); formData.append('file', files[0]);\n"
+            << "      var xhr = new XMLHttpRequest(); xhr.open('POST', document.getElementById('uploadForm').action, true);\n"
+            << "      xhr.upload.addEventListener('progress', function(e) {\n"
+            << "        if (e.lengthComputable) {\n"
+            << "          var percentComplete = Math.round((e.loaded / e.total) * 100);\n"
+            << "          document.getElementById('uploadProgress').value = percentComplete;\n"
+            << "        }\n"
+            << "      });\n"
+            << "      xhr.onloadstart = function() { document.getElementById('uploadProgress').style.display = 'block'; };\n"
+            << "      xhr.onloadend = function() {\n"
+            << "        document.getElementById('uploadProgress').style.display = 'none';\n"
+            << "        if (xhr.status === 200) { alert('Upload complete!'); window.location.reload(); }\n"
+            << "        else { alert('Upload failed.'); }\n"
+            << "      };\n"
+            << "      xhr.send(formData);\n"
+            << "    });\n";
+    }
+    else {
+        // Proxy-safe upload behavior: small files use single POST, large files are chunked.
+        html
+            << "    function uploadSingle(file) {\n"
+            << "      var formData = new FormData(); formData.append('file', file);\n"
+            << "      var xhr = new XMLHttpRequest(); xhr.open('POST', document.getElementById('uploadForm').action, true);\n"
+            << "      xhr.upload.addEventListener('progress', function(e) {\n"
+            << "        if (e.lengthComputable) {\n"
+            << "          var percentComplete = Math.round((e.loaded / e.total) * 100);\n"
+            << "          document.getElementById('uploadProgress').value = percentComplete;\n"
+            << "        }\n"
+            << "      });\n"
+            << "      xhr.onloadstart = function() { document.getElementById('uploadProgress').style.display = 'block'; };\n"
+            << "      xhr.onloadend = function() {\n"
+            << "        document.getElementById('uploadProgress').style.display = 'none';\n"
+            << "        if (xhr.status === 200) { alert('Upload complete!'); window.location.reload(); }\n"
+            << "        else { alert('Upload failed.'); }\n"
+            << "      };\n"
+            << "      xhr.send(formData);\n"
+            << "    }\n"
+            << "    function uploadChunked(file) {\n"
+            << "      var chunkSize = 128 * 1024; // 128 KiB\n"
+            << "      var totalChunks = Math.ceil(file.size / chunkSize);\n"
+            << "      var uploadId = Date.now().toString(36) + Math.random().toString(36).slice(2);\n"
+            << "      var baseUrl = document.getElementById('uploadForm').action;\n"
+            << "      var progressEl = document.getElementById('uploadProgress');\n"
+            << "      progressEl.value = 0;\n"
+            << "      progressEl.style.display = 'block';\n"
+            << "      var maxRetries = 5;\n"
+            << "      function sendChunk(i, attempt) {\n"
+            << "        var start = i * chunkSize;\n"
+            << "        var end = Math.min(start + chunkSize, file.size);\n"
+            << "        var blob = file.slice(start, end);\n"
+            << "        var url = baseUrl + (baseUrl.indexOf('?') >= 0 ? '&' : '?') +\n"
+            << "          'upload_id=' + encodeURIComponent(uploadId) +\n"
+            << "          '&chunk_index=' + encodeURIComponent(String(i)) +\n"
+            << "          '&total_chunks=' + encodeURIComponent(String(totalChunks)) +\n"
+            << "          '&offset=' + encodeURIComponent(String(start)) +\n"
+            << "          '&file_size=' + encodeURIComponent(String(file.size));\n"
+            << "        var formData = new FormData();\n"
+            << "        formData.append('file', blob, file.name);\n"
+            << "        var xhr = new XMLHttpRequest(); xhr.open('POST', url, true);\n"
+            << "        xhr.upload.addEventListener('progress', function(e) {\n"
+            << "          if (e.lengthComputable) {\n"
+            << "            var loaded = start + e.loaded;\n"
+            << "            var percentComplete = Math.round((loaded / file.size) * 100);\n"
+            << "            progressEl.value = percentComplete;\n"
+            << "          }\n"
+            << "        });\n"
+            << "        xhr.onload = function() {\n"
+            << "          if (xhr.status === 200) {\n"
+            << "            if (i + 1 < totalChunks) { sendChunk(i + 1, 0); }\n"
+            << "            else { progressEl.style.display = 'none'; alert('Upload complete!'); window.location.reload(); }\n"
+            << "          } else {\n"
+            << "            if (attempt < maxRetries) {\n"
+            << "              setTimeout(function(){ sendChunk(i, attempt + 1); }, 500 * (attempt + 1));\n"
+            << "            } else {\n"
+            << "              progressEl.style.display = 'none'; alert('Upload failed.');\n"
+            << "            }\n"
+            << "          }\n"
+            << "        };\n"
+            << "        xhr.onerror = function() {\n"
+            << "          if (attempt < maxRetries) {\n"
+            << "            setTimeout(function(){ sendChunk(i, attempt + 1); }, 500 * (attempt + 1));\n"
+            << "          } else {\n"
+            << "            progressEl.style.display = 'none'; alert('Upload failed.');\n"
+            << "          }\n"
+            << "        };\n"
+            << "        xhr.send(formData);\n"
+            << "      }\n"
+            << "      sendChunk(0, 0);\n"
+            << "    }\n"
+            << "    function startUpload(file) {\n"
+            << "      var CHUNK_THRESHOLD = 300 * 1024; // 300 KB\n"
+            << "      if (file.size > CHUNK_THRESHOLD) uploadChunked(file);\n"
+            << "      else uploadSingle(file);\n"
+            << "    }\n"
+            << "    document.getElementById('uploadForm').addEventListener('submit', function(event) {\n"
+            << "      event.preventDefault();\n"
+            << "      var fileInput = document.querySelector('input[type=\"file\"]');\n"
+            << "      if (!fileInput.files.length) { alert('Please select a file.'); return; }\n"
+            << "      startUpload(fileInput.files[0]);\n"
+            << "    });\n"
+            << "    var dropZone = document.getElementById('dropZone');\n"
+            << "    dropZone.addEventListener('dragover', function(e) { e.preventDefault(); dropZone.style.backgroundColor = '#e0e0e0'; });\n"
+            << "    dropZone.addEventListener('dragleave', function(e) { e.preventDefault(); dropZone.style.backgroundColor = ''; });\n"
+            << "    dropZone.addEventListener('drop', function(e) {\n"
+            << "      e.preventDefault(); dropZone.style.backgroundColor = '';\n"
+            << "      var files = e.dataTransfer.files; if (files.length === 0) return;\n"
+            << "      startUpload(files[0]);\n"
+            << "    });\n";
+    }
+
+    // Folder upload: pack the selected tree into a single tar stream (blobs are
+    // referenced, not copied, so large folders do not end up in browser memory).
+    html
+        << "    function tarOctal(h, off, len, val) {\n"
+        << "      if (val >= Math.pow(8, len - 1)) {\n"
+        << "        h[off] = 0x80;\n"
+        << "        for (var i = len - 1; i > 0; i--) { h[off + i] = val % 256; val = Math.floor(val / 256); }\n"
+        << "        return;\n"
+        << "      }\n"
+        << "      var s = val.toString(8);\n"
+        << "      while (s.length < len - 1) s = '0' + s;\n"
+        << "      for (var i = 0; i < len - 1; i++) h[off + i] = s.charCodeAt(i);\n"
+        << "      h[off + len - 1] = 0;\n"
+        << "    }\n"
+        << "    function tarHeader(nameBytes, size, mtime, type) {\n"
+        << "      var h = new Uint8Array(512);\n"
+        << "      h.set(nameBytes.subarray(0, 100), 0);\n"
+        << "      tarOctal(h, 100, 8, 420); tarOctal(h, 108, 8, 0); tarOctal(h, 116, 8, 0);\n"
+        << "      tarOctal(h, 124, 12, size); tarOctal(h, 136, 12, mtime);\n"
+        << "      h[156] = type.charCodeAt(0);\n"
+        << "      h.set([117, 115, 116, 97, 114, 0, 48, 48], 257);\n"
+        << "      for (var i = 148; i < 156; i++) h[i] = 32;\n"
+        << "      var sum = 0; for (var i = 0; i < 512; i++) sum += h[i];\n"
+        << "      tarOctal(h, 148, 7, sum); h[155] = 32;\n"
+        << "      return h;\n"
+        << "    }\n"
+        << "    function buildTar(files) {\n"
+        << "      var enc = new TextEncoder(); var parts = [];\n"
+        << "      function pad(n) { if (n % 512) parts.push(new Uint8Array(512 - n % 512)); }\n"
+        << "      for (var i = 0; i < files.length; i++) {\n"
+        << "        var f = files[i];\n"
+        << "        var name = enc.encode(f.webkitRelativePath || f.name);\n"
+        << "        var mtime = Math.floor((f.lastModified || Date.now()) / 1000);\n"
+        << "        if (name.length > 100) {\n"
+        << "          var ln = new Uint8Array(name.length + 1); ln.set(name, 0);\n"
+        << "          parts.push(tarHeader(enc.encode('././@LongLink'), ln.length, 0, 'L'), ln); pad(ln.length);\n"
+        << "        }\n"
+        << "        parts.push(tarHeader(name, f.size, mtime, '0'), f); pad(f.size);\n"
+        << "      }\n"
+        << "      parts.push(new Uint8Array(1024));\n"
+        << "      return new Blob(parts, { type: 'application/x-tar' });\n"
+        << "    }\n"
+        << "    document.getElementById('folderForm').addEventListener('submit', function(event) {\n"
+        << "      event.preventDefault();\n"
+        << "      var input = document.getElementById('folderInput');\n"
+        << "      if (!input.files.length) { alert('Please select a folder.'); return; }\n"
+        << "      var xhr = new XMLHttpRequest(); xhr.open('POST', document.getElementById('folderForm').action, true);\n"
+        << "      xhr.setRequestHeader('Content-Type', 'application/x-tar');\n"
+        << "      xhr.upload.addEventListener('progress', function(e) {\n"
+        << "        if (e.lengthComputable) {\n"
+        << "          document.getElementById('uploadProgress').value = Math.round((e.loaded / e.total) * 100);\n"
+        << "        }\n"
+        << "      });\n"
+        << "      xhr.onloadstart = function() { document.getElementById('uploadProgress').style.display = 'block'; };\n"
+        << "      xhr.onloadend = function() {\n"
+        << "        document.getElementById('uploadProgress').style.display = 'none';\n"
+        << "        if (xhr.status === 200) { alert(xhr.responseText); window.location.reload(); }\n"
+        << "        else { alert('Upload failed. ' + xhr.responseText); }\n"
+        << "      };\n"
+        << "      xhr.send(buildTar(input.files));\n"
+        << "    });\n";
+
+    html << "  </script>\n"
+        << "</body>\n"
+        << "</html>";
+    res.set_content(html.str(), "text/html; charset=utf-8");
+}
+
+// Check if a port is free by attempting to bind
+bool is_port_free(int port) {
+#ifdef _WIN32
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) return false;
+#endif
+    int sockfd = socket(AF_INET, SOCK_STREAM, 0);
+    if (sockfd < 0) {
+#ifdef _WIN32
+        WSACleanup();
+#endif
+        return false;
+    }
+    struct sockaddr_in addr;
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = INADDR_ANY;
+    int result = bind(sockfd, (struct sockaddr*)&addr, sizeof(addr));
+#ifdef _WIN32
+    closesocket(sockfd);
+    WSACleanup();
+#else
+    close(sockfd);
+#endif
+    return (result == 0);
+}
+
+// Static Content Server Handler
+void serve_static_content_handler(const httplib::Request& req, httplib::Response& res) {
+    if (!authenticate(req, res)) return;
+
+    auto relative_path_str = req.matches[1].str();
+    if (relative_path_str.empty() || relative_path_str.back() == '/') {
+        relative_path_str += "index.html";
+    }
+    ResolvedFile file;
+    const auto status = resolve_cached(g_root, relative_path_str, file);
+    if (status == ResolveStatus::Forbidden) {
+        res.status = 403;
+        res.set_content("Forbidden: Access denied.", "text/plain");
+        return;
+    }
+    if (status == ResolveStatus::NotFound || (status == ResolveStatus::Ok && !file.is_regular)) {
+        res.status = 404;
+        res.set_content("Not Found", "text/plain");
+        return;
+    }
+    if (status != ResolveStatus::Ok) {
+        res.status = 500;
+        res.set_content("Internal Server Error: Could not read file.", "text/plain");
+        return;
+    }
+    if (answer_hash_query(req, res, file, fs::u8path(relative_path_str).filename().u8string())) return;
+    const std::string_view content_type = get_content_type(relative_path_str);
+    if (answer_from_metadata(req, res, file, content_type)) return;
+    stream_resolved_file(req, res, file, content_type);
+}
+
+// ------------------------ Embedded web root ------------------------
+
+// One file compiled into the executable. The table is generated by
+// `ArtWeb --embed-gen DIR ArtWeb/artweb_embedded.h` and built in with ARTWEB_EMBED.
+struct EmbeddedAsset {
+    std::string_view path;          // URL path, always starting with '/'
+    std::string_view content_type;  // MIME type with charset already applied
+    std::string_view etag;          // quoted strong ETag
+    std::string_view data;
+    std::string_view gzip;          // precompressed variant, empty if not worth it
+};
+
+#ifdef ARTWEB_EMBED
+#include "artweb_embedded.h"        // defines g_embedded_assets[], sorted by path
+#endif
+
+bool g_embedded_mode = false;       // --embedded: serve the compiled-in site
+
+#ifdef ARTWEB_EMBED
+const EmbeddedAsset* find_embedded_asset(std::string_view path) {
+    auto first = std::begin(g_embedded_assets);
+    auto last = std::end(g_embedded_assets);
+    auto it = std::lower_bound(first, last, path,
+        [](const EmbeddedAsset& a, std::string_view p) { return a.path < p; });
+    return (it != last && it->path == path) ? &*it : nullptr;
+}
+
+// Serve from the compiled-in table; returns false when the path is not embedded.
+// Bodies are handed to httplib straight from read-only memory (no copy, ranges work).
+bool serve_embedded(const httplib::Request& req, httplib::Response& res) {
+    std::string path = "/" + req.matches[1].str();
+    if (path.back() == '/') path += "index.html";
+    const EmbeddedAsset* asset = find_embedded_asset(path);
+    if (!asset) return false;
+
+    std::string_view body = asset->data;
+    std::string etag(asset->etag);
+    if (!asset->gzip.empty()) {
+        res.set_header("Vary", "Accept-Encoding");
+        if (req.get_header_value("Accept-Encoding").find("gzip") != std::string::npos) {
+            res.set_header("Content-Encoding", "gzip");
+            body = asset->gzip;
+            etag = gzip_etag(etag);
+        }
+    }
+
+    res.set_header("ETag", etag);
+    if (req.get_header_value("If-None-Match") == etag) {
+        res.status = 304;
+        return true;
+    }
+    res.status = 200;
+    res.set_content_provider(body.size(), std::string(asset->content_type),
+        [body](size_t offset, size_t length, httplib::DataSink& sink) {
+            return sink.write(body.data() + offset, length);
+        });
+    return true;
+}
+#endif
+
+// Embedded mode handler: compiled-in assets first, then the --index directory if one was given.
+void serve_embedded_handler(const httplib::Request& req, httplib::Response& res) {
+    if (!authenticate(req, res)) return;
+#ifdef ARTWEB_EMBED
+    if (serve_embedded(req, res)) return;
+#endif
+    if (!g_web_root_path.empty()) {
+        serve_static_content_handler(req, res);
+        return;
+    }
+    res.status = 404;
+    res.set_content("Not Found", "text/plain");
+}
+
+// Build-time generator: writes DIR as a C++ header for ARTWEB_EMBED builds.
+// ETag is FNV-1a/64 of the content; gzip variants are produced when zlib is available.
+int generate_embedded_header(const std::string& dir, const std::string& out_path) {
+    std::error_code ec;
+    if (!fs::is_directory(fs::u8path(dir), ec)) {
+        std::cerr << "Error: --embed-gen needs a directory: " << dir << std::endl;
+        return 1;
+    }
+
+    std::vector<std::pair<std::string, fs::path>> files;
+    for (auto it = fs::recursive_directory_iterator(fs::u8path(dir), ec); !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+        if (!it->is_regular_file()) continue;
+        std::string rel = fs::relative(it->path(), fs::u8path(dir)).generic_u8string();
+        files.push_back({ "/" + rel, it->path() });
+    }
+    std::sort(files.begin(), files.end());
+
+    std::ofstream out(fs::u8path(out_path), std::ios::binary);
+    if (!out) {
+        std::cerr << "Error: Cannot write " << out_path << std::endl;
+        return 1;
+    }
+
+    auto emit_array = [&out](const std::string& name, const std::string& bytes) {
+        out << "static constexpr char " << name << "[] = {";
+        if (bytes.empty()) out << "0";
+        for (size_t i = 0; i < bytes.size(); ++i) {
+            if (i % 24 == 0) out << "\n    ";
+            out << static_cast<int>(static_cast<signed char>(bytes[i])) << ",";
+        }
+        out << "\n};\n";
+    };
+    auto escape = [](const std::string& v) {
+        std::string r;
+        for (char c : v) {
+            if (c == '"' || c == '\\') r.push_back('\\');
+            r.push_back(c);
+        }
+        return r;
+    };
+
+    out << "// Generated by ArtWeb --embed-gen from " << escape(dir) << ". Do not edit.\n"
+        << "#pragma once\n\n";
+
+    std::ostringstream table;
+    for (size_t i = 0; i < files.size(); ++i) {
+        std::ifstream ifs(files[i].second, std::ios::binary);
+        std::ostringstream oss;
+        oss << ifs.rdbuf();
+        const std::string content = oss.str();
+
+        const std::string etag = make_etag(fnv1a64(content.data(), content.size()), content.size());
+
+        const std::string_view content_type = get_content_type(files[i].first);
+        const std::string gz = precompress_asset(content, content_type);
+
+        const std::string name = "artweb_asset_" + std::to_string(i);
+        emit_array(name, content);
+        if (!gz.empty()) emit_array(name + "_gz", gz);
+
+        table << "    { \"" << escape(files[i].first) << "\", \"" << content_type << "\", \""
+            << escape(etag) << "\", std::string_view(" << name << ", " << content.size() << "), "
+            << (gz.empty() ? std::string("std::string_view()")
+                : "std::string_view(" + name + "_gz, " + std::to_string(gz.size()) + ")")
+            << " },\n";
+    }
+
+    out << "\nstatic constexpr EmbeddedAsset g_embedded_assets[] = {\n" << table.str();
+    if (files.empty()) out << "    { \"/\", \"text/plain\", \"\\\"0\\\"\", std::string_view(), std::string_view() },\n";
+    out << "};\n";
+
+    std::cout << "Embedded " << files.size() << " files into " << out_path << "\n";
+    return out ? 0 : 1;
+}
+
+// ------------------------ Site bundle ------------------------
+
+// Single-file site bundle (--bundle-build / --bundle), mmapped at startup.
+// Layout (little-endian):
+//   BundleHeader | BundleEntry[entry_count] | uint32 slots[slot_count] | path bytes | blobs
+// slots is an open-addressing table keyed by fnv1a64(path), holding entry index + 1
+// (0 = empty). Blobs start on 4 KiB boundaries and may have a gzip variant.
+const char BUNDLE_MAGIC[8] = { 'A', 'R', 'T', 'W', 'B', 'N', 'D', 'L' };
+const std::uint32_t BUNDLE_VERSION = 1;
+const std::uint32_t BUNDLE_BYTE_ORDER = 0x01020304;
+const std::uint64_t BUNDLE_ALIGN = 4096;
+
+struct BundleHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    std::uint64_t file_size;
+    std::uint32_t entry_count;
+    std::uint32_t slot_count;      // power of two
+    std::uint64_t entries_offset;
+    std::uint64_t slots_offset;
+    std::uint64_t strings_offset;
+    std::uint64_t strings_size;
+};
+
+struct BundleEntry {
+    std::uint64_t path_hash;
+    std::uint64_t path_offset;     // relative to strings_offset
+    std::uint32_t path_len;
+    std::uint32_t reserved;
+    std::uint64_t data_offset;
+    std::uint64_t data_size;
+    std::uint64_t gzip_offset;
+    std::uint64_t gzip_size;       // 0 = no gzip variant
+    std::uint64_t fingerprint;     // fnv1a64 of the content, used for the ETag
+    std::int64_t mtime;
+};
+
+static_assert(sizeof(BundleHeader) == 64, "BundleHeader layout");
+static_assert(sizeof(BundleEntry) == 72, "BundleEntry layout");
+
+// The mapped bundle used by --bundle. Read-only for the whole process lifetime.
+struct SiteBundle {
+    const char* base = nullptr;
+    std::uint64_t size = 0;
+    const BundleHeader* header = nullptr;
+    const BundleEntry* entries = nullptr;
+    const std::uint32_t* slots = nullptr;
+    const char* strings = nullptr;
+};
+
+SiteBundle g_bundle;
+std::string g_bundle_path;          // --bundle FILE
+
+// Map and validate a bundle. Every offset is checked against the file size
+// before anything is dereferenced, so a truncated or foreign file is rejected.
+bool load_bundle(const std::string& path, SiteBundle& bundle, std::string& error) {
+    std::uint64_t size = 0;
+    const char* base = nullptr;
+#ifdef _WIN32
+    HANDLE file = CreateFileW(utf8_to_wstring(path).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) { error = "cannot open file"; return false; }
+    LARGE_INTEGER li;
+    if (!GetFileSizeEx(file, &li)) { CloseHandle(file); error = "cannot stat file"; return false; }
+    size = static_cast<std::uint64_t>(li.QuadPart);
+    if (size < sizeof(BundleHeader)) { CloseHandle(file); error = "file too small"; return false; }
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping) { error = "cannot map file"; return false; }
+    base = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    CloseHandle(mapping);
+    if (!base) { error = "cannot map file"; return false; }
+#else
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) { error = "cannot open file"; return false; }
+    struct stat st;
+    if (fstat(fd, &st) != 0) { close(fd); error = "cannot stat file"; return false; }
+    size = static_cast<std::uint64_t>(st.st_size);
+    if (size < sizeof(BundleHeader)) { close(fd); error = "file too small"; return false; }
+    void* m = mmap(nullptr, static_cast<size_t>(size), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (m == MAP_FAILED) { error = "cannot map file"; return false; }
+    base = static_cast<const char*>(m);
+#endif
+
+    auto fail = [&](const char* msg) {
+#ifdef _WIN32
+        UnmapViewOfFile(base);
+#else
+        munmap(const_cast<char*>(base), static_cast<size_t>(size));
+#endif
+        error = msg;
+        return false;
+    };
+    auto in_bounds = [size](std::uint64_t offset, std::uint64_t len) {
+        return offset <= size && len <= size - offset;
+    };
+
+    const auto* h = reinterpret_cast<const BundleHeader*>(base);
+    if (std::memcmp(h->magic, BUNDLE_MAGIC, sizeof(BUNDLE_MAGIC)) != 0) return fail("not an ArtWeb bundle");
+    if (h->byte_order != BUNDLE_BYTE_ORDER) return fail("byte order mismatch");
+    if (h->version != BUNDLE_VERSION) return fail("unsupported bundle version");
+    if (h->file_size != size) return fail("size mismatch (truncated bundle?)");
+    if (h->slot_count == 0 || (h->slot_count & (h->slot_count - 1)) != 0 || h->slot_count <= h->entry_count) return fail("invalid hash table size");
+    if (!in_bounds(h->entries_offset, static_cast<std::uint64_t>(h->entry_count) * sizeof(BundleEntry)) ||
+        !in_bounds(h->slots_offset, static_cast<std::uint64_t>(h->slot_count) * sizeof(std::uint32_t)) ||
+        !in_bounds(h->strings_offset, h->strings_size) ||
+        h->entries_offset % alignof(BundleEntry) != 0 || h->slots_offset % alignof(std::uint32_t) != 0) {
+        return fail("index out of bounds");
+    }
+
+    const auto* entries = reinterpret_cast<const BundleEntry*>(base + h->entries_offset);
+    const auto* slots = reinterpret_cast<const std::uint32_t*>(base + h->slots_offset);
+    for (std::uint32_t i = 0; i < h->entry_count; ++i) {
+        const auto& e = entries[i];
+        if (e.path_offset > h->strings_size || e.path_len > h->strings_size - e.path_offset ||
+            !in_bounds(e.data_offset, e.data_size) || !in_bounds(e.gzip_offset, e.gzip_size)) {
+            return fail("entry out of bounds");
+        }
+    }
+    for (std::uint32_t i = 0; i < h->slot_count; ++i) {
+        if (slots[i] > h->entry_count) return fail("corrupt hash table");
+    }
+
+#if !defined(_WIN32) && defined(MADV_RANDOM)
+    madvise(const_cast<char*>(base), static_cast<size_t>(size), MADV_RANDOM);
+#endif
+    bundle.base = base;
+    bundle.size = size;
+    bundle.header = h;
+    bundle.entries = entries;
+    bundle.slots = slots;
+    bundle.strings = base + h->strings_offset;
+    return true;
+}
+
+const BundleEntry* find_bundle_entry(const SiteBundle& bundle, std::string_view path) {
+    const std::uint64_t hash = fnv1a64(path.data(), path.size());
+    const std::uint32_t mask = bundle.header->slot_count - 1;
+    for (std::uint32_t i = 0, slot = static_cast<std::uint32_t>(hash) & mask; i <= mask; ++i, slot = (slot + 1) & mask) {
+        const std::uint32_t idx = bundle.slots[slot];
+        if (idx == 0) return nullptr;
+        const BundleEntry& e = bundle.entries[idx - 1];
+        if (e.path_hash == hash && std::string_view(bundle.strings + e.path_offset, e.path_len) == path) return &e;
+    }
+    return nullptr;
+}
+
+// Bundle mode handler: hash lookup in the mapping, body streamed straight from it.
+void serve_bundle_handler(const httplib::Request& req, httplib::Response& res) {
+    if (!authenticate(req, res)) return;
+
+    std::string path = "/" + req.matches[1].str();
+    if (path.back() == '/') path += "index.html";
+    const BundleEntry* entry = find_bundle_entry(g_bundle, path);
+    if (!entry) {
+        res.status = 404;
+        res.set_content("Not Found", "text/plain");
+        return;
+    }
+
+    std::string etag = make_etag(entry->fingerprint, entry->data_size);
+    const char* body = g_bundle.base + entry->data_offset;
+    std::uint64_t body_size = entry->data_size;
+    if (entry->gzip_size) {
+        res.set_header("Vary", "Accept-Encoding");
+        if (req.get_header_value("Accept-Encoding").find("gzip") != std::string::npos) {
+            res.set_header("Content-Encoding", "gzip");
+            body = g_bundle.base + entry->gzip_offset;
+            body_size = entry->gzip_size;
+            etag = gzip_etag(etag);
+        }
+    }
+
+    res.set_header("ETag", etag);
+    if (req.get_header_value("If-None-Match") == etag) {
+        res.status = 304;
+        return;
+    }
+    res.status = 200;
+    res.set_content_provider(static_cast<size_t>(body_size), std::string(get_content_type(path)),
+        [body](size_t offset, size_t length, httplib::DataSink& sink) {
+            return sink.write(body + offset, length);
+        });
+}
+
+// --bundle-build DIR OUT: pack a directory into a bundle file.
+int build_bundle(const std::string& dir, const std::string& out_path) {
+    std::error_code ec;
+    if (!fs::is_directory(fs::u8path(dir), ec)) {
+        std::cerr << "Error: --bundle-build needs a directory: " << dir << std::endl;
+        return 1;
+    }
+
+    struct Item { std::string url; fs::path file; };
+    std::vector<Item> items;
+    for (auto it = fs::recursive_directory_iterator(fs::u8path(dir), ec); !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+        if (!it->is_regular_file()) continue;
+        items.push_back({ "/" + fs::relative(it->path(), fs::u8path(dir)).generic_u8string(), it->path() });
+    }
+    std::sort(items.begin(), items.end(), [](const Item& a, const Item& b) { return a.url < b.url; });
+    if (items.size() >= 0x7FFFFFFF) {
+        std::cerr << "Error: too many files for one bundle" << std::endl;
+        return 1;
+    }
+
+    BundleHeader header{};
+    std::memcpy(header.magic, BUNDLE_MAGIC, sizeof(BUNDLE_MAGIC));
+    header.version = BUNDLE_VERSION;
+    header.byte_order = BUNDLE_BYTE_ORDER;
+    header.entry_count = static_cast<std::uint32_t>(items.size());
+    header.slot_count = 16;
+    while (header.slot_count < items.size() * 2) header.slot_count <<= 1; // load factor <= 0.5
+
+    std::vector<BundleEntry> entries(items.size());
+    std::string strings;
+    for (size_t i = 0; i < items.size(); ++i) {
+        entries[i] = BundleEntry{};
+        entries[i].path_hash = fnv1a64(items[i].url.data(), items[i].url.size());
+        entries[i].path_offset = strings.size();
+        entries[i].path_len = static_cast<std::uint32_t>(items[i].url.size());
+        strings += items[i].url;
+    }
+    std::vector<std::uint32_t> slots(header.slot_count, 0);
+    for (size_t i = 0; i < entries.size(); ++i) {
+        std::uint32_t slot = static_cast<std::uint32_t>(entries[i].path_hash) & (header.slot_count - 1);
+        while (slots[slot]) slot = (slot + 1) & (header.slot_count - 1);
+        slots[slot] = static_cast<std::uint32_t>(i + 1);
+    }
+
+    auto align = [](std::uint64_t v) { return (v + BUNDLE_ALIGN - 1) / BUNDLE_ALIGN * BUNDLE_ALIGN; };
+    header.entries_offset = sizeof(BundleHeader);
+    header.slots_offset = header.entries_offset + entries.size() * sizeof(BundleEntry);
+    header.strings_offset = header.slots_offset + slots.size() * sizeof(std::uint32_t);
+    header.strings_size = strings.size();
+
+    std::ofstream out(fs::u8path(out_path), std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "Error: Cannot write " << out_path << std::endl;
+        return 1;
+    }
+
+    // Blobs first (the index is written last, once all offsets are known).
+    std::uint64_t pos = align(header.strings_offset + header.strings_size);
+    auto write_blob = [&](const std::string& data, std::uint64_t& offset) {
+        out.seekp(static_cast<std::streamoff>(pos));
+        out.write(data.data(), static_cast<std::streamsize>(data.size()));
+        offset = pos;
+        pos = align(pos + data.size());
+    };
+    for (size_t i = 0; i < items.size(); ++i) {
+        std::ifstream ifs(items[i].file, std::ios::binary);
+        std::ostringstream oss;
+        oss << ifs.rdbuf();
+        const std::string content = oss.str();
+        if (!ifs) {
+            std::cerr << "Error: Cannot read " << items[i].file.u8string() << std::endl;
+            return 1;
+        }
+        auto& e = entries[i];
+        e.data_size = content.size();
+        e.fingerprint = fnv1a64(content.data(), content.size());
+        auto ftime = fs::last_write_time(items[i].file, ec);
+        e.mtime = ec ? 0 : static_cast<std::int64_t>(to_time_t(ftime));
+        write_blob(content, e.data_offset);
+
+        const std::string gz = precompress_asset(content, get_content_type(items[i].url));
+        if (!gz.empty()) {
+            e.gzip_size = gz.size();
+            write_blob(gz, e.gzip_offset);
+        }
+    }
+    // Pad to the final size so the last blob's alignment is part of the file.
+    header.file_size = std::max<std::uint64_t>(pos, header.strings_offset + header.strings_size);
+    if (header.file_size > header.strings_offset + header.strings_size) {
+        out.seekp(static_cast<std::streamoff>(header.file_size - 1));
+        out.put('\0');
+    }
+
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(BundleEntry)));
+    out.write(reinterpret_cast<const char*>(slots.data()), static_cast<std::streamsize>(slots.size() * sizeof(std::uint32_t)));
+    out.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+    out.close();
+    if (!out) {
+        std::cerr << "Error: Failed to write " << out_path << std::endl;
+        return 1;
+    }
+
+    std::cout << "Bundled " << items.size() << " files into " << out_path << " (" << header.file_size << " bytes)\n";
+    return 0;
+}
+
+// ------------------------ Metrics ------------------------
+
+// Prometheus-style metrics (--metrics PATH / --metrics-port PORT).
+// Each worker thread owns a shard it alone writes to (relaxed load+store, no RMW,
+// no locks); a scrape sums all shards. A thread that exits hands its shard on to
+// the next new thread, so there are never more shards than threads at the peak. Latency uses an HDR-style log-linear
+// histogram in microseconds: exact below 16 us, then 8 sub-buckets per power of two
+// (<= 12.5% relative error).
+enum class MetricHandler { None, Static, Browse, Upload, UploadTar, FileOp, Embedded, Bundle, PostCatchAll, Metrics, Count };
+const char* const METRIC_HANDLER_NAMES[] = { "none", "static", "browse", "upload", "upload_tar", "file_op", "embedded", "bundle", "post_catch_all", "metrics" };
+
+const int METRICS_SUB_BUCKETS = 8;
+const int METRICS_BUCKETS = 16 + (40 - 4) * METRICS_SUB_BUCKETS; // up to 2^40 us
+
+std::string g_metrics_path;         // --metrics PATH (served by the main server)
+int g_metrics_port = 0;             // --metrics-port PORT (separate listener)
+bool g_metrics_enabled = false;
+
+struct HandlerMetrics {
+    std::atomic<std::uint64_t> requests[6];          // by status class: [0] other, [1] 1xx .. [5] 5xx
+    std::atomic<std::uint64_t> latency_sum_us;
+    std::atomic<std::uint64_t> bytes_in;
+    std::atomic<std::uint64_t> bytes_out;
+    std::atomic<std::uint64_t> buckets[METRICS_BUCKETS];
+};
+
+struct MetricsShard {
+    HandlerMetrics handlers[static_cast<int>(MetricHandler::Count)];
+    MetricsShard() {
+        for (auto& h : handlers) {
+            for (auto& r : h.requests) r.store(0, std::memory_order_relaxed);
+            h.latency_sum_us.store(0, std::memory_order_relaxed);
+            h.bytes_in.store(0, std::memory_order_relaxed);
+            h.bytes_out.store(0, std::memory_order_relaxed);
+            for (auto& b : h.buckets) b.store(0, std::memory_order_relaxed);
+        }
+    }
+};
+
+std::mutex g_metrics_shards_mutex;                 // only taken when a thread starts or exits, or on scrape
+std::vector<std::unique_ptr<MetricsShard>> g_metrics_shards;
+std::vector<MetricsShard*> g_free_metrics_shards;  // of exited threads, counts kept
+std::atomic<std::int64_t> g_active_connections{ 0 };
+std::atomic<std::int64_t> g_queued_connections{ 0 };
+std::atomic<std::int64_t> g_requests_in_flight{ 0 };
+std::atomic<std::int64_t> g_worker_threads{ 0 };
+std::atomic<std::int64_t> g_bulk_transfers{ 0 };
+const auto g_start_time = std::chrono::steady_clock::now();
+
+// Per-request state on the worker thread, set by pre-routing and the handler wrapper.
+thread_local MetricHandler t_metric_handler = MetricHandler::None;
+thread_local std::chrono::steady_clock::time_point t_request_start;
+thread_local bool t_request_in_flight = false;   // counted in g_requests_in_flight
+
+// The calling thread's shard, returned to the free list when the thread exits.
+struct MetricsShardLease {
+    MetricsShard* shard = nullptr;
+    ~MetricsShardLease() {
+        if (!shard) return;
+        std::lock_guard<std::mutex> lock(g_metrics_shards_mutex);
+        g_free_metrics_shards.push_back(shard);
+    }
+};
+
+MetricsShard& metrics_shard() {
+    thread_local MetricsShardLease lease;
+    if (!lease.shard) {
+        std::lock_guard<std::mutex> lock(g_metrics_shards_mutex);
+        if (!g_free_metrics_shards.empty()) {
+            lease.shard = g_free_metrics_shards.back();
+            g_free_metrics_shards.pop_back();
+        }
+        else {
+            g_metrics_shards.push_back(std::make_unique<MetricsShard>());
+            lease.shard = g_metrics_shards.back().get();
+        }
+    }
+    return *lease.shard;
+}
+
+inline void metrics_add(std::atomic<std::uint64_t>& counter, std::uint64_t n) {
+    // Single writer per shard: a plain load+store is enough and avoids a locked RMW.
+    counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+int metrics_bucket(std::uint64_t us) {
+    if (us < 16) return static_cast<int>(us);
+    int e = 63;
+    while (!(us >> e)) --e;
+    if (e >= 40) return METRICS_BUCKETS - 1;
+    const int sub = static_cast<int>((us >> (e - 3)) & (METRICS_SUB_BUCKETS - 1));
+    return 16 + (e - 4) * METRICS_SUB_BUCKETS + sub;
+}
+
+// Largest value (in us) that falls into a bucket.
+std::uint64_t metrics_bucket_upper(int idx) {
+    if (idx < 16) return static_cast<std::uint64_t>(idx);
+    const int e = 4 + (idx - 16) / METRICS_SUB_BUCKETS;
+    const std::uint64_t sub = static_cast<std::uint64_t>((idx - 16) % METRICS_SUB_BUCKETS);
+    return ((METRICS_SUB_BUCKETS + sub + 1) << (e - 3)) - 1;
+}
+
+// Undo metrics_request_started(). Runs from the logger and, for responses the
+// logger never saw (e.g. the client vanished before the headers went out),
+// when the connection task ends or the next request starts on this thread.
+void metrics_request_ended() {
+    if (!t_request_in_flight) return;
+    t_request_in_flight = false;
+    g_requests_in_flight.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void metrics_request_started() {
+    metrics_request_ended();
+    t_metric_handler = MetricHandler::None;
+    t_request_start = std::chrono::steady_clock::now();
+    t_request_in_flight = true;
+    g_requests_in_flight.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Called from the logger, i.e. after the response (including streamed bodies) was written.
+// Requests httplib rejects before routing (400, 414, ...) reach the logger without
+// having started: they are counted, but have no latency to record.
+void metrics_record_request(const httplib::Request& req, const httplib::Response& res) {
+    if (!g_metrics_enabled) return;
+    const bool started = t_request_in_flight;
+    if (!started) t_metric_handler = MetricHandler::None;
+    metrics_request_ended();
+
+    auto& h = metrics_shard().handlers[static_cast<int>(t_metric_handler)];
+    const int status_class = (res.status >= 100 && res.status < 600) ? res.status / 100 : 0;
+    metrics_add(h.requests[status_class], 1);
+    if (started) {
+        const auto us = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - t_request_start).count());
+        metrics_add(h.latency_sum_us, us);
+        metrics_add(h.buckets[metrics_bucket(us)], 1);
+    }
+
+    auto content_length = [](const httplib::Headers& headers, std::size_t fallback) -> std::uint64_t {
+        auto it = headers.find("Content-Length");
+        if (it == headers.end()) return fallback;
+        try { return std::stoull(it->second); }
+        catch (...) { return fallback; }
+    };
+    metrics_add(h.bytes_in, content_length(req.headers, req.body.size()));
+    if (req.method != "HEAD") metrics_add(h.bytes_out, content_length(res.headers, res.body.size()));
+    t_metric_handler = MetricHandler::None;
+}
+
+// Tag a route with its metrics label.
+httplib::Server::Handler instrumented(MetricHandler id, httplib::Server::Handler handler) {
+    if (!g_metrics_enabled) return handler;
+    return [id, handler](const httplib::Request& req, httplib::Response& res) {
+        t_metric_handler = id;
+        handler(req, res);
+    };
+}
+
+httplib::Server::HandlerWithContentReader instrumented(MetricHandler id, httplib::Server::HandlerWithContentReader handler) {
+    if (!g_metrics_enabled) return handler;
+    return [id, handler](const httplib::Request& req, httplib::Response& res, const httplib::ContentReader& reader) {
+        t_metric_handler = id;
+        handler(req, res, reader);
+    };
+}
+
+std::string render_metrics() {
+    const int handler_count = static_cast<int>(MetricHandler::Count);
+    struct Totals {
+        std::uint64_t requests[6] = {};
+        std::uint64_t latency_sum_us = 0, bytes_in = 0, bytes_out = 0;
+        std::vector<std::uint64_t> buckets = std::vector<std::uint64_t>(METRICS_BUCKETS, 0);
+    };
+    std::vector<Totals> totals(handler_count);
+    {
+        std::lock_guard<std::mutex> lock(g_metrics_shards_mutex);
+        for (const auto& shard : g_metrics_shards) {
+            for (int i = 0; i < handler_count; ++i) {
+                const auto& h = shard->handlers[i];
+                auto& t = totals[i];
+                for (int c = 0; c < 6; ++c) t.requests[c] += h.requests[c].load(std::memory_order_relaxed);
+                t.latency_sum_us += h.latency_sum_us.load(std::memory_order_relaxed);
+                t.bytes_in += h.bytes_in.load(std::memory_order_relaxed);
+                t.bytes_out += h.bytes_out.load(std::memory_order_relaxed);
+                for (int b = 0; b < METRICS_BUCKETS; ++b) t.buckets[b] += h.buckets[b].load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    static const char* const status_labels[] = { "other", "1xx", "2xx", "3xx", "4xx", "5xx" };
+    static const double le_bounds[] = { 0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05,
+        0.1, 0.25, 0.5, 1, 2.5, 5, 10, 30, 60, 300, 1800 };
+    static const double quantiles[] = { 0.5, 0.9, 0.99, 0.999 };
+
+    std::ostringstream o;
+    o << "# HELP artweb_requests_total Requests handled, by handler and status class.\n"
+        << "# TYPE artweb_requests_total counter\n";
+    for (int i = 0; i < handler_count; ++i) {
+        for (int c = 0; c < 6; ++c) {
+            if (totals[i].requests[c] == 0) continue;
+            o << "artweb_requests_total{handler=\"" << METRIC_HANDLER_NAMES[i] << "\",code=\"" << status_labels[c] << "\"} " << totals[i].requests[c] << "\n";
+        }
+    }
+
+    o << "# HELP artweb_request_duration_seconds Time from routing to the last byte written.\n"
+        << "# TYPE artweb_request_duration_seconds histogram\n";
+    for (int i = 0; i < handler_count; ++i) {
+        const auto& t = totals[i];
+        std::uint64_t count = 0;
+        for (auto b : t.buckets) count += b;
+        if (count == 0) continue;
+        std::uint64_t cumulative = 0;
+        int b = 0;
+        for (double le : le_bounds) {
+            const auto le_us = static_cast<std::uint64_t>(le * 1e6);
+            while (b < METRICS_BUCKETS && metrics_bucket_upper(b) <= le_us) cumulative += t.buckets[b++];
+            o << "artweb_request_duration_seconds_bucket{handler=\"" << METRIC_HANDLER_NAMES[i] << "\",le=\"" << le << "\"} " << cumulative << "\n";
+        }
+        o << "artweb_request_duration_seconds_bucket{handler=\"" << METRIC_HANDLER_NAMES[i] << "\",le=\"+Inf\"} " << count << "\n"
+            << "artweb_request_duration_seconds_sum{handler=\"" << METRIC_HANDLER_NAMES[i] << "\"} " << (t.latency_sum_us / 1e6) << "\n"
+            << "artweb_request_duration_seconds_count{handler=\"" << METRIC_HANDLER_NAMES[i] << "\"} " << count << "\n";
+    }
+
+    o << "# HELP artweb_request_duration_quantile_seconds Latency quantiles from the HDR histogram (upper bucket bound).\n"
+        << "# TYPE artweb_request_duration_quantile_seconds gauge\n";
+    for (int i = 0; i < handler_count; ++i) {
+        const auto& t = totals[i];
+        std::uint64_t count = 0;
+        for (auto b : t.buckets) count += b;
+        if (count == 0) continue;
+        for (double q : quantiles) {
+            const auto target = static_cast<std::uint64_t>(q * static_cast<double>(count) + 0.5);
+            std::uint64_t cumulative = 0;
+            int b = 0;
+            for (; b < METRICS_BUCKETS - 1; ++b) {
+                cumulative += t.buckets[b];
+                if (cumulative >= std::max<std::uint64_t>(target, 1)) break;
+            }
+            o << "artweb_request_duration_quantile_seconds{handler=\"" << METRIC_HANDLER_NAMES[i] << "\",quantile=\"" << q << "\"} "
+                << (metrics_bucket_upper(b) / 1e6) << "\n";
+        }
+    }
+
+    o << "# HELP artweb_received_bytes_total Request body bytes, by handler.\n"
+        << "# TYPE artweb_received_bytes_total counter\n";
+    for (int i = 0; i < handler_count; ++i) {
+        if (totals[i].bytes_in) o << "artweb_received_bytes_total{handler=\"" << METRIC_HANDLER_NAMES[i] << "\"} " << totals[i].bytes_in << "\n";
+    }
+    o << "# HELP artweb_sent_bytes_total Response body bytes, by handler.\n"
+        << "# TYPE artweb_sent_bytes_total counter\n";
+    for (int i = 0; i < handler_count; ++i) {
+        if (totals[i].bytes_out) o << "artweb_sent_bytes_total{handler=\"" << METRIC_HANDLER_NAMES[i] << "\"} " << totals[i].bytes_out << "\n";
+    }
+
+    o << "# HELP artweb_active_connections Connections currently owned by a worker thread.\n"
+        << "# TYPE artweb_active_connections gauge\n"
+        << "artweb_active_connections " << g_active_connections.load() << "\n"
+        << "# HELP artweb_queued_connections Accepted connections waiting for a worker thread.\n"
+        << "# TYPE artweb_queued_connections gauge\n"
+        << "artweb_queued_connections " << g_queued_connections.load() << "\n"
+        << "# HELP artweb_requests_in_flight Requests being handled or streamed.\n"
+        << "# TYPE artweb_requests_in_flight gauge\n"
+        << "artweb_requests_in_flight " << g_requests_in_flight.load() << "\n"
+        << "# HELP artweb_worker_threads Worker threads, interactive and bulk lanes.\n"
+        << "# TYPE artweb_worker_threads gauge\n"
+        << "artweb_worker_threads " << g_worker_threads.load() << "\n"
+        << "# HELP artweb_bulk_transfers Requests currently running in the bulk lane.\n"
+        << "# TYPE artweb_bulk_transfers gauge\n"
+        << "artweb_bulk_transfers " << g_bulk_transfers.load() << "\n"
+        << "# HELP artweb_throttled_bytes_total Bytes delayed by the bandwidth limits, by direction.\n"
+        << "# TYPE artweb_throttled_bytes_total counter\n"
+        << "artweb_throttled_bytes_total{direction=\"out\"} " << g_outbound.throttled_bytes.load() << "\n"
+        << "artweb_throttled_bytes_total{direction=\"in\"} " << g_inbound.throttled_bytes.load() << "\n"
+        << "# HELP artweb_throttle_wait_seconds_total Time spent waiting on the bandwidth limits, by direction.\n"
+        << "# TYPE artweb_throttle_wait_seconds_total counter\n"
+        << "artweb_throttle_wait_seconds_total{direction=\"out\"} " << g_outbound.throttle_wait_us.load() / 1e6 << "\n"
+        << "artweb_throttle_wait_seconds_total{direction=\"in\"} " << g_inbound.throttle_wait_us.load() / 1e6 << "\n"
+        << "# HELP artweb_io_fallbacks_total io_uring reads and writes redone with blocking pread/pwrite.\n"
+        << "# TYPE artweb_io_fallbacks_total counter\n"
+        << "artweb_io_fallbacks_total " << g_io_fallbacks.load() << "\n"
+        << "# HELP artweb_dedup_saved_bytes_total Upload bytes replaced by links to identical stored content.\n"
+        << "# TYPE artweb_dedup_saved_bytes_total counter\n"
+        << "artweb_dedup_saved_bytes_total " << g_dedup.saved_bytes.load() << "\n"
+        << "# HELP artweb_digest_cache_hits_total File digests answered from the digest cache.\n"
+        << "# TYPE artweb_digest_cache_hits_total counter\n"
+        << "artweb_digest_cache_hits_total " << g_digests.hits.load() << "\n"
+        << "# HELP artweb_digest_bytes_hashed_total File bytes read to compute ?hash= digests.\n"
+        << "# TYPE artweb_digest_bytes_hashed_total counter\n"
+        << "artweb_digest_bytes_hashed_total " << g_digests.bytes_hashed.load() << "\n"
+        << "# HELP artweb_uptime_seconds Seconds since the process started.\n"
+        << "# TYPE artweb_uptime_seconds gauge\n"
+        << "artweb_uptime_seconds " << std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - g_start_time).count() << "\n";
+    return o.str();
+}
+
+void metrics_handler(const httplib::Request& req, httplib::Response& res) {
+    if (!authenticate(req, res)) return;
+    res.set_content(render_metrics(), "text/plain; version=0.0.4; charset=utf-8");
+}
 
-        std::string parent_str = parent.empty() ? "." : parent.u8string();
-        std::string parent_link = (parent_str == ".") ? "/" : ("/" + url_encode_path(parent_str));
-        html << "      <li><a href='" << parent_link << u8"'>.. [↩ parent] </a></li>\n";
+// ------------------------ Worker lanes ------------------------
+
+// httplib keeps a connection on one pool worker for its whole lifetime, so a few
+// multi-GB transfers could hold every worker and stall the directory listing.
+// Requests are classified in pre-routing, before any body is read: downloads of
+// large files and large or chunked uploads move their worker into the bulk lane,
+// and the pool starts a replacement so the interactive lane keeps its size.
+// The bulk lane is capped (--bulk-workers). Over the cap a request parks, also
+// outside the interactive lane, until a slot frees up; if as many requests are
+// already parked, it gets 503.
+std::size_t g_interactive_workers = CPPHTTPLIB_THREAD_POOL_COUNT;
+std::size_t g_bulk_workers = 8;                 // 0: single pool, no classification
+const int BULK_WAIT_SECONDS = 60;
+
+class LaneTaskQueue : public httplib::TaskQueue {
+public:
+    LaneTaskQueue(std::size_t interactive, std::size_t bulk_max)
+        : interactive_(std::max<std::size_t>(1, interactive)), bulk_max_(bulk_max) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        while (threads_ < interactive_) spawn_locked();
     }
+    ~LaneTaskQueue() override { shutdown(); }
 
-    std::vector<std::pair<std::string, fs::path>> directories, files;
-    try {
-        for (const auto& entry : fs::directory_iterator(fs_path)) {
-            std::string name = entry.path().filename().u8string();
-            if (fs::is_directory(entry.path())) directories.push_back({ name, entry.path() });
-            else if (fs::is_regular_file(entry.path())) files.push_back({ name, entry.path() });
+    bool enqueue(std::function<void()> fn) override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (shutdown_) return false;
+            jobs_.push_back(std::move(fn));
         }
+        g_queued_connections.fetch_add(1, std::memory_order_relaxed);
+        jobs_cv_.notify_one();
+        return true;
     }
-    catch (...) {
-        res.status = 403;
-        res.set_content("Access denied", "text/plain");
-        return;
+
+    void shutdown() override {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (shutdown_ && workers_.empty()) return;
+        shutdown_ = true;
+        jobs_cv_.notify_all();
+        slot_cv_.notify_all();
+        while (!workers_.empty() || !retired_.empty()) {
+            std::vector<std::thread> joinable;
+            for (auto& w : workers_) joinable.push_back(std::move(w.second));
+            workers_.clear();
+            joinable.insert(joinable.end(), std::make_move_iterator(retired_.begin()), std::make_move_iterator(retired_.end()));
+            retired_.clear();
+            lock.unlock();
+            for (auto& t : joinable) if (t.joinable()) t.join();
+            lock.lock();
+        }
     }
-    std::sort(directories.begin(), directories.end(), [](auto const& a, auto const& b) { return a.first < b.first; });
-    std::sort(files.begin(), files.end(), [](auto const& a, auto const& b) { return a.first < b.first; });
-    const std::string base_href = (dir == ".") ? "" : (url_encode_path(dir) + "/");
-    for (const auto& p : directories) html << u8"      <li>📁 <a href='/" << base_href << url_encode(p.first) << "'>" << p.first << "/</a></li>\n";
-    for (const auto& p : files) html << u8"      <li>🗎 <a href='/" << base_href << url_encode(p.first) << "'>" << p.first << "</a></li>\n";
-    html << "    </ul>\n"
-        << "    <div class='footer'>Version " << VERSION << "</div>\n"
-        << "  </div>\n"
-        << "  <script>\n";
 
-    if (!g_proxy_upload_mode) {
-        // Old upload behavior: one POST request for the entire file.
-        html
-            << "    document.getElementById('uploadForm').addEventListener('submit', function(event) {\n"
-            << "      event.preventDefault();\n"
-            << "      var fileInput = document.querySelector('input[type=\"file\"]');\n"
-            << "      if (!fileInput.files.length) { alert('Please select a file.'); return; }\n"
-            << "      var formData = new FormData(); formData.append('file', fileInput.files[0]);\n"
-            << "      var xhr = new XMLHttpRequest(); xhr.open('POST', document.getElementById('uploadForm').action, true);\n"
-            << "      xhr.upload.addEventListener('progress', function(e) {\n"
-            << "        if (e.lengthComputable) {\n"
-            << "          var percentComplete = Math.round((e.loaded / e.total) * 100);\n"
-            << "          document.getElementById('uploadProgress').value = percentComplete;\n"
-            << "        }\n"
-            << "      });\n"
-            << "      xhr.onloadstart = function() { document.getElementById('uploadProgress').style.display = 'block'; };\n"
-            << "      xhr.onloadend = function() {\n"
-            << "        document.getElementById('uploadProgress').style.display = 'none';\n"
-            << "        if (xhr.status === 200) { alert('Upload complete!'); window.location.reload(); }\n"
-            << "        else { alert('Upload failed.'); }\n"
-            << "      };\n"
-            << "      xhr.send(formData);\n"
-            << "    });\n"
-            << "    var dropZone = document.getElementById('dropZone');\n"
-            << "    dropZone.addEventListener('dragover', function(e) { e.preventDefault(); dropZone.style.backgroundColor = '#e0e0e0'; });\n"
-            << "    dropZone.addEventListener('dragleave', function(e) { e.preventDefault(); dropZone.style.backgroundColor = ''; });\n"
-            << "    dropZone.addEventListener('drop', function(e) {\n"
-            << "      e.preventDefault(); dropZone.style.backgroundColor = '';\n"
-            << "      var files = e.dataTransfer.files; if (files.length === 0) return;\n"
-            << "      var formData = new FormData(); formData.append('file', files[0]);\n"
-            << "      var xhr = new XMLHttpRequest(); xhr.open('POST', document.getElementById('uploadForm').action, true);\n"
-            << "      xhr.upload.addEventListener('progress', function(e) {\n"
-            << "        if (e.lengthComputable) {\n"
-            << "          var percentComplete = Math.round((e.loaded / e.total) * 100);\n"
-            << "          document.getElementById('uploadProgress').value = percentComplete;\n"
-            << "        }\n"
-            << "      });\n"
-            << "      xhr.onloadstart = function() { document.getElementById('uploadProgress').style.display = 'block'; };\n"
-            << "      xhr.onloadend = function() {\n"
-            << "        document.getElementById('uploadProgress').style.display = 'none';\n"
-            << "        if (xhr.status === 200) { alert('Upload complete!'); window.location.reload(); }\n"
-            << "        else { alert('Upload failed.'); }\n"
-            << "      };\n"
-            << "      xhr.send(formData);\n"
-            << "    });\n";
+    // Move the calling worker into the bulk lane for its current request.
+    // False when the lane and its parking spots are full, or the wait timed out.
+    bool enter_bulk() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (t_lane_bulk) return true;
+        if (bulk_ >= bulk_max_ && parked_ >= bulk_max_) return false;
+        ++parked_;
+        ensure_interactive_locked();
+        const bool got_slot = slot_cv_.wait_for(lock, std::chrono::seconds(BULK_WAIT_SECONDS),
+            [this] { return shutdown_ || bulk_ < bulk_max_; });
+        --parked_;
+        if (!got_slot || shutdown_) return false;
+        ++bulk_;
+        t_lane_bulk = true;
+        g_bulk_transfers.store(static_cast<std::int64_t>(bulk_), std::memory_order_relaxed);
+        return true;
+    }
+
+    // Move the calling worker out of the interactive lane without taking a bulk
+    // slot, for long-lived but mostly idle responses capped elsewhere (followers).
+    void enter_detached() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (t_lane_bulk || t_lane_detached) return;
+        ++detached_;
+        t_lane_detached = true;
+        ensure_interactive_locked();
+    }
+
+    // Back to the interactive lane once the response has been written.
+    void leave_bulk() {
+        if (t_lane_detached) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            t_lane_detached = false;
+            --detached_;
+            return;
+        }
+        if (!t_lane_bulk) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            t_lane_bulk = false;
+            --bulk_;
+            g_bulk_transfers.store(static_cast<std::int64_t>(bulk_), std::memory_order_relaxed);
+        }
+        slot_cv_.notify_one();
+    }
+
+    static thread_local LaneTaskQueue* t_current;   // queue owning the calling worker, if any
+
+private:
+    static thread_local bool t_lane_bulk;
+    static thread_local bool t_lane_detached;
+
+    // Workers not in (or waiting for) the bulk lane.
+    std::size_t interactive_count_locked() const { return threads_ - bulk_ - parked_ - detached_; }
+
+    void ensure_interactive_locked() {
+        while (!shutdown_ && interactive_count_locked() < interactive_) spawn_locked();
+    }
+
+    void spawn_locked() {
+        for (auto& t : retired_) if (t.joinable()) t.join();
+        retired_.clear();
+        ++threads_;
+        g_worker_threads.store(static_cast<std::int64_t>(threads_), std::memory_order_relaxed);
+        std::thread t([this] { run(); });
+        const auto id = t.get_id();
+        workers_.emplace(id, std::move(t));
+    }
+
+    void run() {
+        t_current = this;
+        for (;;) {
+            std::function<void()> fn;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                jobs_cv_.wait(lock, [this] { return shutdown_ || !jobs_.empty(); });
+                if (jobs_.empty()) break; // shutting down
+                fn = std::move(jobs_.front());
+                jobs_.pop_front();
+            }
+            g_queued_connections.fetch_sub(1, std::memory_order_relaxed);
+            g_active_connections.fetch_add(1, std::memory_order_relaxed);
+            fn();
+            g_active_connections.fetch_sub(1, std::memory_order_relaxed);
+            leave_bulk(); // in case the logger did not run (e.g. connection dropped)
+            metrics_request_ended();
+
+            // Replacements started for bulk transfers retire once the lane is back to size.
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!shutdown_ && interactive_count_locked() > interactive_) {
+                retire_locked();
+                return;
+            }
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        retire_locked();
+    }
+
+    void retire_locked() {
+        auto it = workers_.find(std::this_thread::get_id());
+        if (it != workers_.end()) {
+            retired_.push_back(std::move(it->second));
+            workers_.erase(it);
+        }
+        --threads_;
+        g_worker_threads.store(static_cast<std::int64_t>(threads_), std::memory_order_relaxed);
+    }
+
+    const std::size_t interactive_;
+    const std::size_t bulk_max_;
+    std::mutex mutex_;
+    std::condition_variable jobs_cv_;
+    std::condition_variable slot_cv_;
+    std::list<std::function<void()>> jobs_;
+    std::map<std::thread::id, std::thread> workers_;
+    std::vector<std::thread> retired_;
+    std::size_t threads_ = 0;
+    std::size_t bulk_ = 0;
+    std::size_t parked_ = 0;
+    std::size_t detached_ = 0;
+    bool shutdown_ = false;
+};
+
+thread_local LaneTaskQueue* LaneTaskQueue::t_current = nullptr;
+thread_local bool LaneTaskQueue::t_lane_bulk = false;
+thread_local bool LaneTaskQueue::t_lane_detached = false;
+
+// Bytes a request will move, judged from its headers (and one cached stat for GETs).
+std::uint64_t expected_transfer_size(const httplib::Request& req) {
+    if (req.method == "POST" || req.method == "PUT") {
+        if (req.path == "/copy") return (std::numeric_limits<std::uint64_t>::max)(); // moves its data server-side
+        if (httplib::detail::is_chunked_transfer_encoding(req.headers)) return (std::numeric_limits<std::uint64_t>::max)();
+        return req.get_header_value_u64("Content-Length");
+    }
+    if (req.method != "GET" || !g_bundle_path.empty() || g_embedded_mode) return 0;
+    if (require_auth && req.get_header_value("Authorization") != g_expected_auth_header) return 0;
+
+    // Same target the static/browse handler will resolve (and find in the file cache).
+    std::string rel = req.path.size() > 1 ? req.path.substr(1) : std::string();
+    if (!g_web_root_path.empty()) {
+        if (rel.empty() || rel.back() == '/') rel += "index.html";
     }
     else {
-        // Proxy-safe upload behavior: small files use single POST, large files are chunked.
-        html
-            << "    function uploadSingle(file) {\n"
-            << "      var formData = new FormData(); formData.append('file', file);\n"
-            << "      var xhr = new XMLHttpRequest(); xhr.open('POST', document.getElementById('uploadForm').action, true);\n"
-            << "      xhr.upload.addEventListener('progress', function(e) {\n"
-            << "        if (e.lengthComputable) {\n"
-            << "          var percentComplete = Math.round((e.loaded / e.total) * 100);\n"
-            << "          document.getElementById('uploadProgress').value = percentComplete;\n"
-            << "        }\n"
-            << "      });\n"
-            << "      xhr.onloadstart = function() { document.getElementById('uploadProgress').style.display = 'block'; };\n"
-            << "      xhr.onloadend = function() {\n"
-            << "        document.getElementById('uploadProgress').style.display = 'none';\n"
-            << "        if (xhr.status === 200) { alert('Upload complete!'); window.location.reload(); }\n"
-            << "        else { alert('Upload failed.'); }\n"
-            << "      };\n"
-            << "      xhr.send(formData);\n"
-            << "    }\n"
-            << "    function uploadChunked(file) {\n"
-            << "      var chunkSize = 128 * 1024; // 128 KiB\n"
-            << "      var totalChunks = Math.ceil(file.size / chunkSize);\n"
-            << "      var uploadId = Date.now().toString(36) + Math.random().toString(36).slice(2);\n"
-            << "      var baseUrl = document.getElementById('uploadForm').action;\n"
-            << "      var progressEl = document.getElementById('uploadProgress');\n"
-            << "      progressEl.value = 0;\n"
-            << "      progressEl.style.display = 'block';\n"
-            << "      var maxRetries = 5;\n"
-            << "      function sendChunk(i, attempt) {\n"
-            << "        var start = i * chunkSize;\n"
-            << "        var end = Math.min(start + chunkSize, file.size);\n"
-            << "        var blob = file.slice(start, end);\n"
-            << "        var url = baseUrl + (baseUrl.indexOf('?') >= 0 ? '&' : '?') +\n"
-            << "          'upload_id=' + encodeURIComponent(uploadId) +\n"
-            << "          '&chunk_index=' + encodeURIComponent(String(i)) +\n"
-            << "          '&total_chunks=' + encodeURIComponent(String(totalChunks)) +\n"
-            << "          '&offset=' + encodeURIComponent(String(start)) +\n"
-            << "          '&file_size=' + encodeURIComponent(String(file.size));\n"
-            << "        var formData = new FormData();\n"
-            << "        formData.append('file', blob, file.name);\n"
-            << "        var xhr = new XMLHttpRequest(); xhr.open('POST', url, true);\n"
-            << "        xhr.upload.addEventListener('progress', function(e) {\n"
-            << "          if (e.lengthComputable) {\n"
-            << "            var loaded = start + e.loaded;\n"
-            << "            var percentComplete = Math.round((loaded / file.size) * 100);\n"
-            << "            progressEl.value = percentComplete;\n"
-            << "          }\n"
-            << "        });\n"
-            << "        xhr.onload = function() {\n"
-            << "          if (xhr.status === 200) {\n"
-            << "            if (i + 1 < totalChunks) { sendChunk(i + 1, 0); }\n"
-            << "            else { progressEl.style.display = 'none'; alert('Upload complete!'); window.location.reload(); }\n"
-            << "          } else {\n"
-            << "            if (attempt < maxRetries) {\n"
-            << "              setTimeout(function(){ sendChunk(i, attempt + 1); }, 500 * (attempt + 1));\n"
-            << "            } else {\n"
-            << "              progressEl.style.display = 'none'; alert('Upload failed.');\n"
-            << "            }\n"
-            << "          }\n"
-            << "        };\n"
-            << "        xhr.onerror = function() {\n"
-            << "          if (attempt < maxRetries) {\n"
-            << "            setTimeout(function(){ sendChunk(i, attempt + 1); }, 500 * (attempt + 1));\n"
-            << "          } else {\n"
-            << "            progressEl.style.display = 'none'; alert('Upload failed.');\n"
-            << "          }\n"
-            << "        };\n"
-            << "        xhr.send(formData);\n"
-            << "      }\n"
-            << "      sendChunk(0, 0);\n"
-            << "    }\n"
-            << "    function startUpload(file) {\n"
-            << "      var CHUNK_THRESHOLD = 300 * 1024; // 300 KB\n"
-            << "      if (file.size > CHUNK_THRESHOLD) uploadChunked(file);\n"
-            << "      else uploadSingle(file);\n"
-            << "    }\n"
-            << "    document.getElementById('uploadForm').addEventListener('submit', function(event) {\n"
-            << "      event.preventDefault();\n"
-            << "      var fileInput = document.querySelector('input[type=\"file\"]');\n"
-            << "      if (!fileInput.files.length) { alert('Please select a file.'); return; }\n"
-            << "      startUpload(fileInput.files[0]);\n"
-            << "    });\n"
-            << "    var dropZone = document.getElementById('dropZone');\n"
-            << "    dropZone.addEventListener('dragover', function(e) { e.preventDefault(); dropZone.style.backgroundColor = '#e0e0e0'; });\n"
-            << "    dropZone.addEventListener('dragleave', function(e) { e.preventDefault(); dropZone.style.backgroundColor = ''; });\n"
-            << "    dropZone.addEventListener('drop', function(e) {\n"
-            << "      e.preventDefault(); dropZone.style.backgroundColor = '';\n"
-            << "      var files = e.dataTransfer.files; if (files.length === 0) return;\n"
-            << "      startUpload(files[0]);\n"
-            << "    });\n";
+        rel = url_decode(rel);
+        if (rel.empty() || rel.find("..") != std::string::npos) return 0;
+    }
+    if (req.has_param("grep")) return (std::numeric_limits<std::uint64_t>::max)(); // reads a whole tree
+    if (req.has_param("tail") || req.has_param("lines")) return 0; // a few lines of the file
+    ResolvedFile file;
+    if (resolve_cached(g_root, rel, file) != ResolveStatus::Ok || !file.is_regular) return 0;
+    if (req.has_param("archive")) return g_archives.member_size(file, req.get_param_value("archive"));
+    if (req.ranges.empty()) return file.size;
+
+    std::uint64_t total = 0;
+    for (const auto& r : req.ranges) {
+        // "-N" is a suffix of N bytes, "N-" runs to the end; not yet clamped by httplib here.
+        const std::uint64_t first = r.first < 0 ? 0 : static_cast<std::uint64_t>(r.first);
+        const std::uint64_t last = r.second < 0 ? file.size : static_cast<std::uint64_t>(r.second) + 1;
+        if (r.first < 0) total += std::min<std::uint64_t>(static_cast<std::uint64_t>(r.second), file.size);
+        else if (last > first) total += std::min<std::uint64_t>(last, file.size) - std::min<std::uint64_t>(first, file.size);
+    }
+    return total;
+}
+
+// Pre-routing: put bulk transfers in their lane; false when the request was answered (503).
+bool admit_request(const httplib::Request& req, httplib::Response& res) {
+    LaneTaskQueue* lanes = LaneTaskQueue::t_current;
+    if (!lanes || g_bulk_workers == 0) return true;
+    if (req.method == "GET" && req.get_param_value("follow") == "1") {
+        lanes->enter_detached(); // open for as long as the client follows
+        return true;
+    }
+    if (expected_transfer_size(req) < g_bulk_threshold) return true;
+    if (lanes->enter_bulk()) return true;
+    res.status = 503;
+    res.set_header("Retry-After", "10");
+    res.set_content("Server busy: too many large transfers in progress, retry later", "text/plain");
+    return false;
+}
+
+// Called from the logger, after the response (including streamed bodies) was written.
+void request_finished(const httplib::Request& req, const httplib::Response& res) {
+    metrics_record_request(req, res);
+    if (LaneTaskQueue::t_current) LaneTaskQueue::t_current->leave_bulk();
+}
+
+// Worker pool, lanes and the pre-routing hook (shared by main and the benchmark harness).
+void configure_server(httplib::Server& svr) {
+    svr.set_tcp_nodelay(true);
+    svr.new_task_queue = [] { return new LaneTaskQueue(g_interactive_workers, g_bulk_workers); };
+    svr.set_pre_routing_handler([](const httplib::Request& req, httplib::Response& res) {
+        if (g_metrics_enabled) metrics_request_started();
+        return admit_request(req, res) ? httplib::Server::HandlerResponse::Unhandled
+            : httplib::Server::HandlerResponse::Handled;
+        });
+}
+
+// Route table for the current mode (shared by main and the benchmark harness).
+void register_routes(httplib::Server& svr) {
+    // Registered first so the catch-all GET routes below cannot shadow it.
+    if (g_metrics_enabled && !g_metrics_path.empty()) {
+        svr.Get(g_metrics_path, instrumented(MetricHandler::Metrics, metrics_handler));
+    }
+
+    if (!g_bundle_path.empty()) {
+        svr.Get(R"(/(.*))", instrumented(MetricHandler::Bundle, serve_bundle_handler));
+    }
+    else if (g_embedded_mode) {
+        svr.Get(R"(/(.*))", instrumented(MetricHandler::Embedded, serve_embedded_handler));
+    }
+    else if (!g_web_root_path.empty()) {
+        svr.Get(R"(/(.*))", instrumented(MetricHandler::Static, serve_static_content_handler));
+    }
+    else {
+        svr.Get(R"(/(.*))", instrumented(MetricHandler::Browse, browse_handler));
+        svr.Post("/upload", instrumented(MetricHandler::Upload, upload_handler));
+        svr.Post("/upload_link", instrumented(MetricHandler::Upload, upload_link_handler));
+        svr.Post("/upload_delta", instrumented(MetricHandler::Upload, upload_delta_handler));
+        svr.Post("/upload_tar", instrumented(MetricHandler::UploadTar, upload_tar_handler));
+        svr.Post("/copy", instrumented(MetricHandler::FileOp, [](const httplib::Request& req, httplib::Response& res) { file_op_handler(req, res, false); }));
+        svr.Post("/move", instrumented(MetricHandler::FileOp, [](const httplib::Request& req, httplib::Response& res) { file_op_handler(req, res, true); }));
+    }
+
+    // Catch-all POST handler (MUST be registered after real POST routes)
+    // Ensures body parsing & logging even for unknown POST endpoints (404).
+    svr.Post(R"(/(.*))", instrumented(MetricHandler::PostCatchAll, [](const httplib::Request& req, httplib::Response& res) {
+        // Respect authentication if enabled
+        if (require_auth) {
+            if (!authenticate(req, res)) return; // sends 401
+        }
+        res.status = 404;
+        res.set_content("Not Found", "text/plain");
+        }));
+}
+
+#ifdef ARTWEB_BENCH
+// ------------------------ Benchmarks ------------------------
+
+// End-to-end benchmark harness, compiled only with ARTWEB_BENCH:
+//   ArtWeb --bench [--bench-out FILE] [--bench-conns N] [--bench-seconds S]
+//                  [--bench-small N] [--bench-dir-entries N] [--bench-huge N] [--bench-huge-mb MB]
+//                  [--bench-dir PATH] [--bench-keep]
+// Generates synthetic web roots, starts the real route table in-process on
+// loopback and drives it with keep-alive httplib::Client load generators.
+// Results (throughput and latency percentiles per scenario) are printed as JSON.
+struct BenchOptions {
+    fs::path work_dir;
+    std::string out_path;         // JSON file; stdout when empty
+    int connections = 8;
+    double seconds = 5.0;
+    int small_files = 10000;
+    int dir_entries = 100000;
+    int huge_files = 2;
+    std::uint64_t huge_mb = 128;
+    bool keep = false;
+};
+
+struct BenchResult {
+    std::string name;
+    int connections = 0;
+    std::uint64_t requests = 0;
+    std::uint64_t errors = 0;
+    std::uint64_t bytes = 0;
+    double seconds = 0;
+    std::vector<double> latencies_ms;
+};
+
+// One operation against the server; adds transferred payload bytes and returns success.
+using BenchOp = std::function<bool(httplib::Client& cli, int worker, std::uint64_t iteration, std::uint64_t& bytes)>;
+
+BenchResult run_bench_scenario(const std::string& name, int port, const BenchOptions& opts, int connections, const BenchOp& op) {
+    BenchResult result;
+    result.name = name;
+    result.connections = connections;
+    std::mutex merge_mutex;
+    std::atomic<std::uint64_t> iterations{ 0 };
+
+    std::cerr << "  " << name << " (" << connections << " connections, " << opts.seconds << " s)..." << std::endl;
+    const auto start = std::chrono::steady_clock::now();
+    const auto deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(opts.seconds));
+
+    std::vector<std::thread> workers;
+    for (int w = 0; w < connections; ++w) {
+        workers.emplace_back([&, w]() {
+            httplib::Client cli("127.0.0.1", port);
+            cli.set_keep_alive(true);
+            cli.set_tcp_nodelay(true);
+            cli.set_read_timeout(300, 0);
+            cli.set_write_timeout(300, 0);
+            std::vector<double> latencies;
+            std::uint64_t requests = 0, errors = 0, bytes = 0;
+            while (std::chrono::steady_clock::now() < deadline) {
+                const auto t0 = std::chrono::steady_clock::now();
+                const bool ok = op(cli, w, iterations.fetch_add(1), bytes);
+                const auto t1 = std::chrono::steady_clock::now();
+                ++requests;
+                if (!ok) ++errors;
+                latencies.push_back(std::chrono::duration<double, std::milli>(t1 - t0).count());
+            }
+            std::lock_guard<std::mutex> lock(merge_mutex);
+            result.requests += requests;
+            result.errors += errors;
+            result.bytes += bytes;
+            result.latencies_ms.insert(result.latencies_ms.end(), latencies.begin(), latencies.end());
+            });
+    }
+    for (auto& t : workers) t.join();
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::sort(result.latencies_ms.begin(), result.latencies_ms.end());
+    return result;
+}
+
+double bench_percentile(const std::vector<double>& sorted, double q) {
+    if (sorted.empty()) return 0;
+    std::size_t idx = static_cast<std::size_t>(std::ceil(q * static_cast<double>(sorted.size())));
+    return sorted[std::min(sorted.size() - 1, idx == 0 ? 0 : idx - 1)];
+}
+
+std::string bench_results_json(const BenchOptions& opts, const std::vector<BenchResult>& results) {
+    std::ostringstream o;
+    o << std::fixed << std::setprecision(3);
+    o << "{\n  \"version\": \"" << VERSION << "\",\n"
+        << "  \"config\": { \"connections\": " << opts.connections << ", \"seconds\": " << opts.seconds
+        << ", \"small_files\": " << opts.small_files << ", \"dir_entries\": " << opts.dir_entries
+        << ", \"huge_files\": " << opts.huge_files << ", \"huge_mb\": " << opts.huge_mb << " },\n"
+        << "  \"results\": [\n";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        const double secs = r.seconds > 0 ? r.seconds : 1;
+        o << "    { \"name\": \"" << r.name << "\", \"connections\": " << r.connections
+            << ", \"requests\": " << r.requests << ", \"errors\": " << r.errors
+            << ", \"seconds\": " << r.seconds
+            << ", \"requests_per_sec\": " << (r.requests / secs)
+            << ", \"mb_per_sec\": " << (r.bytes / secs / (1024.0 * 1024.0))
+            << ", \"latency_ms\": { \"p50\": " << bench_percentile(r.latencies_ms, 0.50)
+            << ", \"p90\": " << bench_percentile(r.latencies_ms, 0.90)
+            << ", \"p99\": " << bench_percentile(r.latencies_ms, 0.99)
+            << ", \"p999\": " << bench_percentile(r.latencies_ms, 0.999)
+            << ", \"max\": " << (r.latencies_ms.empty() ? 0.0 : r.latencies_ms.back()) << " } }"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    o << "  ]\n}\n";
+    return o.str();
+}
+
+// In-memory ustar archive of `count` files of `size` bytes (for /upload_tar).
+std::string bench_make_tar(int count, std::size_t size) {
+    std::string tar;
+    const std::string payload(size, 'x');
+    for (int i = 0; i < count; ++i) {
+        char h[512] = {};
+        std::snprintf(h, 100, "f%05d.txt", i);
+        std::snprintf(h + 100, 8, "%07o", 0644);
+        std::snprintf(h + 108, 8, "%07o", 0);
+        std::snprintf(h + 116, 8, "%07o", 0);
+        std::snprintf(h + 124, 12, "%011llo", static_cast<unsigned long long>(size));
+        std::snprintf(h + 136, 12, "%011llo", 0ULL);
+        h[156] = '0';
+        std::memcpy(h + 257, "ustar\0" "00", 8);
+        std::memset(h + 148, ' ', 8);
+        unsigned sum = 0;
+        for (unsigned char c : h) sum += c;
+        std::snprintf(h + 148, 8, "%06o", sum);
+        tar.append(h, sizeof(h));
+        tar += payload;
+        tar.append((512 - size % 512) % 512, '\0');
+    }
+    tar.append(1024, '\0');
+    return tar;
+}
+
+bool bench_generate_roots(const BenchOptions& opts) {
+    std::cerr << "Generating synthetic web roots in " << opts.work_dir.u8string() << "..." << std::endl;
+    const fs::path root = opts.work_dir / "root";
+    std::error_code ec;
+    fs::create_directories(root / "small", ec);
+    fs::create_directories(root / "bigdir", ec);
+    fs::create_directories(root / "huge", ec);
+    if (ec) return false;
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> small_size(512, 4096);
+    std::string buf;
+    for (int i = 0; i < opts.small_files; ++i) {
+        const fs::path dir = root / "small" / ("d" + std::to_string(i / 1000));
+        if (i % 1000 == 0) fs::create_directories(dir, ec);
+        buf.assign(static_cast<std::size_t>(small_size(rng)), static_cast<char>('a' + i % 26));
+        std::ofstream(dir / ("f" + std::to_string(i) + ".txt"), std::ios::binary) << buf;
+    }
+    for (int i = 0; i < opts.dir_entries; ++i) {
+        std::ofstream(root / "bigdir" / ("entry_" + std::to_string(i) + ".dat"), std::ios::binary);
+    }
+    buf.assign(1024 * 1024, '\0');
+    for (std::size_t i = 0; i < buf.size(); ++i) buf[i] = static_cast<char>(rng());
+    for (int i = 0; i < opts.huge_files; ++i) {
+        std::ofstream ofs(root / "huge" / ("huge_" + std::to_string(i) + ".bin"), std::ios::binary);
+        for (std::uint64_t mb = 0; mb < opts.huge_mb; ++mb) ofs.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+        if (!ofs) return false;
+    }
+    return true;
+}
+
+// Start the regular route table for the current globals on a loopback port.
+int bench_start_server(httplib::Server& svr, std::thread& thread) {
+    configure_server(svr);
+    register_routes(svr);
+    svr.set_logger(request_finished);
+    svr.set_payload_max_length((std::numeric_limits<std::size_t>::max)());
+    const int port = svr.bind_to_any_port("127.0.0.1");
+    if (port <= 0) return -1;
+    thread = std::thread([&svr]() { svr.listen_after_bind(); });
+    svr.wait_until_ready();
+    return port;
+}
+
+int run_benchmarks(int argc, char* argv[]) {
+    BenchOptions opts;
+    opts.work_dir = fs::temp_directory_path() / ("artweb-bench-" + std::to_string(std::time(nullptr)));
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        try {
+            if (arg == "--bench-out" && i + 1 < argc) opts.out_path = argv[++i];
+            else if (arg == "--bench-conns" && i + 1 < argc) opts.connections = std::max(1, std::stoi(argv[++i]));
+            else if (arg == "--bench-seconds" && i + 1 < argc) opts.seconds = std::stod(argv[++i]);
+            else if (arg == "--bench-small" && i + 1 < argc) opts.small_files = std::max(1, std::stoi(argv[++i]));
+            else if (arg == "--bench-dir-entries" && i + 1 < argc) opts.dir_entries = std::max(1, std::stoi(argv[++i]));
+            else if (arg == "--bench-huge" && i + 1 < argc) opts.huge_files = std::max(1, std::stoi(argv[++i]));
+            else if (arg == "--bench-huge-mb" && i + 1 < argc) opts.huge_mb = std::max<std::uint64_t>(1, std::stoull(argv[++i]));
+            else if (arg == "--bench-dir" && i + 1 < argc) opts.work_dir = fs::u8path(argv[++i]);
+            else if (arg == "--bench-keep") opts.keep = true;
+        }
+        catch (...) {
+            std::cerr << "Invalid value for " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    if (!bench_generate_roots(opts)) {
+        std::cerr << "Error: failed to generate benchmark data in " << opts.work_dir.u8string() << std::endl;
+        return 1;
     }
 
-    html << "  </script>\n"
-        << "</body>\n"
-        << "</html>";
-    res.set_content(html.str(), "text/html; charset=utf-8");
+    const fs::path root = opts.work_dir / "root";
+    const fs::path saved_cwd = fs::current_path();
+    std::vector<BenchResult> results;
+    const std::string tar_body = bench_make_tar(100, 4096);
+    const std::string upload_body(1024 * 1024, 'u');
+    const std::uint64_t huge_size = opts.huge_mb * 1024 * 1024;
+    auto small_path = [&opts](std::uint64_t n) {
+        const int i = static_cast<int>((n * 2654435761ULL) % static_cast<std::uint64_t>(opts.small_files));
+        return "/small/d" + std::to_string(i / 1000) + "/f" + std::to_string(i) + ".txt";
+    };
+    auto count_body = [](const httplib::Result& r, std::uint64_t& bytes, int expected = 200) {
+        if (!r || r->status != expected) return false;
+        bytes += r->body.size();
+        return true;
+    };
+
+    // --- Static mode ---
+    {
+        std::cerr << "Static mode:" << std::endl;
+        g_web_root_path = root.u8string();
+        open_root(g_root, root);
+        httplib::Server svr;
+        std::thread th;
+        const int port = bench_start_server(svr, th);
+        results.push_back(run_bench_scenario("static_small_get", port, opts, opts.connections,
+            [&](httplib::Client& cli, int, std::uint64_t n, std::uint64_t& bytes) {
+                return count_body(cli.Get(small_path(n)), bytes);
+            }));
+        svr.stop();
+        th.join();
+    }
+
+    // --- Browse/upload mode (rooted at the current directory, like the real server) ---
+    {
+        std::cerr << "Browse mode:" << std::endl;
+        g_web_root_path.clear();
+        fs::current_path(root);
+        open_root(g_root, root);
+        httplib::Server svr;
+        std::thread th;
+        const int port = bench_start_server(svr, th);
+        const int bulk_conns = std::min(opts.connections, 4);
+
+        results.push_back(run_bench_scenario("browse_small_get", port, opts, opts.connections,
+            [&](httplib::Client& cli, int, std::uint64_t n, std::uint64_t& bytes) {
+                return count_body(cli.Get(small_path(n)), bytes);
+            }));
+        results.push_back(run_bench_scenario("listing_1k", port, opts, opts.connections,
+            [&](httplib::Client& cli, int, std::uint64_t, std::uint64_t& bytes) {
+                return count_body(cli.Get("/small/d0"), bytes);
+            }));
+        results.push_back(run_bench_scenario("listing_" + std::to_string(opts.dir_entries), port, opts, bulk_conns,
+            [&](httplib::Client& cli, int, std::uint64_t, std::uint64_t& bytes) {
+                return count_body(cli.Get("/bigdir"), bytes);
+            }));
+        results.push_back(run_bench_scenario("download_huge", port, opts, bulk_conns,
+            [&](httplib::Client& cli, int, std::uint64_t n, std::uint64_t& bytes) {
+                std::uint64_t got = 0;
+                auto r = cli.Get("/huge/huge_" + std::to_string(n % static_cast<std::uint64_t>(opts.huge_files)) + ".bin",
+                    [&got](const char*, size_t len) { got += len; return true; });
+                bytes += got;
+                return r && r->status == 200 && got == huge_size;
+            }));
+        results.push_back(run_bench_scenario("range_download_1m", port, opts, opts.connections,
+            [&](httplib::Client& cli, int, std::uint64_t n, std::uint64_t& bytes) {
+                const std::uint64_t mb = (n * 2654435761ULL) % opts.huge_mb;
+                httplib::Headers headers = { httplib::make_range_header({ { static_cast<ssize_t>(mb << 20), static_cast<ssize_t>(((mb + 1) << 20) - 1) } }) };
+                return count_body(cli.Get("/huge/huge_0.bin", headers), bytes, 206);
+            }));
+        results.push_back(run_bench_scenario("upload_single_1m", port, opts, opts.connections,
+            [&](httplib::Client& cli, int w, std::uint64_t n, std::uint64_t& bytes) {
+                httplib::MultipartFormDataItems items = {
+                    { "file", upload_body, "s_" + std::to_string(w) + "_" + std::to_string(n) + ".bin", "application/octet-stream" } };
+                auto r = cli.Post("/upload?dir=bench_up/single", items);
+                if (r && r->status == 200) bytes += upload_body.size();
+                return r && r->status == 200;
+            }));
+        results.push_back(run_bench_scenario("upload_chunked_1m", port, opts, opts.connections,
+            [&](httplib::Client& cli, int w, std::uint64_t n, std::uint64_t& bytes) {
+                const std::size_t chunk = 128 * 1024;
+                const std::size_t total = upload_body.size() / chunk;
+                const std::string id = "b" + std::to_string(w) + "x" + std::to_string(n);
+                for (std::size_t c = 0; c < total; ++c) {
+                    httplib::MultipartFormDataItems items = {
+                        { "file", upload_body.substr(c * chunk, chunk), "c_" + id + ".bin", "application/octet-stream" } };
+                    auto r = cli.Post("/upload?dir=bench_up/chunked&upload_id=" + id + "&chunk_index=" + std::to_string(c) +
+                        "&total_chunks=" + std::to_string(total) + "&offset=" + std::to_string(c * chunk) +
+                        "&file_size=" + std::to_string(upload_body.size()), items);
+                    if (!r || r->status != 200) return false;
+                }
+                bytes += upload_body.size();
+                return true;
+            }));
+        results.push_back(run_bench_scenario("upload_tar_100x4k", port, opts, opts.connections,
+            [&](httplib::Client& cli, int w, std::uint64_t n, std::uint64_t& bytes) {
+                auto r = cli.Post("/upload_tar?dir=bench_up/tar/t" + std::to_string(w) + "_" + std::to_string(n), tar_body, "application/x-tar");
+                if (r && r->status == 200) bytes += tar_body.size();
+                return r && r->status == 200;
+            }));
+
+        svr.stop();
+        th.join();
+        fs::current_path(saved_cwd);
+    }
+
+    const std::string json = bench_results_json(opts, results);
+    if (opts.out_path.empty()) {
+        std::cout << json;
+    }
+    else {
+        std::ofstream(fs::u8path(opts.out_path), std::ios::binary) << json;
+        std::cerr << "Results written to " << opts.out_path << std::endl;
+    }
+
+    if (!opts.keep) {
+        std::error_code ec;
+        fs::remove_all(opts.work_dir, ec);
+    }
+    return 0;
 }
 
-// Check if a port is free by attempting to bind
-bool is_port_free(int port) {
-#ifdef _WIN32
-    WSADATA wsaData;
-    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) return false;
-#endif
-    int sockfd = socket(AF_INET, SOCK_STREAM, 0);
-    if (sockfd < 0) {
-#ifdef _WIN32
-        WSACleanup();
-#endif
-        return false;
+// --- Micro-benchmarks for the escaping helpers ---
+//   ArtWeb --bench-micro [--bench-out FILE] [--bench-seconds S]
+// First checks url_encode, url_decode, url_encode_path, sanitize_for_log and
+// base64_encode at every SIMD level this CPU supports against the original
+// byte-at-a-time versions below, then times each level. Exit status 1 on any mismatch.
+
+std::string reference_base64_encode(const std::string& in) {
+    std::string out;
+    int val = 0, valb = -6;
+    for (unsigned char c : in) {
+        val = (val << 8) + c;
+        valb += 8;
+        while (valb >= 0) {
+            out.push_back(base64_chars[(val >> valb) & 0x3F]);
+            valb -= 6;
+        }
     }
-    struct sockaddr_in addr;
-    addr.sin_family = AF_INET;
-    addr.sin_port = htons(port);
-    addr.sin_addr.s_addr = INADDR_ANY;
-    int result = bind(sockfd, (struct sockaddr*)&addr, sizeof(addr));
-#ifdef _WIN32
-    closesocket(sockfd);
-    WSACleanup();
-#else
-    close(sockfd);
-#endif
-    return (result == 0);
+    if (valb > -6) out.push_back(base64_chars[((val << 8) >> (valb + 8)) & 0x3F]);
+    while (out.size() % 4) out.push_back('=');
+    return out;
 }
 
-// Static Content Server Handler
-void serve_static_content_handler(const httplib::Request& req, httplib::Response& res) {
-    if (!authenticate(req, res)) return;
+std::string reference_url_encode(const std::string& value) {
+    std::ostringstream escaped;
+    escaped.fill('0');
+    escaped << std::hex;
+    for (unsigned char c : value) {
+        if (isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~') {
+            escaped << c;
+        }
+        else {
+            escaped << '%' << std::setw(2) << int(c);
+        }
+    }
+    return escaped.str();
+}
 
-    auto relative_path_str = req.matches[1].str();
-    if (relative_path_str.empty() || relative_path_str.back() == '/') {
-        relative_path_str += "index.html";
+std::string reference_url_decode(const std::string& value) {
+    auto hexval = [](char c) -> int {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return 10 + (c - 'a');
+        if (c >= 'A' && c <= 'F') return 10 + (c - 'A');
+        return -1;
+        };
+    std::string out;
+    out.reserve(value.size());
+    for (size_t i = 0; i < value.size(); ++i) {
+        char c = value[i];
+        if (c == '%' && i + 2 < value.size()) {
+            int hi = hexval(value[i + 1]);
+            int lo = hexval(value[i + 2]);
+            if (hi >= 0 && lo >= 0) {
+                out.push_back(static_cast<char>((hi << 4) | lo));
+                i += 2;
+                continue;
+            }
+        }
+        out.push_back(c);
     }
-    fs::path requested_path = relative_path_str;
-    fs::path full_path = fs::path(g_web_root_path) / requested_path;
+    return out;
+}
 
-    auto canonical_root = fs::weakly_canonical(g_web_root_path);
-    auto canonical_full = fs::weakly_canonical(full_path);
-    if (canonical_full.string().rfind(canonical_root.string(), 0) != 0) {
-        res.status = 403;
-        res.set_content("Forbidden: Access denied.", "text/plain");
-        return;
+std::string reference_url_encode_path(const std::string& path) {
+    std::string out;
+    out.reserve(path.size());
+    std::string seg;
+    for (size_t i = 0; i < path.size(); ++i) {
+        char c = path[i];
+        if (c == '/') {
+            out += reference_url_encode(seg);
+            out.push_back('/');
+            seg.clear();
+        }
+        else {
+            seg.push_back(c);
+        }
     }
-    if (!fs::exists(full_path) || !fs::is_regular_file(full_path)) {
-        res.status = 404;
-        res.set_content("Not Found", "text/plain");
-        return;
+    out += reference_url_encode(seg);
+    return out;
+}
+
+std::string reference_sanitize_for_log(const std::string& s, size_t maxlen = 1024) {
+    std::ostringstream o;
+    o << std::uppercase << std::hex;
+    size_t n = std::min(s.size(), maxlen);
+    for (size_t i = 0; i < n; ++i) {
+        unsigned char c = static_cast<unsigned char>(s[i]);
+        if (c == '\r') { o << "\\r"; }
+        else if (c == '\n') { o << "\\n"; }
+        else if (c == '\t') { o << "\\t"; }
+        else if (c >= 32 && c < 127) {
+            o << static_cast<char>(c);
+        }
+        else {
+            o << "\\x" << std::setw(2) << std::setfill('0') << static_cast<int>(c);
+        }
     }
-    std::ifstream ifs(full_path, std::ios::binary);
-    if (!ifs) {
-        res.status = 500;
-        res.set_content("Internal Server Error: Could not read file.", "text/plain");
-        return;
+    if (s.size() > maxlen) o << "…(truncated)";
+    return o.str();
+}
+
+// Keeps the timed results observable so the calls are not optimized away.
+volatile std::size_t g_micro_sink = 0;
+
+struct MicroFunction {
+    const char* name;
+    std::function<std::string(const std::string&)> fast;
+    std::function<std::string(const std::string&)> reference;
+};
+
+std::vector<MicroFunction> micro_functions() {
+    return {
+        { "url_encode", url_encode, reference_url_encode },
+        { "url_decode", url_decode, reference_url_decode },
+        { "url_encode_path", url_encode_path, reference_url_encode_path },
+        { "sanitize_for_log", [](const std::string& s) { return sanitize_for_log(s); },
+            [](const std::string& s) { return reference_sanitize_for_log(s); } },
+        { "sanitize_for_log_37", [](const std::string& s) { return sanitize_for_log(s, 37); },
+            [](const std::string& s) { return reference_sanitize_for_log(s, 37); } },
+        { "base64_encode", base64_encode, reference_base64_encode },
+    };
+}
+
+std::vector<SimdLevel> micro_levels() {
+    std::vector<SimdLevel> levels = { SimdLevel::Scalar };
+    const SimdLevel best = detect_simd_level();
+    if (best >= SimdLevel::SSE2) levels.push_back(SimdLevel::SSE2);
+    if (best >= SimdLevel::AVX2) levels.push_back(SimdLevel::AVX2);
+    return levels;
+}
+
+const char* simd_level_name(SimdLevel level) {
+    switch (level) {
+    case SimdLevel::AVX2: return "avx2";
+    case SimdLevel::SSE2: return "sse2";
+    default: return "scalar";
     }
-    std::ostringstream oss;
-    oss << ifs.rdbuf();
-    res.status = 200;
-    const auto mime = get_mime_type(full_path.string());
-    res.set_content(oss.str(), add_charset_if_text(mime).c_str());
 }
 
+// Random strings over several alphabets, plus every byte value at every lane
+// position of a 64-byte clean run, so each SIMD lane sees each class boundary.
+std::vector<std::string> micro_equivalence_inputs() {
+    std::vector<std::string> inputs;
+    std::mt19937 rng(12345);
+    const std::string alphabets[] = {
+        "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789-_.~",
+        "abcXYZ019-_.~/ %+&=?#\\\r\n\t\x01\x7f",
+        "%%%0123456789abcdefABCDEFgG/a",
+        std::string("\xd0\x9f\xd1\x80\xd0\xb8\xd0\xb2\xd0\xb5\xd1\x82 file.txt/", 21),
+    };
+    for (std::size_t len = 0; len <= 160; ++len) {
+        for (const auto& alphabet : alphabets) {
+            for (int rep = 0; rep < 4; ++rep) {
+                std::string s(len, '\0');
+                for (auto& c : s) c = alphabet[rng() % alphabet.size()];
+                inputs.push_back(s);
+            }
+        }
+        std::string any(len, '\0');
+        for (auto& c : any) c = static_cast<char>(rng() & 0xFF);
+        inputs.push_back(any);
+    }
+    for (int b = 0; b < 256; ++b) {
+        for (std::size_t pos = 0; pos < 64; ++pos) {
+            std::string s(64, 'a');
+            s[pos] = static_cast<char>(b);
+            inputs.push_back(s);
+        }
+    }
+    std::string big(1 << 20, '\0');
+    for (auto& c : big) c = alphabets[1][rng() % alphabets[1].size()];
+    inputs.push_back(big);
+    inputs.push_back(std::string(1 << 20, 'a'));
+    inputs.push_back(std::string(4096, '%') + "41");
+    return inputs;
+}
+
+int run_micro_benchmarks(int argc, char* argv[]) {
+    std::string out_path;
+    double seconds = 0.25;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        try {
+            if (arg == "--bench-out" && i + 1 < argc) out_path = argv[++i];
+            else if (arg == "--bench-seconds" && i + 1 < argc) seconds = std::stod(argv[++i]);
+        }
+        catch (...) {
+            std::cerr << "Invalid value for " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    const SimdLevel saved_level = g_simd_level;
+    const auto functions = micro_functions();
+    const auto levels = micro_levels();
+
+    // --- Equivalence ---
+    const auto inputs = micro_equivalence_inputs();
+    std::uint64_t checks = 0, mismatches = 0;
+    for (SimdLevel level : levels) {
+        g_simd_level = level;
+        for (const auto& fn : functions) {
+            for (const auto& in : inputs) {
+                ++checks;
+                if (fn.fast(in) != fn.reference(in)) {
+                    if (++mismatches <= 10) {
+                        std::cerr << "MISMATCH " << fn.name << " [" << simd_level_name(level) << "] input "
+                            << reference_sanitize_for_log(in, 80) << " (" << in.size() << " bytes)" << std::endl;
+                    }
+                }
+            }
+        }
+    }
+    std::cerr << "Equivalence: " << checks << " checks, " << mismatches << " mismatches" << std::endl;
+
+    // --- Timing ---
+    struct Corpus { const char* name; std::vector<std::string> items; };
+    std::vector<Corpus> corpora;
+    {
+        std::mt19937 rng(777);
+        Corpus names{ "listing_names", {} };
+        for (int i = 0; i < 1000; ++i)
+            names.items.push_back("photos/2024/IMG_" + std::to_string(20240000 + rng() % 10000) + (i % 10 == 0 ? " (copy).jpg" : ".jpg"));
+        corpora.push_back(names);
+        Corpus utf8{ "utf8_names", {} };
+        for (int i = 0; i < 1000; ++i)
+            utf8.items.push_back("\xd0\x94\xd0\xbe\xd0\xba\xd1\x83\xd0\xbc\xd0\xb5\xd0\xbd\xd1\x82\xd1\x8b/report_" + std::to_string(i) + ".pdf");
+        corpora.push_back(utf8);
+        Corpus body{ "post_body_4k", {} };
+        std::string form;
+        while (form.size() < 4096) form += "field" + std::to_string(form.size()) + "=some+value%20here&";
+        body.items.push_back(form);
+        corpora.push_back(body);
+        Corpus blob{ "ascii_64k", { std::string(64 * 1024, 'x') } };
+        corpora.push_back(blob);
+    }
+
+    std::ostringstream o;
+    o << std::fixed << std::setprecision(3);
+    o << "{\n  \"version\": \"" << VERSION << "\",\n"
+        << "  \"equivalence\": { \"checks\": " << checks << ", \"mismatches\": " << mismatches << " },\n"
+        << "  \"results\": [\n";
+    bool first = true;
+    for (const auto& fn : functions) {
+        for (const auto& corpus : corpora) {
+            std::size_t corpus_bytes = 0;
+            for (const auto& s : corpus.items) corpus_bytes += s.size();
+            auto measure = [&](const std::function<std::string(const std::string&)>& f) {
+                std::size_t sink = 0;
+                std::uint64_t passes = 0;
+                const auto start = std::chrono::steady_clock::now();
+                double elapsed = 0;
+                do {
+                    for (const auto& s : corpus.items) sink += f(s).size();
+                    ++passes;
+                    elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                } while (elapsed < seconds);
+                g_micro_sink = sink;
+                const double calls = static_cast<double>(passes) * corpus.items.size();
+                return std::make_pair(elapsed * 1e9 / calls, passes * corpus_bytes / elapsed / (1024.0 * 1024.0));
+            };
+            auto emit = [&](const char* impl, const std::pair<double, double>& r) {
+                o << (first ? "" : ",\n") << "    { \"function\": \"" << fn.name << "\", \"corpus\": \"" << corpus.name
+                    << "\", \"impl\": \"" << impl << "\", \"ns_per_call\": " << r.first << ", \"mb_per_sec\": " << r.second << " }";
+                first = false;
+            };
+            std::cerr << "  " << fn.name << " / " << corpus.name << "..." << std::endl;
+            emit("reference", measure(fn.reference));
+            for (SimdLevel level : levels) {
+                g_simd_level = level;
+                emit(simd_level_name(level), measure(fn.fast));
+            }
+        }
+    }
+    o << "\n  ]\n}\n";
+    g_simd_level = saved_level;
+
+    if (out_path.empty()) {
+        std::cout << o.str();
+    }
+    else {
+        std::ofstream(fs::u8path(out_path), std::ios::binary) << o.str();
+        std::cerr << "Results written to " << out_path << std::endl;
+    }
+    return mismatches == 0 ? 0 : 1;
+}
+#endif
+
 int main(int argc, char* argv[]) {
 #ifdef _WIN32
     SetConsoleOutputCP(CP_UTF8);
@@ -1126,10 +9429,26 @@ int main(int argc, char* argv[]) {
     std::string auth_password = "";
     bool use_ssl = false;
     std::string cert_path, key_path;
+    std::string mime_types_path;
+    std::string dedup_path;
+    std::string line_index_path;
+    std::uint64_t limit_rate = 0, limit_rate_ip = 0, limit_upload = 0;
 
     for (int i = 1; i < argc; i++) {
         std::string arg = argv[i];
         if (arg == "-h" || arg == "--help") { print_usage(argv[0]); return 0; }
+#ifdef ARTWEB_BENCH
+        else if (arg == "--bench") { return run_benchmarks(argc, argv); }
+        else if (arg == "--bench-micro") { return run_micro_benchmarks(argc, argv); }
+#endif
+        else if (arg == "--embed-gen" && i + 2 < argc) { return generate_embedded_header(argv[i + 1], argv[i + 2]); }
+        else if (arg == "--embedded") { g_embedded_mode = true; }
+        else if (arg == "--bundle-build" && i + 2 < argc) { return build_bundle(argv[i + 1], argv[i + 2]); }
+        else if (arg == "--mime-gen" && i + 2 < argc) { return generate_mime_header(argv[i + 1], argv[i + 2]); }
+        else if (arg == "--delta-upload" && i + 2 < argc) { return run_delta_upload(argv[i + 1], argv[i + 2]); }
+        else if (arg == "--bundle" && i + 1 < argc) { g_bundle_path = argv[++i]; }
+        else if (arg == "--metrics" && i + 1 < argc) { g_metrics_path = argv[++i]; }
+        else if (arg == "--metrics-port" && i + 1 < argc) { try { g_metrics_port = std::stoi(argv[++i]); } catch (...) { std::cerr << "Invalid --metrics-port value.\n"; return 1; } }
         else if ((arg == "-p" || arg == "--port") && i + 1 < argc) { try { port = std::stoi(argv[++i]); port_is_default = false; } catch (...) { std::cerr << "Invalid port value.\n"; return 1; } }
         else if (arg == "--pass" && i + 1 < argc) { auth_password = argv[++i]; require_auth = true; }
         else if (arg == "--proxy") { g_proxy_upload_mode = true; }
@@ -1138,11 +9457,118 @@ int main(int argc, char* argv[]) {
         else if ((arg == "-c" || arg == "--cert") && i + 1 < argc) { cert_path = argv[++i]; }
         else if ((arg == "-k" || arg == "--key") && i + 1 < argc) { key_path = argv[++i]; }
         else if ((arg == "-i" || arg == "--index") && i + 1 < argc) { g_web_root_path = argv[++i]; }
+        else if (arg == "--file-cache" && i + 1 < argc) { try { g_file_cache_max = static_cast<std::size_t>(std::stoul(argv[++i])); } catch (...) { std::cerr << "Invalid --file-cache value.\n"; return 1; } }
+        else if (arg == "--file-cache-ttl" && i + 1 < argc) { try { g_file_cache_ttl = std::stoi(argv[++i]); } catch (...) { std::cerr << "Invalid --file-cache-ttl value.\n"; return 1; } }
+        else if (arg == "--mime-types" && i + 1 < argc) { mime_types_path = argv[++i]; }
+        else if (arg == "--dedup" && i + 1 < argc) { dedup_path = argv[++i]; }
+        else if ((arg == "--limit-rate" || arg == "--limit-rate-ip" || arg == "--limit-rate-conn" || arg == "--limit-upload") && i + 1 < argc) {
+            std::uint64_t rate = 0;
+            if (!parse_rate(argv[++i], rate)) { std::cerr << "Invalid " << arg << " value (bytes/s, e.g. 512k, 10M).\n"; return 1; }
+            if (arg == "--limit-rate") limit_rate = rate;
+            else if (arg == "--limit-rate-ip") limit_rate_ip = rate;
+            else if (arg == "--limit-rate-conn") g_limit_rate_conn = rate;
+            else limit_upload = rate;
+        }
+        else if (arg == "--rate-weight" && i + 1 < argc) {
+            const std::string spec = argv[++i];
+            const auto eq = spec.rfind('=');
+            double weight = 0;
+            try { weight = eq == std::string::npos ? 0 : std::stod(spec.substr(eq + 1)); } catch (...) {}
+            if (weight <= 0) { std::cerr << "Invalid --rate-weight value (expected IP=WEIGHT).\n"; return 1; }
+            g_outbound.set_weight(spec.substr(0, eq), weight);
+            g_inbound.set_weight(spec.substr(0, eq), weight);
+        }
+        else if (arg == "--workers" && i + 1 < argc) { try { g_interactive_workers = std::max<std::size_t>(1, std::stoul(argv[++i])); } catch (...) { std::cerr << "Invalid --workers value.\n"; return 1; } }
+        else if (arg == "--bulk-workers" && i + 1 < argc) { try { g_bulk_workers = static_cast<std::size_t>(std::stoul(argv[++i])); } catch (...) { std::cerr << "Invalid --bulk-workers value.\n"; return 1; } }
+        else if (arg == "--io-engine" && i + 1 < argc) {
+            const std::string engine = argv[++i];
+            if (engine == "sync") g_io_engine = IoEngine::Sync;
+            else if (engine == "uring") g_io_engine = IoEngine::Uring;
+            else { std::cerr << "Invalid --io-engine value (sync or uring).\n"; return 1; }
+        }
+        else if (arg == "--readahead" && i + 1 < argc) { try { g_readahead = std::stoull(argv[++i]) << 20; } catch (...) { std::cerr << "Invalid --readahead value.\n"; return 1; } }
+        else if (arg == "--line-index" && i + 1 < argc) { line_index_path = argv[++i]; }
+        else if (arg == "--grep-timeout" && i + 1 < argc) { try { g_grep_timeout = std::stoi(argv[++i]); } catch (...) { std::cerr << "Invalid --grep-timeout value.\n"; return 1; } }
+        else if (arg == "--tree-index") { g_tree_index_enabled = true; }
+        else if (arg == "--max-followers" && i + 1 < argc) { try { g_max_followers = std::stoul(argv[++i]); } catch (...) { std::cerr << "Invalid --max-followers value.\n"; return 1; } }
+        else if (arg == "--direct-io" && i + 1 < argc) { try { g_direct_io_threshold = std::stoull(argv[++i]) << 20; } catch (...) { std::cerr << "Invalid --direct-io value.\n"; return 1; } }
+        else if (arg == "--bulk-threshold" && i + 1 < argc) { try { g_bulk_threshold = std::stoull(argv[++i]) << 20; } catch (...) { std::cerr << "Invalid --bulk-threshold value.\n"; return 1; } }
+    }
+
+    g_outbound.configure(limit_rate, limit_rate_ip);
+    g_inbound.configure(limit_upload, 0);
+
+#ifdef ARTWEB_IO_URING
+    const bool uring_usable = g_io_engine == IoEngine::Uring && io_uring_usable();
+#else
+    const bool uring_usable = false;
+#endif
+    if (g_io_engine == IoEngine::Uring && !uring_usable) {
+#ifdef _WIN32
+        std::wcerr << L"Warning: io_uring is not available here, using blocking file I/O." << std::endl;
+#else
+        std::cerr << "Warning: io_uring is not available here, using blocking file I/O." << std::endl;
+#endif
+        g_io_engine = IoEngine::Sync;
+    }
+
+    if (!mime_types_path.empty() && !load_mime_overlay(mime_types_path)) {
+#ifdef _WIN32
+        std::wcerr << L"Error: Cannot read MIME types file " << utf8_to_wstring(mime_types_path) << std::endl;
+#else
+        std::cerr << "Error: Cannot read MIME types file " << mime_types_path << std::endl;
+#endif
+        return 1;
+    }
+
+    if (!dedup_path.empty() && !g_dedup.open(fs::u8path(dedup_path))) {
+#ifdef _WIN32
+        std::wcerr << L"Error: Cannot create dedup store " << utf8_to_wstring(dedup_path) << std::endl;
+#else
+        std::cerr << "Error: Cannot create dedup store " << dedup_path << std::endl;
+#endif
+        return 1;
+    }
+
+    if (!line_index_path.empty()) {
+        std::error_code ec;
+        g_line_index.dir = fs::u8path(line_index_path);
+        fs::create_directories(g_line_index.dir, ec);
+        if (!fs::is_directory(g_line_index.dir, ec)) {
+#ifdef _WIN32
+            std::wcerr << L"Error: Cannot create line index directory " << utf8_to_wstring(line_index_path) << std::endl;
+#else
+            std::cerr << "Error: Cannot create line index directory " << line_index_path << std::endl;
+#endif
+            return 1;
+        }
+    }
+
+    g_metrics_enabled = !g_metrics_path.empty() || g_metrics_port != 0;
+    if (!g_metrics_path.empty() && g_metrics_path[0] != '/') g_metrics_path = "/" + g_metrics_path;
+
+#ifndef ARTWEB_EMBED
+    if (g_embedded_mode) {
+        std::cerr << "Error: --embedded requires a build with ARTWEB_EMBED (see --embed-gen).\n";
+        return 1;
     }
+#endif
 
     print_logo();
     print_ipv4_list_after_logo();
 
+    if (!g_bundle_path.empty()) {
+        std::string error;
+        if (!load_bundle(g_bundle_path, g_bundle, error)) {
+#ifdef _WIN32
+            std::wcerr << L"Error: Cannot load bundle " << utf8_to_wstring(g_bundle_path) << L": " << utf8_to_wstring(error) << std::endl;
+#else
+            std::cerr << "Error: Cannot load bundle " << g_bundle_path << ": " << error << std::endl;
+#endif
+            return 1;
+        }
+    }
+
     if (!g_web_root_path.empty()) {
         if (!fs::exists(g_web_root_path)) {
 #ifdef _WIN32
@@ -1199,6 +9625,25 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
+    // Open the served root once; request paths are resolved relative to it.
+    if (!open_root(g_root, g_web_root_path.empty() ? fs::current_path() : fs::u8path(g_web_root_path))) {
+#ifdef _WIN32
+        std::wcerr << L"Error: Could not open the served directory." << std::endl;
+#else
+        std::cerr << "Error: Could not open the served directory." << std::endl;
+#endif
+        return 1;
+    }
+    if (g_tree_index_enabled) {
+#ifdef __linux__
+        g_tree_index.start(g_root.canonical);
+#elif defined(_WIN32)
+        std::wcerr << L"Warning: --tree-index needs inotify (Linux); listings read the disk." << std::endl;
+#else
+        std::cerr << "Warning: --tree-index needs inotify (Linux); listings read the disk." << std::endl;
+#endif
+    }
+
     if (require_auth) {
         g_expected_auth_header = "Basic " + base64_encode("admin:" + auth_password);
     }
@@ -1227,27 +9672,39 @@ int main(int argc, char* argv[]) {
         svr->set_payload_max_length(MAX_UPLOAD_SIZE);
     }
 
-    if (!g_web_root_path.empty()) {
-        svr->Get(R"(/(.*))", serve_static_content_handler);
-    }
-    else {
-        svr->Get(R"(/(.*))", browse_handler);
-        svr->Post("/upload", upload_handler);
-    }
-
-    // Catch-all POST handler (MUST be registered after real POST routes)
-    // Ensures body parsing & logging even for unknown POST endpoints (404).
-    svr->Post(R"(/(.*))", [](const httplib::Request& req, httplib::Response& res) {
-        // Respect authentication if enabled
-        if (require_auth) {
-            if (!authenticate(req, res)) return; // sends 401
+    configure_server(*svr);
+    register_routes(*svr);
+
+    // Optional dedicated metrics listener, so scrapes never queue behind transfers.
+    // It speaks the same protocol as the main server, and is stopped and joined
+    // before main returns so its thread never outlives it.
+    struct MetricsListener {
+        std::unique_ptr<httplib::Server> svr;
+        std::thread thread;
+        ~MetricsListener() {
+            if (!thread.joinable()) return;
+            svr->stop();
+            thread.join();
         }
-        res.status = 404;
-        res.set_content("Not Found", "text/plain");
-        });
+    } metrics;
+    if (g_metrics_port) {
+        if (use_ssl) metrics.svr = std::make_unique<httplib::SSLServer>(cert_path.c_str(), key_path.c_str());
+        else metrics.svr = std::make_unique<httplib::Server>();
+        metrics.svr->Get(g_metrics_path.empty() ? "/metrics" : g_metrics_path, metrics_handler);
+        if (!metrics.svr->bind_to_port("0.0.0.0", g_metrics_port)) {
+#ifdef _WIN32
+            std::wcerr << L"Error: Cannot listen on metrics port " << g_metrics_port << std::endl;
+#else
+            std::cerr << "Error: Cannot listen on metrics port " << g_metrics_port << std::endl;
+#endif
+            return 1;
+        }
+        metrics.thread = std::thread([server = metrics.svr.get()]() { server->listen_after_bind(); });
+    }
 
 #ifdef _WIN32
     svr->set_logger([](const httplib::Request& req, const httplib::Response& res) {
+        request_finished(req, res);
         std::time_t t = std::time(nullptr);
         std::tm tm;
         localtime_s(&tm, &t);
@@ -1281,6 +9738,7 @@ int main(int argc, char* argv[]) {
         });
 #else
     svr->set_logger([](const httplib::Request& req, const httplib::Response& res) {
+        request_finished(req, res);
         std::time_t t = std::time(nullptr);
         std::tm tm;
         localtime_r(&t, &tm);
@@ -1313,7 +9771,13 @@ int main(int argc, char* argv[]) {
 #ifdef _WIN32
     std::wcout << L"Starting " << (use_ssl ? L"HTTPS" : L"HTTP")
         << L" server on port " << port << L"\n";
-    if (!g_web_root_path.empty()) {
+    if (!g_bundle_path.empty()) {
+        std::wcout << L"Serving " << g_bundle.header->entry_count << L" files from bundle: " << utf8_to_wstring(g_bundle_path) << L"\n";
+    }
+    else if (g_embedded_mode) {
+        std::wcout << L"Serving the embedded site compiled into this binary.\n";
+    }
+    else if (!g_web_root_path.empty()) {
         std::wcout << L"Serving static files from web root: " << utf8_to_wstring(g_web_root_path) << L"\n";
     }
     else {
@@ -1322,7 +9786,13 @@ int main(int argc, char* argv[]) {
 #else
     std::cout << "Starting " << (use_ssl ? "HTTPS" : "HTTP")
         << " server on port " << port << "\n";
-    if (!g_web_root_path.empty()) {
+    if (!g_bundle_path.empty()) {
+        std::cout << "Serving " << g_bundle.header->entry_count << " files from bundle: " << g_bundle_path << "\n";
+    }
+    else if (g_embedded_mode) {
+        std::cout << "Serving the embedded site compiled into this binary.\n";
+    }
+    else if (!g_web_root_path.empty()) {
         std::cout << "Serving static files from web root: " << g_web_root_path << "\n";
     }
     else {
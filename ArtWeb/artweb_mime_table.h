@@ -0,0 +1,1943 @@
+// Generated by ArtWeb --mime-gen from mime.types. Do not edit.
+// 1519 extensions; see mime_table_lookup() in ArtWeb.cpp.
+#pragma once
+
+constexpr std::size_t MIME_BUCKET_COUNT = 506;
+constexpr std::size_t MIME_SLOT_COUNT = 1899;
+
+constexpr std::uint16_t g_mime_displacement[MIME_BUCKET_COUNT] = {
+    9, 8, 4, 3, 9, 7, 1, 5, 3, 1, 8, 14, 6, 2, 8, 1,
+    7, 9, 1, 2, 2, 1, 5, 3, 1, 0, 10, 16, 4, 0, 3, 4,
+    5, 4, 1, 1, 4, 2, 11, 1, 1, 1, 1, 9, 2, 9, 0, 1,
+    1, 7, 9, 3, 3, 2, 7, 2, 0, 0, 1, 8, 0, 6, 2, 11,
+    6, 9, 9, 13, 6, 1, 2, 7, 2, 1, 3, 3, 6, 1, 17, 7,
+    1, 3, 1, 10, 5, 1, 29, 12, 5, 2, 7, 2, 34, 3, 11, 7,
+    6, 1, 2, 1, 1, 21, 8, 4, 2, 5, 1, 10, 2, 5, 1, 3,
+    6, 1, 5, 3, 15, 4, 23, 4, 1, 4, 3, 15, 25, 10, 11, 0,
+    2, 3, 3, 5, 12, 9, 1, 18, 1, 11, 3, 6, 3, 2, 3, 3,
+    0, 5, 2, 3, 3, 1, 2, 2, 3, 9, 29, 1, 2, 1, 2, 18,
+    1, 7, 7, 17, 6, 16, 4, 2, 1, 6, 1, 3, 1, 4, 6, 1,
+    7, 6, 3, 2, 9, 0, 2, 4, 2, 9, 28, 1, 13, 1, 1, 2,
+    1, 22, 3, 1, 22, 0, 2, 0, 1, 2, 6, 4, 3, 2, 1, 1,
+    14, 3, 5, 4, 1, 2, 1, 2, 1, 2, 10, 3, 1, 3, 3, 6,
+    1, 3, 12, 6, 1, 1, 4, 2, 0, 2, 1, 3, 2, 1, 15, 3,
+    8, 1, 4, 11, 0, 6, 2, 2, 4, 5, 18, 3, 10, 8, 2, 3,
+    8, 3, 16, 0, 8, 1, 8, 2, 20, 4, 14, 3, 0, 2, 4, 6,
+    25, 22, 3, 1, 16, 35, 9, 2, 1, 1, 1, 10, 4, 2, 8, 11,
+    25, 0, 14, 23, 17, 1, 3, 1, 2, 1, 18, 12, 6, 11, 1, 16,
+    4, 1, 6, 1, 7, 8, 48, 6, 2, 26, 15, 31, 10, 14, 24, 1,
+    1, 3, 1, 2, 5, 1, 25, 26, 1, 7, 1, 9, 3, 8, 2, 6,
+    1, 2, 3, 11, 5, 12, 1, 6, 6, 1, 2, 1, 3, 5, 1, 8,
+    6, 12, 1, 13, 8, 9, 1, 10, 2, 5, 2, 1, 3, 5, 6, 1,
+    8, 3, 13, 3, 7, 7, 2, 24, 13, 5, 1, 10, 2, 6, 9, 3,
+    3, 7, 8, 1, 2, 6, 3, 27, 1, 26, 1, 1, 3, 28, 14, 1,
+    2, 15, 5, 11, 6, 4, 4, 2, 2, 1, 3, 5, 4, 2, 1, 17,
+    1, 7, 8, 21, 1, 6, 8, 1, 3, 4, 12, 28, 15, 69, 26, 5,
+    21, 24, 18, 2, 32, 7, 26, 19, 5, 1, 0, 12, 36, 2, 5, 2,
+    8, 6, 0, 2, 2, 4, 6, 6, 4, 1, 2, 5, 8, 8, 7, 4,
+    23, 2, 1, 15, 1, 8, 9, 18, 14, 9, 29, 7, 6, 0, 26, 4,
+    16, 18, 15, 2, 29, 10, 6, 2, 2, 27, 7, 12, 11, 25, 12, 32,
+    47, 28, 2, 19, 20, 1, 6, 12, 1, 22,
+};
+
+constexpr MimeEntry g_mime_slots[MIME_SLOT_COUNT] = {
+    { "zfo", "application/vnd.software602.filler.form-xml-zip" },
+    { "bar", "application/vnd.qualcomm.brew-app-res" },
+    { "eps", "application/postscript" },
+    { "wgsl", "text/wgsl; charset=utf-8" },
+    {},
+    { "rif", "application/reginfo+xml" },
+    { "c", "text/x-csrc; charset=utf-8" },
+    {},
+    { "ttl", "text/turtle; charset=utf-8" },
+    { "wif", "application/watcherinfo+xml" },
+    { "dpx", "image/dpx" },
+    { "old", "application/x-trash" },
+    {},
+    { "cwl", "application/cwl" },
+    { "xmt_bin", "model/vnd.parasolid.transmit.binary" },
+    { "ecelp4800", "audio/vnd.nuera.ecelp4800" },
+    { "udeb", "application/vnd.debian.binary-package" },
+    {},
+    {},
+    { "gtar", "application/x-gtar" },
+    {},
+    {},
+    { "java", "text/x-java; charset=utf-8" },
+    { "ic7", "application/vnd.commerce-battelle" },
+    { "rlc", "image/vnd.fujixerox.edmics-rlc" },
+    { "rxt", "application/vnd.medicalholodeck.recordxr" },
+    { "koz", "audio/vnd.audiokoz" },
+    { "cla", "application/vnd.claymore" },
+    { "boo", "text/x-boo; charset=utf-8" },
+    { "imgcal", "application/vnd.3lightssoftware.imagescal" },
+    { "lhzl", "application/vnd.belightsoft.lhzl+zip" },
+    { "sfs", "application/vnd.spotfire.sfs" },
+    { "ent", "application/xml-external-parsed-entity" },
+    { "xpm", "image/x-xpixmap" },
+    { "m4a", "audio/mp4" },
+    {},
+    { "emf", "image/emf" },
+    { "book", "application/x-maker" },
+    { "rnd", "application/prs.nprend" },
+    { "box", "application/vnd.previewsystems.box" },
+    { "mpm", "application/vnd.blueice.multipass" },
+    { "pfb", "application/x-font" },
+    { "lasjson", "application/vnd.las.las+json" },
+    { "alc", "chemical/x-alchemy" },
+    { "m3g", "application/m3g" },
+    { "heif", "image/heif" },
+    { "i2g", "application/vnd.intergeo" },
+    { "jsontm", "application/tm+json" },
+    { "gre", "application/vnd.geometry-explorer" },
+    { "vtt", "text/vtt; charset=utf-8" },
+    {},
+    {},
+    {},
+    { "csv", "text/csv; charset=utf-8" },
+    { "prf", "application/pics-rules" },
+    {},
+    { "dii", "application/dii" },
+    { "mvb", "chemical/x-mopac-vib" },
+    {},
+    { "scsf", "application/vnd.sealed.csf" },
+    { "pfx", "application/pkcs12" },
+    { "g3w", "application/vnd.geospace" },
+    { "asf", "application/vnd.ms-asf" },
+    { "smil", "application/smil+xml" },
+    { "dtshd", "audio/vnd.dts.hd" },
+    { "fcs", "application/vnd.isac.fcs" },
+    { "c9r", "application/vnd.cryptomator.encrypted" },
+    { "bpd", "application/vnd.hbci" },
+    { "paw", "application/vnd.pawaafile" },
+    { "frm", "application/vnd.ufdl" },
+    { "emma", "application/emma+xml" },
+    {},
+    { "dvc", "application/dvcs" },
+    { "nnd", "application/vnd.noblenet-directory" },
+    {},
+    { "les", "application/vnd.hhe.lesson-player" },
+    { "odx", "application/odx" },
+    { "ltx", "text/x-tex; charset=utf-8" },
+    { "jdx", "chemical/x-jcamp-dx" },
+    { "cww", "application/prs.cww" },
+    { "rct", "application/prs.nprend" },
+    { "xav", "application/xcap-att+xml" },
+    { "senmle", "application/senml-exi" },
+    { "cmsc", "application/cms" },
+    { "hpi", "application/vnd.hp-hpid" },
+    { "bib", "text/x-bibtex; charset=utf-8" },
+    { "vxml", "application/voicexml+xml" },
+    { "mj2", "video/mj2" },
+    { "acutc", "application/vnd.acucorp" },
+    { "ktx2", "image/ktx2" },
+    {},
+    { "uvvm", "video/vnd.dece.mobile" },
+    { "atf", "application/atf" },
+    { "eclass", "application/vnd.gentoo.eclass" },
+    { "ftc", "application/vnd.fluxtime.clip" },
+    { "mrc", "application/marc" },
+    {},
+    { "ghf", "application/vnd.groove-help" },
+    {},
+    { "geo", "application/vnd.dynageo" },
+    { "pcf", "application/x-font-pcf" },
+    { "prc", "model/prc" },
+    { "fly", "text/vnd.fly; charset=utf-8" },
+    { "oprc", "application/vnd.palm" },
+    {},
+    { "nef", "image/x-nikon-nef" },
+    { "nwc", "application/x-nwc" },
+    {},
+    { "uvx", "application/vnd.dece.unspecified" },
+    { "emm", "application/vnd.ibm.electronic-media" },
+    { "rpss", "application/vnd.nokia.radio-presets" },
+    {},
+    {},
+    { "flv", "video/x-flv" },
+    { "b16", "image/vnd.pco.b16" },
+    { "xo", "application/vnd.olpc-sugar" },
+    { "wbs", "application/vnd.criticaltools.wbs+xml" },
+    {},
+    { "fst", "image/vnd.fst" },
+    { "mpga", "audio/mpeg" },
+    { "mov", "video/quicktime" },
+    { "atx", "audio/atrac-x" },
+    { "dis", "application/vnd.mobius.dis" },
+    {},
+    { "pyc", "application/x-python-code" },
+    {},
+    {},
+    { "mhas", "audio/mhas" },
+    { "ez", "application/andrew-inset" },
+    { "rusd", "application/route-usd+xml" },
+    { "s1j", "image/vnd.sealedmedia.softseal.jpg" },
+    { "qvd", "application/vnd.theqvd" },
+    { "lmp", "model/vnd.gdl" },
+    { "bmml", "application/vnd.balsamiq.bmml+xml" },
+    {},
+    { "edx", "application/vnd.novadigm.edx" },
+    {},
+    {},
+    { "p2p", "application/vnd.wfa.p2p" },
+    { "gram", "application/srgs" },
+    { "fm", "application/vnd.framemaker" },
+    { "vtf", "image/vnd.valve.source.texture" },
+    { "rfcxml", "application/rfc+xml" },
+    { "xhe", "audio/usac" },
+    { "ms", "application/x-troff-ms" },
+    { "sit", "application/x-stuffit" },
+    { "mif", "application/vnd.mif" },
+    { "step", "model/step" },
+    {},
+    { "slc", "application/vnd.wap.slc" },
+    { "p7s", "application/pkcs7-signature" },
+    { "wm", "video/x-ms-wm" },
+    { "sv4crc", "application/x-sv4crc" },
+    { "ras", "image/x-cmu-raster" },
+    { "pkg", "application/vnd.apple.installer+xml" },
+    {},
+    { "csvs", "text/csv-schema; charset=utf-8" },
+    { "jmz", "application/x-jmol" },
+    { "atomsrv", "application/atomserv+xml" },
+    {},
+    { "mpdd", "application/dashdelta" },
+    { "cpp", "text/x-c++src; charset=utf-8" },
+    { "keynote", "application/vnd.apple.keynote" },
+    { "avci", "image/avci" },
+    { "pdx", "application/pdx" },
+    { "sti", "application/vnd.sun.xml.impress.template" },
+    { "sdc", "application/vnd.stardivision.calc" },
+    { "jpeg", "image/jpeg" },
+    { "x3d", "model/x3d+xml" },
+    { "tatx", "application/vnd.onepagertatx" },
+    { "xdp", "application/vnd.adobe.xdp+xml" },
+    { "jxr", "image/jxr" },
+    { "hgl", "text/vnd.hgl; charset=utf-8" },
+    { "dcd", "application/dcd" },
+    { "jad", "text/vnd.sun.j2me.app-descriptor; charset=utf-8" },
+    { "csh", "application/x-csh" },
+    { "mft", "application/rpki-manifest" },
+    {},
+    { "plc", "application/vnd.mobius.plc" },
+    {},
+    {},
+    {},
+    { "kom", "application/vnd.hbci" },
+    { "smc", "application/vnd.nintendo.snes.rom" },
+    { "mcm", "chemical/x-macmolecule" },
+    {},
+    { "stk", "application/hyperstudio" },
+    {},
+    { "oeb", "application/vnd.openeye.oeb" },
+    {},
+    { "jxs", "image/jxs" },
+    { "ovl", "application/vnd.afpc.modca-overlay" },
+    { "cdr", "image/x-coreldraw" },
+    {},
+    {},
+    { "nebul", "application/vnd.nebumind.line" },
+    { "tsp", "application/dsptype" },
+    {},
+    { "ksp", "application/vnd.kde.kspread" },
+    {},
+    { "tex", "text/x-tex; charset=utf-8" },
+    {},
+    { "wadl", "application/vnd.sun.wadl+xml" },
+    { "cod", "application/vnd.rim.cod" },
+    {},
+    { "cap", "application/vnd.tcpdump.pcap" },
+    {},
+    { "wgt", "application/widget" },
+    { "sar", "application/vnd.sar" },
+    { "msa", "application/vnd.msa-disk-image" },
+    { "pgp", "application/pgp-encrypted" },
+    { "nq", "application/n-quads" },
+    { "aif", "audio/x-aiff" },
+    {},
+    { "pwn", "application/vnd.3m.post-it-notes" },
+    { "fli", "video/fli" },
+    { "imf", "application/vnd.imagemeter.folder+zip" },
+    {},
+    {},
+    { "wrl", "model/vrml" },
+    { "edm", "application/vnd.novadigm.edm" },
+    { "spng", "image/vnd.sealed.png" },
+    { "smov", "video/vnd.sealedmedia.softseal.mov" },
+    { "pti", "image/prs.pti" },
+    { "ma", "application/mathematica" },
+    { "scim", "application/scim+json" },
+    { "see", "application/vnd.seemail" },
+    { "rld", "application/resource-lists-diff+xml" },
+    { "copyright", "text/vnd.debian.copyright; charset=utf-8" },
+    { "ogex", "model/vnd.opengex" },
+    { "plj", "audio/vnd.everad.plj" },
+    { "tif", "image/tiff" },
+    { "rip", "audio/vnd.rip" },
+    { "sldx", "application/vnd.openxmlformats-officedocument.presentationml.slide" },
+    { "xlam", "application/vnd.ms-excel.addin.macroenabled.12" },
+    { "asc", "application/pgp-keys" },
+    { "sci", "application/x-scilab" },
+    { "xpw", "application/vnd.intercon.formnet" },
+    { "epsi", "application/postscript" },
+    { "pcx", "image/vnd.zbrush.pcx" },
+    { "onetmp", "application/onenote" },
+    {},
+    { "moml", "model/vnd.moml+xml" },
+    {},
+    {},
+    { "m3u8", "application/vnd.apple.mpegurl" },
+    { "wmlc", "application/vnd.wap.wmlc" },
+    { "cml", "application/cellml+xml" },
+    { "jxss", "image/jxss" },
+    { "atomsvc", "application/atomsvc+xml" },
+    { "dim", "application/vnd.fastcopy-disk-image" },
+    { "skm", "application/vnd.koan" },
+    {},
+    { "uvh", "video/vnd.dece.hd" },
+    { "tnf", "application/vnd.ms-tnef" },
+    {},
+    { "msp", "application/octet-stream" },
+    {},
+    {},
+    {},
+    { "irp", "application/vnd.irepository.package+xml" },
+    {},
+    { "tiff", "image/tiff" },
+    { "p7r", "application/x-pkcs7-certreqresp" },
+    { "sieve", "application/sieve" },
+    { "wbxml", "application/vnd.wap.wbxml" },
+    { "spp", "application/scvp-vp-response" },
+    { "uvs", "video/vnd.dece.sd" },
+    { "ram", "audio/x-pn-realaudio" },
+    { "tap", "image/vnd.tencent.tap" },
+    { "aa3", "audio/atrac3" },
+    { "htm", "text/html; charset=utf-8" },
+    {},
+    { "pfr", "application/font-tdpfr" },
+    { "osf", "application/vnd.yamaha.openscoreformat" },
+    { "webp", "image/webp" },
+    { "atomdeleted", "application/atomdeleted+xml" },
+    {},
+    { "pages", "application/vnd.apple.pages" },
+    { "gcd", "text/x-pcs-gcd; charset=utf-8" },
+    { "ots", "application/vnd.oasis.opendocument.spreadsheet-template" },
+    { "gtw", "model/vnd.gtw" },
+    { "heic", "image/heic" },
+    { "crtr", "application/vnd.multiad.creator" },
+    { "mtl", "model/mtl" },
+    { "x3dvz", "model/x3d-vrml" },
+    {},
+    {},
+    {},
+    { "swidtag", "application/swid+xml" },
+    {},
+    {},
+    { "rar", "application/vnd.rar" },
+    { "sql", "application/sql" },
+    { "uva", "audio/vnd.dece.audio" },
+    { "ssf", "application/vnd.epson.ssf" },
+    { "yang", "application/yang" },
+    { "hpub", "application/prs.hpub+zip" },
+    { "uo", "application/vnd.uoml+xml" },
+    { "dms", "text/vnd.dmclientscript; charset=utf-8" },
+    { "ei6", "application/vnd.pg.osasli" },
+    {},
+    { "wpl", "application/vnd.ms-wpl" },
+    {},
+    {},
+    {},
+    { "usda", "model/vnd.usda" },
+    {},
+    {},
+    { "css", "text/css; charset=utf-8" },
+    { "jpe", "image/jpeg" },
+    {},
+    {},
+    { "srx", "application/sparql-results+xml" },
+    { "senml-etchc", "application/senml-etch+cbor" },
+    {},
+    { "sdo", "application/vnd.sealed.doc" },
+    { "sgi", "image/vnd.sealedmedia.softseal.gif" },
+    { "rd", "chemical/x-mdl-rdfile" },
+    { "ssml", "application/ssml+xml" },
+    {},
+    {},
+    { "apxml", "application/auth-policy+xml" },
+    { "mng", "video/x-mng" },
+    { "mopcrt", "chemical/x-mopac-input" },
+    {},
+    { "vrm", "model/vrml" },
+    { "enw", "audio/evrcnw" },
+    { "djvu", "image/vnd.djvu" },
+    { "jpf", "image/jpx" },
+    { "webmanifest", "application/manifest+json" },
+    { "bkm", "application/vnd.nervana" },
+    { "vtu", "model/vnd.vtu" },
+    { "gsf", "application/x-font" },
+    { "vew", "application/vnd.lotus-approach" },
+    { "dae", "model/vnd.collada+xml" },
+    { "sis", "application/vnd.symbian.install" },
+    { "m1v", "video/mpeg" },
+    {},
+    { "stf", "application/vnd.wt.stf" },
+    { "hvd", "application/vnd.yamaha.hv-dic" },
+    { "icf", "application/vnd.commerce-battelle" },
+    { "ccc", "text/vnd.net2phone.commcenter.command; charset=utf-8" },
+    { "fzs", "application/vnd.fuzzysheet" },
+    { "bmp", "image/bmp" },
+    { "hqx", "application/mac-binhex40" },
+    { "dit", "application/dit" },
+    {},
+    { "loom", "application/vnd.loom" },
+    { "u3d", "model/u3d" },
+    { "wsdl", "application/wsdl+xml" },
+    { "wmls", "text/vnd.wap.wmlscript; charset=utf-8" },
+    { "prz", "application/vnd.lotus-freelance" },
+    { "texinfo", "application/x-texinfo" },
+    { "x3dz", "model/x3d+xml" },
+    { "hal", "application/vnd.hal+xml" },
+    { "senml", "application/senml+json" },
+    { "avcs", "image/avcs" },
+    { "xls", "application/vnd.ms-excel" },
+    { "relo", "application/p2p-overlay+xml" },
+    { "ign", "application/vnd.coreos.ignition+json" },
+    { "saf", "application/vnd.yamaha.smaf-audio" },
+    { "sensmle", "application/sensml-exi" },
+    { "str", "application/vnd.pg.format" },
+    { "ptrom", "application/vnd.snesdev-page-table" },
+    { "mkv", "video/x-matroska" },
+    { "wlnk", "application/link-format" },
+    { "svgz", "image/svg+xml" },
+    { "study-inter", "application/vnd.vd-study" },
+    { "tpt", "application/vnd.trid.tpt" },
+    { "uoml", "application/vnd.uoml+xml" },
+    { "ttf", "font/ttf" },
+    { "3mf", "application/vnd.ms-3mfdocument" },
+    { "bin", "application/octet-stream" },
+    { "fbs", "image/vnd.fastbidsheet" },
+    { "mts", "model/vnd.mts" },
+    { "mods", "application/mods+xml" },
+    { "sgif", "image/vnd.sealedmedia.softseal.gif" },
+    { "mf4", "application/mf4" },
+    { "sda", "application/vnd.stardivision.draw" },
+    { "mfm", "application/vnd.mfmp" },
+    { "exr", "image/aces" },
+    { "g2w", "application/vnd.geoplan" },
+    { "qps", "application/vnd.publishare-delta-tree" },
+    { "ami", "application/vnd.amiga.ami" },
+    {},
+    { "fch", "chemical/x-gaussian-checkpoint" },
+    { "igl", "application/vnd.igloader" },
+    {},
+    { "carjson", "application/vnd.eu.kasparian.car+json" },
+    { "cpio", "application/x-cpio" },
+    { "shc", "text/shaclc; charset=utf-8" },
+    { "glbuf", "application/gltf-buffer" },
+    { "jam", "application/vnd.jam" },
+    { "svg", "image/svg+xml" },
+    { "qfx", "application/vnd.intu.qfx" },
+    { "moo", "chemical/x-mopac-out" },
+    { "woff", "font/woff" },
+    {},
+    { "fpx", "image/vnd.fpx" },
+    { "tgf", "chemical/x-mdl-tgf" },
+    { "tsd", "application/timestamped-data" },
+    { "fts", "image/fits" },
+    { "rcprofile", "application/vnd.ipunplugged.rcprofile" },
+    { "mus", "application/vnd.musician" },
+    { "rdf-crypt", "application/prs.rdf-xml-crypt" },
+    { "sty", "text/x-tex; charset=utf-8" },
+    { "kil", "application/x-killustrator" },
+    {},
+    { "arrow", "application/vnd.apache.arrow.file" },
+    {},
+    { "jxsi", "image/jxsi" },
+    { "py", "text/x-python; charset=utf-8" },
+    { "scr", "application/x-silverlight" },
+    { "gcf", "application/x-graphing-calculator" },
+    { "csf", "chemical/x-cache-csf" },
+    { "sac", "application/tamp-sequence-adjust-confirm" },
+    { "otp", "application/vnd.oasis.opendocument.presentation-template" },
+    { "cu", "application/cu-seeme" },
+    { "tuc", "application/tamp-update-confirm" },
+    { "eot", "application/vnd.ms-fontobject" },
+    { "gex", "application/vnd.geometry-explorer" },
+    { "ddeb", "application/vnd.debian.binary-package" },
+    { "oth", "application/vnd.oasis.opendocument.text-web" },
+    { "tsq", "application/timestamp-query" },
+    { "apr", "application/vnd.lotus-approach" },
+    { "bk2", "video/vnd.radgamettools.bink" },
+    { "meta4", "application/metalink4+xml" },
+    {},
+    { "xdd", "application/bacnet-xdd+zip" },
+    { "ts", "text/vnd.trolltech.linguist; charset=utf-8" },
+    { "mmf", "application/vnd.smaf" },
+    { "rsat", "application/atsc-rsat+xml" },
+    { "gsm", "audio/x-gsm" },
+    {},
+    { "sxl", "application/vnd.sealed.xls" },
+    { "awb", "audio/amr-wb" },
+    { "shx", "application/vnd.shx" },
+    {},
+    { "vbk", "audio/vnd.nortel.vbk" },
+    { "vbox", "application/vnd.previewsystems.box" },
+    { "pkipath", "application/pkix-pkipath" },
+    { "brf", "text/plain; charset=utf-8" },
+    { "cat", "application/vnd.ms-pki.seccat" },
+    { "pyv", "video/vnd.ms-playready.media.pyv" },
+    { "wbmp", "image/vnd.wap.wbmp" },
+    {},
+    { "imi", "application/vnd.imagemeter.image+zip" },
+    { "rpm", "application/x-redhat-package-manager" },
+    {},
+    { "me", "application/x-troff-me" },
+    { "rdp", "application/x-rdp" },
+    { "csp", "application/vnd.commonspace" },
+    { "sds", "application/vnd.stardivision.chart" },
+    { "uvvf", "application/vnd.dece.data" },
+    { "spdf", "application/vnd.sealedmedia.softseal.pdf" },
+    { "jpg", "image/jpeg" },
+    {},
+    {},
+    { "tam", "application/vnd.onepager" },
+    { "td", "application/urc-targetdesc+xml" },
+    { "ccmp", "application/ccmp+xml" },
+    {},
+    { "pskcxml", "application/pskc+xml" },
+    { "stl", "model/stl" },
+    { "lsx", "video/x-la-asf" },
+    {},
+    { "shaclc", "text/shaclc; charset=utf-8" },
+    { "gph", "application/vnd.flographit" },
+    { "sd", "chemical/x-mdl-sdfile" },
+    { "cbin", "chemical/x-cactvs-binary" },
+    { "mmr", "image/vnd.fujixerox.edmics-mmr" },
+    { "provx", "application/provenance+xml" },
+    {},
+    { "sxc", "application/vnd.sun.xml.calc" },
+    { "aifc", "audio/x-aiff" },
+    {},
+    {},
+    { "cdx", "chemical/x-cdx" },
+    {},
+    {},
+    {},
+    { "otg", "application/vnd.oasis.opendocument.graphics-template" },
+    { "ppd", "application/vnd.cups-ppd" },
+    {},
+    { "xlsb", "application/vnd.ms-excel.sheet.binary.macroenabled.12" },
+    { "dx", "chemical/x-jcamp-dx" },
+    { "json", "application/json; charset=utf-8" },
+    { "dcr", "application/x-director" },
+    { "png", "image/png" },
+    { "h", "text/x-chdr; charset=utf-8" },
+    { "htke", "application/vnd.kenameaapp" },
+    { "ic8", "application/vnd.commerce-battelle" },
+    { "esf", "application/vnd.epson.esf" },
+    { "line", "application/vnd.nebumind.line" },
+    { "mpf", "text/vnd.ms-mediapackage; charset=utf-8" },
+    { "doc", "application/msword" },
+    { "uvvg", "image/vnd.dece.graphic" },
+    { "vsd", "application/vnd.visio" },
+    { "hpp", "text/x-c++hdr; charset=utf-8" },
+    { "gqf", "application/vnd.grafeq" },
+    { "qam", "application/vnd.epson.quickanime" },
+    {},
+    { "psd", "image/vnd.adobe.photoshop" },
+    { "c9s", "application/vnd.cryptomator.encrypted" },
+    { "uvvh", "video/vnd.dece.hd" },
+    {},
+    { "s1h", "application/vnd.sealedmedia.softseal.html" },
+    { "xlt", "application/vnd.ms-excel" },
+    {},
+    { "btf", "image/prs.btif" },
+    {},
+    {},
+    { "istr", "chemical/x-isostar" },
+    { "viaframe", "application/vnd.tml" },
+    {},
+    { "stpnc", "application/p21" },
+    { "sxm", "application/vnd.sun.xml.math" },
+    {},
+    {},
+    { "tfx", "image/tiff-fx" },
+    {},
+    {},
+    { "vwx", "application/vnd.vectorworks" },
+    { "clkx", "application/vnd.crick.clicker" },
+    { "xop", "application/xop+xml" },
+    { "gdl", "model/vnd.gdl" },
+    { "qxb", "application/vnd.quark.quarkxpress" },
+    {},
+    { "pgm", "image/x-portable-graymap" },
+    {},
+    {},
+    {},
+    { "msl", "application/vnd.mobius.msl" },
+    { "azf", "application/vnd.airzip.filesecure.azf" },
+    { "7z", "application/x-7z-compressed" },
+    { "pcl", "application/vnd.hp-pcl" },
+    { "dif", "video/dv" },
+    { "x_t", "model/vnd.parasolid.transmit.text" },
+    { "sml", "application/smil+xml" },
+    { "lzx", "application/x-lzx" },
+    { "sus", "application/vnd.sus-calendar" },
+    { "uvf", "application/vnd.dece.data" },
+    { "lostsyncxml", "application/lostsync+xml" },
+    { "lbd", "application/vnd.llamagraphics.life-balance.desktop" },
+    { "ic2", "application/vnd.commerce-battelle" },
+    {},
+    { "icm", "application/vnd.iccprofile" },
+    { "ser", "application/java-serialized-object" },
+    {},
+    { "sjpg", "image/vnd.sealedmedia.softseal.jpg" },
+    {},
+    { "svc", "application/vnd.dvb.service" },
+    { "cdkey", "application/vnd.mediastation.cdkey" },
+    { "dwf", "model/vnd.dwf" },
+    { "rsheet", "application/urc-ressheet+xml" },
+    { "xhtm", "application/xhtml+xml" },
+    {},
+    { "c4p", "application/vnd.clonk.c4group" },
+    { "ahead", "application/vnd.ahead.space" },
+    { "chm", "application/vnd.ms-htmlhelp" },
+    { "cdbcmsg", "application/vnd.contact.cmsg" },
+    {},
+    { "win", "model/vnd.gdl" },
+    { "wg", "application/vnd.pmi.widget" },
+    { "kml", "application/vnd.google-earth.kml+xml" },
+    { "dna", "application/vnd.dna" },
+    { "xott", "application/vnd.collabio.xodocuments.document-template" },
+    {},
+    { "xvm", "application/xv+xml" },
+    {},
+    { "deb", "application/vnd.debian.binary-package" },
+    { "xodt", "application/vnd.collabio.xodocuments.document" },
+    { "xmls", "application/dskpp+xml" },
+    { "pvb", "application/vnd.3gpp.pic-bw-var" },
+    {},
+    { "le", "application/vnd.bluetooth.le.oob" },
+    { "gac", "application/vnd.groove-account" },
+    { "kwt", "application/vnd.kde.kword" },
+    { "semd", "application/vnd.semd" },
+    { "spd", "application/vnd.sealedmedia.softseal.pdf" },
+    { "ppttc", "application/vnd.think-cell.ppttc+json" },
+    { "zaz", "application/vnd.zzazz.deck+xml" },
+    { "msu", "application/octet-stream" },
+    {},
+    {},
+    { "tnef", "application/vnd.ms-tnef" },
+    { "rapd", "application/route-apd+xml" },
+    {},
+    { "vst", "application/vnd.visio" },
+    { "xif", "image/vnd.xiff" },
+    { "gf", "application/x-tex-gf" },
+    { "xfdl", "application/vnd.xfdl" },
+    { "cpkg", "application/vnd.xmpie.cpkg" },
+    { "exp", "application/express" },
+    {},
+    { "silo", "model/mesh" },
+    { "gff3", "text/gff3; charset=utf-8" },
+    { "s14", "video/vnd.sealed.mpeg4" },
+    { "sru", "application/sru+xml" },
+    { "uvvi", "image/vnd.dece.graphic" },
+    { "sarif-external-properties", "application/sarif-external-properties+json" },
+    { "gpt", "chemical/x-mopac-graph" },
+    { "stp", "model/step" },
+    { "ddd", "application/vnd.fujixerox.ddd" },
+    {},
+    { "jpg2", "image/jp2" },
+    { "stc", "application/vnd.sun.xml.calc.template" },
+    { "heics", "image/heic-sequence" },
+    { "plp", "application/vnd.panoply" },
+    { "ott", "application/vnd.oasis.opendocument.text-template" },
+    { "mets", "application/mets+xml" },
+    { "uvvz", "application/vnd.dece.zip" },
+    {},
+    { "sqlite", "application/vnd.sqlite3" },
+    { "nsg", "application/vnd.lotus-notes" },
+    { "stix", "application/stix+json" },
+    { "movie", "video/x-sgi-movie" },
+    { "istc", "application/vnd.veryant.thin" },
+    {},
+    { "odm", "application/vnd.oasis.opendocument.text-master" },
+    { "hdr", "image/vnd.radiance" },
+    { "s11", "video/vnd.sealed.mpeg1" },
+    { "cgm", "image/cgm" },
+    { "vtnstd", "application/vnd.veritone.aion+json" },
+    { "jtd", "text/vnd.esmertec.theme-descriptor; charset=utf-8" },
+    { "apexlang", "application/vnd.apexlang" },
+    { "uvu", "video/vnd.dece.mp4" },
+    { "teicorpus", "application/tei+xml" },
+    { "1clr", "application/clr" },
+    { "cmdf", "chemical/x-cmdf" },
+    { "odp", "application/vnd.oasis.opendocument.presentation" },
+    { "dist", "application/vnd.apple.installer+xml" },
+    {},
+    { "vcx", "application/vnd.vcx" },
+    { "fits", "image/fits" },
+    { "sensmlx", "application/sensml+xml" },
+    { "mp4", "video/mp4" },
+    { "asics", "application/vnd.etsi.asic-s+zip" },
+    { "stpx", "model/step+xml" },
+    { "jisp", "application/vnd.jisp" },
+    { "btif", "image/prs.btif" },
+    { "s3df", "application/vnd.sealed.3df" },
+    { "wmlsc", "application/vnd.wap.wmlscriptc" },
+    { "ttc", "font/collection" },
+    { "uvvt", "application/vnd.dece.ttml+xml" },
+    { "evb", "audio/evrcb" },
+    { "vds", "model/vnd.sap.vds" },
+    { "lin", "application/bbolin" },
+    { "skt", "application/vnd.koan" },
+    {},
+    { "model-inter", "application/vnd.vd-study" },
+    { "latex", "application/x-latex" },
+    { "qwt", "application/vnd.quark.quarkxpress" },
+    { "tcu", "application/tamp-community-update" },
+    { "tra", "application/vnd.trueapp" },
+    { "dsm", "application/vnd.desmume.movie" },
+    { "jt", "model/jt" },
+    { "clue", "application/clue_info+xml" },
+    { "dir", "application/x-director" },
+    { "tsa", "application/tamp-sequence-adjust" },
+    { "xmt_txt", "model/vnd.parasolid.transmit.text" },
+    { "aion", "application/vnd.veritone.aion+json" },
+    { "sms", "application/vnd.3gpp2.sms" },
+    { "cil", "application/vnd.ms-artgalry" },
+    { "dart", "application/vnd.dart" },
+    {},
+    { "wmx", "video/x-ms-wmx" },
+    {},
+    { "ssvc", "application/vnd.crypto-shade-file" },
+    {},
+    { "c4g", "application/vnd.clonk.c4group" },
+    { "ecelp7470", "audio/vnd.nuera.ecelp7470" },
+    {},
+    { "teacher", "application/vnd.smart.teacher" },
+    { "ns3", "application/vnd.lotus-notes" },
+    { "mpg4", "video/mp4" },
+    { "json-patch", "application/json-patch+json" },
+    { "odi", "application/vnd.oasis.opendocument.image" },
+    { "fbdoc", "application/x-maker" },
+    { "sppt", "application/vnd.sealed.ppt" },
+    { "uvv", "video/vnd.dece.video" },
+    { "odg", "application/vnd.oasis.opendocument.graphics" },
+    { "mxl", "application/vnd.recordare.musicxml" },
+    { "ascii", "text/vnd.ascii-art; charset=utf-8" },
+    { "xyze", "image/vnd.radiance" },
+    { "spo", "text/vnd.in3d.spot; charset=utf-8" },
+    { "xps", "application/vnd.ms-xpsdocument" },
+    { "ac3", "audio/ac3" },
+    { "pot", "text/plain; charset=utf-8" },
+    {},
+    { "c11amz", "application/vnd.cluetrust.cartomobile-config-pkg" },
+    { "xdm", "application/vnd.syncml.dm+xml" },
+    { "soa", "text/dns; charset=utf-8" },
+    { "flb", "application/vnd.ficlab.flb+zip" },
+    { "sos", "text/vnd.sosi; charset=utf-8" },
+    { "tur", "application/tamp-update" },
+    {},
+    {},
+    { "xbd", "application/vnd.fujixerox.docuworks.binder" },
+    {},
+    {},
+    { "aml", "application/aml" },
+    { "adts", "audio/aac" },
+    { "ly", "text/x-lilypond; charset=utf-8" },
+    { "mbox", "application/mbox" },
+    { "lca", "application/vnd.logipipe.circuit+zip" },
+    { "dor", "model/vnd.gdl" },
+    { "diff", "text/x-diff; charset=utf-8" },
+    {},
+    { "eml", "message/rfc822" },
+    { "scd", "application/vnd.scribus" },
+    { "arrows", "application/vnd.apache.arrow.stream" },
+    { "jhc", "image/jphc" },
+    { "ivp", "application/vnd.immervision-ivp" },
+    { "epsf", "application/postscript" },
+    { "eps3", "application/postscript" },
+    { "glbin", "application/gltf-buffer" },
+    { "shex", "text/shex; charset=utf-8" },
+    { "dvi", "application/x-dvi" },
+    { "sqlite3", "application/vnd.sqlite3" },
+    { "o", "application/x-object" },
+    { "crt", "application/x-x509-ca-cert" },
+    { "shf", "application/shf+xml" },
+    {},
+    { "ustar", "application/x-ustar" },
+    { "shp", "application/vnd.shp" },
+    {},
+    { "urim", "application/vnd.uri-map" },
+    { "p", "text/x-pascal; charset=utf-8" },
+    { "roff", "text/troff; charset=utf-8" },
+    { "ppam", "application/vnd.ms-powerpoint.addin.macroenabled.12" },
+    {},
+    { "rnc", "application/relax-ng-compact-syntax" },
+    { "pseg3820", "application/vnd.afpc.modca" },
+    {},
+    { "jsonld", "application/ld+json" },
+    { "rep", "application/vnd.businessobjects" },
+    { "osm", "application/vnd.openstreetmap.data+xml" },
+    { "xodp", "application/vnd.collabio.xodocuments.presentation" },
+    {},
+    { "cr2", "image/x-canon-cr2" },
+    { "senmlc", "application/senml+cbor" },
+    {},
+    { "jxrs", "image/jxrs" },
+    { "x3dv", "model/x3d-vrml" },
+    { "ifm", "application/vnd.shana.informed.formdata" },
+    { "tat", "application/vnd.onepagertat" },
+    {},
+    {},
+    { "dxf", "image/vnd.dxf" },
+    {},
+    { "list3820", "application/vnd.afpc.modca" },
+    { "xltx", "application/vnd.openxmlformats-officedocument.spreadsheetml.template" },
+    { "ez3", "application/vnd.ezpix-package" },
+    { "flt", "text/vnd.ficlab.flt; charset=utf-8" },
+    { "twds", "application/vnd.simtech-mindmapper" },
+    { "ass", "audio/aac" },
+    { "ppt", "application/vnd.ms-powerpoint" },
+    { "oda", "application/oda" },
+    {},
+    { "xdw", "application/vnd.fujixerox.docuworks" },
+    { "sv4cpio", "application/x-sv4cpio" },
+    { "mpp", "application/vnd.ms-project" },
+    { "nimn", "application/vnd.nimn" },
+    { "csm", "chemical/x-csml" },
+    { "aiff", "audio/x-aiff" },
+    { "provn", "text/provenance-notation; charset=utf-8" },
+    { "urimap", "application/vnd.uri-map" },
+    { "cw", "application/prs.cww" },
+    { "ebuild", "application/vnd.gentoo.ebuild" },
+    { "xpr", "application/vnd.is-xpr" },
+    { "mgz", "application/vnd.proteus.magazine" },
+    { "vsc", "application/vnd.vidsoft.vidconference" },
+    { "map", "application/json; charset=utf-8" },
+    { "kmz", "application/vnd.google-earth.kmz" },
+    { "hbc", "application/vnd.hbci" },
+    { "zip", "application/zip" },
+    { "sjp", "image/vnd.sealedmedia.softseal.jpg" },
+    { "rtf", "application/rtf" },
+    { "azw3", "application/vnd.amazon.mobi8-ebook" },
+    { "asn", "chemical/x-ncbi-asn1" },
+    {},
+    { "ism", "model/vnd.gdl" },
+    { "sema", "application/vnd.sema" },
+    {},
+    { "rgb", "image/x-rgb" },
+    {},
+    { "mxi", "application/vnd.vd-study" },
+    { "ns2", "application/vnd.lotus-notes" },
+    { "mesh", "model/mesh" },
+    { "hsj2", "image/hsj2" },
+    { "spdx", "text/spdx; charset=utf-8" },
+    { "uvvv", "video/vnd.dece.video" },
+    { "pls", "audio/x-scpls" },
+    { "vcard", "text/vcard; charset=utf-8" },
+    { "igs", "model/iges" },
+    { "omg", "audio/atrac3" },
+    { "lcs", "application/vnd.logipipe.circuit+zip" },
+    { "rm", "audio/x-pn-realaudio" },
+    { "scm", "application/vnd.lotus-screencam" },
+    { "deploy", "application/octet-stream" },
+    { "m21", "application/mp21" },
+    { "glb", "model/gltf-binary" },
+    { "chrt", "application/vnd.kde.kchart" },
+    { "inp", "chemical/x-gamess-input" },
+    { "dls", "audio/dls" },
+    { "sic", "application/vnd.wap.sic" },
+    { "jfif", "image/jpeg" },
+    { "gam", "chemical/x-gamess-input" },
+    { "pk", "application/x-tex-pk" },
+    {},
+    { "gau", "chemical/x-gaussian-input" },
+    { "s1q", "video/vnd.sealedmedia.softseal.mov" },
+    { "mp1", "audio/mpeg" },
+    { "cpl", "application/cpl+xml" },
+    { "vss", "application/vnd.visio" },
+    { "tamp", "application/vnd.onepagertamp" },
+    { "ist", "chemical/x-isostar" },
+    { "p7m", "application/pkcs7-mime" },
+    { "xpx", "application/vnd.intercon.formnet" },
+    {},
+    {},
+    { "dtd", "application/xml-dtd" },
+    {},
+    { "mpw", "application/vnd.exstream-empower+zip" },
+    { "etx", "text/x-setext; charset=utf-8" },
+    { "twd", "application/vnd.simtech-mindmapper" },
+    { "odt", "application/vnd.oasis.opendocument.text" },
+    { "mp3", "audio/mpeg" },
+    { "u8hdr", "message/global-headers" },
+    { "uvi", "image/vnd.dece.graphic" },
+    { "skp", "application/vnd.koan" },
+    {},
+    { "kwd", "application/vnd.kde.kword" },
+    { "ctx", "chemical/x-ctx" },
+    { "hbci", "application/vnd.hbci" },
+    {},
+    { "sdf", "application/vnd.kinar" },
+    { "p8e", "application/pkcs8-encrypted" },
+    { "hpid", "application/vnd.hp-hpid" },
+    { "rdf", "application/rdf+xml" },
+    { "d", "text/x-dsrc; charset=utf-8" },
+    { "p10", "application/pkcs10" },
+    { "sarif", "application/sarif+json" },
+    { "smzip", "application/vnd.stepmania.package" },
+    {},
+    { "sce", "application/vnd.etsi.asic-e+zip" },
+    { "evc", "audio/evrc" },
+    {},
+    { "smpg", "video/vnd.sealed.mpeg1" },
+    { "mwf", "application/vnd.mfer" },
+    { "pfa", "application/x-font" },
+    { "p7c", "application/pkcs7-mime" },
+    {},
+    { "ppm", "image/x-portable-pixmap" },
+    { "jpgm", "image/jpm" },
+    { "dcm", "application/dicom" },
+    { "nds", "application/vnd.nintendo.nitro.rom" },
+    {},
+    { "bmi", "application/vnd.bmi" },
+    {},
+    { "mop", "chemical/x-mopac-input" },
+    { "taz", "application/x-gtar-compressed" },
+    {},
+    { "mdb", "application/msaccess" },
+    { "a", "text/vnd.a; charset=utf-8" },
+    { "sgl", "application/vnd.stardivision.writer-global" },
+    { "mpn", "application/vnd.mophun.application" },
+    { "iges", "model/iges" },
+    { "sdd", "application/vnd.stardivision.impress" },
+    { "c4f", "application/vnd.clonk.c4group" },
+    { "icd", "application/vnd.commerce-battelle" },
+    { "mads", "application/mads+xml" },
+    { "patch", "text/x-diff; charset=utf-8" },
+    { "age", "application/vnd.age" },
+    { "ecigtheme", "application/vnd.evolv.ecig.theme" },
+    {},
+    { "n3", "text/n3; charset=utf-8" },
+    {},
+    {},
+    { "xar", "application/vnd.xara" },
+    {},
+    {},
+    { "nim", "video/vnd.nokia.interleaved-multimedia" },
+    { "efif", "application/vnd.picsel" },
+    { "gnumeric", "application/x-gnumeric" },
+    { "qxt", "application/vnd.quark.quarkxpress" },
+    { "its", "application/its+xml" },
+    { "frame", "application/x-maker" },
+    { "anx", "application/annodex" },
+    { "oxt", "application/vnd.openofficeorg.extension" },
+    { "std", "application/vnd.sun.xml.draw.template" },
+    { "eps2", "application/postscript" },
+    {},
+    { "qcp", "audio/evrc-qcp" },
+    { "uvm", "video/vnd.dece.mobile" },
+    {},
+    { "gsheet", "application/urc-grpsheet+xml" },
+    {},
+    {},
+    { "xhtml", "application/xhtml+xml" },
+    { "djv", "image/vnd.djvu" },
+    { "hta", "application/hta" },
+    { "txd", "application/vnd.genomatix.tuxedo" },
+    { "isws", "application/vnd.veryant.thin" },
+    { "gcg", "chemical/x-gcg8-sequence" },
+    {},
+    { "sco", "audio/csound" },
+    { "stw", "application/vnd.sun.xml.writer.template" },
+    { "mvt", "application/vnd.mapbox-vector-tile" },
+    {},
+    { "gjf", "chemical/x-gaussian-input" },
+    { "pdb", "application/vnd.palm" },
+    { "pm", "text/x-perl; charset=utf-8" },
+    {},
+    { "wk3", "application/vnd.lotus-1-2-3" },
+    { "dts", "audio/vnd.dts" },
+    { "maei", "application/mmt-aei+xml" },
+    { "manifest", "text/cache-manifest; charset=utf-8" },
+    { "c3d", "chemical/x-chem3d" },
+    { "appcache", "text/cache-manifest; charset=utf-8" },
+    {},
+    { "webm", "video/webm" },
+    { "sr", "application/vnd.sigrok.session" },
+    { "iii", "application/x-iphone" },
+    { "auc", "application/tamp-apex-update-confirm" },
+    { "vfk", "text/vnd.exchangeable; charset=utf-8" },
+    {},
+    { "amlx", "application/automationml-amlx+zip" },
+    { "musd", "application/mmt-usd+xml" },
+    { "pptx", "application/vnd.openxmlformats-officedocument.presentationml.presentation" },
+    { "cif", "application/vnd.multiad.creator.cif" },
+    { "davmount", "application/davmount+xml" },
+    { "tmo", "application/vnd.tmobile-livetv" },
+    { "ico", "image/x-icon" },
+    { "artisan", "application/vnd.artisan+json" },
+    { "xht", "application/xhtml+xml" },
+    {},
+    { "dfac", "application/vnd.dreamfactory" },
+    { "iso", "application/x-iso9660-image" },
+    { "smp", "audio/vnd.sealedmedia.softseal.mpeg" },
+    { "ep", "application/vnd.bluetooth.ep.oob" },
+    { "ktz", "application/vnd.kahootz" },
+    {},
+    { "ter", "application/tamp-error" },
+    { "lgr", "application/lgr+xml" },
+    {},
+    { "crw", "image/x-canon-crw" },
+    { "mol2", "application/vnd.sybyl.mol2" },
+    { "wsc", "application/vnd.wfa.wsc" },
+    {},
+    { "wks", "application/vnd.ms-works" },
+    { "avif", "image/avif" },
+    { "lzh", "application/x-lzh" },
+    { "fcdt", "application/vnd.adobe.formscentral.fcdt" },
+    { "qxd", "application/vnd.quark.quarkxpress" },
+    { "mmdb", "application/vnd.maxmind.maxmind-db" },
+    { "gv", "text/vnd.graphviz; charset=utf-8" },
+    { "cascii", "chemical/x-cactvs-binary" },
+    { "pya", "audio/vnd.ms-playready.media.pya" },
+    { "xfd", "application/vnd.xfdl" },
+    { "bat", "application/x-msdos-program" },
+    { "stpz", "model/step+zip" },
+    { "tcap", "application/vnd.3gpp2.tcap" },
+    {},
+    { "wdb", "application/vnd.ms-works" },
+    { "ndc", "application/vnd.osa.netdeploy" },
+    {},
+    { "igx", "application/vnd.micrografx.igx" },
+    { "wml", "text/vnd.wap.wml; charset=utf-8" },
+    { "kpt", "application/vnd.kde.kpresenter" },
+    { "ggt", "application/vnd.geogebra.tool" },
+    {},
+    { "cef", "chemical/x-cxf" },
+    { "xca", "application/xcap-caps+xml" },
+    { "hans", "text/vnd.hans; charset=utf-8" },
+    { "shtml", "text/html; charset=utf-8" },
+    { "tag", "text/prs.lines.tag; charset=utf-8" },
+    { "pat", "image/x-coreldrawpattern" },
+    { "request", "application/vnd.nervana" },
+    { "potm", "application/vnd.ms-powerpoint.template.macroenabled.12" },
+    { "mmd", "application/vnd.chipnuts.karaoke-mmd" },
+    { "jpx", "image/jpx" },
+    {},
+    { "mseq", "application/vnd.mseq" },
+    { "xdf", "application/xcap-diff+xml" },
+    { "finf", "application/fastinfoset" },
+    { "xlsx", "application/vnd.openxmlformats-officedocument.spreadsheetml.sheet" },
+    {},
+    { "cdxml", "application/vnd.chemdraw+xml" },
+    { "spl", "application/futuresplash" },
+    {},
+    { "oa2", "application/vnd.fujitsu.oasys2" },
+    { "sxw", "application/vnd.sun.xml.writer" },
+    { "zone", "text/dns; charset=utf-8" },
+    {},
+    { "cda", "application/x-cdf" },
+    { "cc", "text/x-c++src; charset=utf-8" },
+    { "or2", "application/vnd.lotus-organizer" },
+    { "ssw", "video/vnd.sealed.swf" },
+    { "u8msg", "message/global" },
+    { "hif", "image/avif" },
+    { "xfdf", "application/xfdf" },
+    { "wpd", "application/vnd.wordperfect" },
+    { "vcd", "application/x-cdlink" },
+    { "docx", "application/vnd.openxmlformats-officedocument.wordprocessingml.document" },
+    { "qt", "video/quicktime" },
+    { "yt", "video/vnd.youtube.yt" },
+    { "tau", "application/tamp-apex-update" },
+    { "msty", "application/vnd.muvee.style" },
+    {},
+    { "snd", "audio/basic" },
+    {},
+    { "uri", "text/uri-list; charset=utf-8" },
+    { "lbc", "audio/ilbc" },
+    { "hs", "text/x-haskell; charset=utf-8" },
+    {},
+    { "dotm", "application/vnd.ms-word.template.macroenabled.12" },
+    { "vmd", "chemical/x-vmd" },
+    { "at3", "audio/atrac3" },
+    { "dsc", "text/prs.lines.tag; charset=utf-8" },
+    { "key", "application/pgp-keys" },
+    {},
+    {},
+    { "lxf", "application/lxf" },
+    { "rst", "text/prs.fallenstein.rst; charset=utf-8" },
+    { "uvz", "application/vnd.dece.zip" },
+    { "si", "text/vnd.wap.si; charset=utf-8" },
+    { "wmc", "application/vnd.wmc" },
+    { "ves", "application/vnd.ves.encrypted" },
+    { "spn", "image/vnd.sealed.png" },
+    { "vms", "chemical/x-vamas-iso14976" },
+    { "ink", "application/inkml+xml" },
+    { "dmg", "application/x-apple-diskimage" },
+    { "kon", "application/vnd.kde.kontour" },
+    {},
+    {},
+    { "xspf", "application/xspf+xml" },
+    { "m2v", "video/mpeg" },
+    { "pptm", "application/vnd.ms-powerpoint.presentation.macroenabled.12" },
+    { "et3", "application/vnd.eszigno3+xml" },
+    { "sid", "audio/prs.sid" },
+    { "bdm", "application/vnd.syncml.dm+wbxml" },
+    { "m", "application/vnd.wolfram.mathematica.package" },
+    { "ngdat", "application/vnd.nokia.n-gage.data" },
+    { "yme", "application/vnd.yaoweme" },
+    {},
+    { "umj", "application/vnd.umajin" },
+    { "zir", "application/vnd.zul" },
+    { "u8mdn", "message/global-disposition-notification" },
+    { "dv", "video/dv" },
+    { "dotx", "application/vnd.openxmlformats-officedocument.wordprocessingml.template" },
+    { "xcs", "application/calendar+xml" },
+    { "c3ex", "application/cccex" },
+    { "dpkg", "application/vnd.xmpie.dpkg" },
+    {},
+    { "markdown", "text/markdown; charset=utf-8" },
+    { "gqs", "application/vnd.grafeq" },
+    { "scq", "application/scvp-cv-request" },
+    { "bak", "application/x-trash" },
+    { "slt", "application/vnd.epson.salt" },
+    { "tpl", "application/vnd.groove-tool-template" },
+    { "jphc", "image/jphc" },
+    { "sxls", "application/vnd.sealed.xls" },
+    {},
+    { "roa", "application/rpki-roa" },
+    { "lasxml", "application/vnd.las.las+xml" },
+    { "210", "application/p21" },
+    { "cub", "chemical/x-gaussian-cube" },
+    { "uvvp", "video/vnd.dece.pd" },
+    { "hpgl", "application/vnd.hp-hpgl" },
+    { "usdz", "model/vnd.usdz+zip" },
+    {},
+    { "tao", "application/vnd.tao.intent-module-archive" },
+    { "gdz", "application/vnd.familysearch.gedcom+zip" },
+    {},
+    { "cryptonote", "application/vnd.rig.cryptonote" },
+    { "iota", "application/vnd.astraea-software.iota" },
+    { "sla", "application/vnd.scribus" },
+    { "cryptomator", "application/vnd.cryptomator.vault" },
+    { "vcf", "text/vcard; charset=utf-8" },
+    { "vmt", "application/vnd.valve.source.material" },
+    { "ptid", "application/vnd.pvi.ptid1" },
+    { "srt", "text/plain; charset=utf-8" },
+    { "wk", "application/x-123" },
+    { "qxl", "application/vnd.quark.quarkxpress" },
+    {},
+    {},
+    {},
+    { "zfc", "application/vnd.filmit.zfc" },
+    { "bed", "application/vnd.realvnc.bed" },
+    {},
+    { "xlsm", "application/vnd.ms-excel.sheet.macroenabled.12" },
+    { "qgs", "application/x-qgis" },
+    {},
+    { "m3u", "audio/mpegurl" },
+    { "gltf", "model/gltf+json" },
+    { "esa", "application/vnd.osgi.subsystem" },
+    { "maker", "application/x-maker" },
+    { "mlp", "audio/vnd.dolby.mlp" },
+    {},
+    { "sdkm", "application/vnd.solent.sdkm+xml" },
+    { "ecelp9600", "audio/vnd.nuera.ecelp9600" },
+    { "rsm", "model/vnd.gdl" },
+    { "psb", "application/vnd.3gpp.pic-bw-small" },
+    { "coffee", "application/vnd.coffeescript" },
+    { "swi", "application/vnd.aristanetworks.swi" },
+    { "odb", "application/vnd.oasis.opendocument.base" },
+    { "tfi", "application/thraud+xml" },
+    { "art", "image/x-jg" },
+    { "inkml", "application/inkml+xml" },
+    { "sensml", "application/sensml+json" },
+    {},
+    { "info", "application/x-info" },
+    {},
+    { "car", "application/vnd.ipld.car" },
+    { "scld", "application/vnd.doremir.scorecloud-binary-document" },
+    { "flo", "application/vnd.micrografx.flo" },
+    { "x3db", "model/x3d+fastinfoset" },
+    { "rss", "application/x-rss+xml" },
+    {},
+    { "htc", "text/x-component; charset=utf-8" },
+    { "mmod", "chemical/x-macromodel-input" },
+    { "xvml", "application/xv+xml" },
+    { "dive", "application/vnd.patentdive" },
+    {},
+    { "pac", "application/x-ns-proxy-autoconfig" },
+    { "dwd", "application/atsc-dwd+xml" },
+    {},
+    { "dbf", "application/vnd.dbf" },
+    { "sldm", "application/vnd.ms-powerpoint.slide.macroenabled.12" },
+    { "cxf", "chemical/x-cxf" },
+    {},
+    { "lvp", "audio/vnd.lucent.voice" },
+    { "xcos", "application/x-scilab-xcos" },
+    { "kfo", "application/vnd.kde.kformula" },
+    {},
+    { "distz", "application/vnd.apple.installer+xml" },
+    {},
+    { "docm", "application/vnd.ms-word.document.macroenabled.12" },
+    { "reload", "application/vnd.resilient.logic" },
+    { "orq", "application/ocsp-request" },
+    { "qbo", "application/vnd.intu.qbo" },
+    { "ppkg", "application/vnd.xmpie.ppkg" },
+    { "cdmia", "application/cdmi-capability" },
+    {},
+    { "quox", "application/vnd.quobject-quoxdocument" },
+    { "lpf", "application/lpf+zip" },
+    { "shar", "application/x-shar" },
+    { "jng", "image/x-jng" },
+    { "docjson", "application/vnd.document+json" },
+    { "taglet", "application/vnd.mynfc" },
+    { "aso", "application/vnd.accpac.simply.aso" },
+    { "cdt", "image/x-coreldrawtemplate" },
+    {},
+    { "ic6", "application/vnd.commerce-battelle" },
+    { "cdmiq", "application/cdmi-queue" },
+    { "726", "audio/32kadpcm" },
+    { "tlclient", "application/vnd.cendio.thinlinc.clientconf" },
+    { "numbers", "application/vnd.apple.numbers" },
+    {},
+    {},
+    { "jlt", "application/vnd.hp-jlyt" },
+    { "icc", "application/vnd.iccprofile" },
+    { "pt", "application/vnd.snesdev-page-table" },
+    { "wps", "application/vnd.ms-works" },
+    { "ctab", "chemical/x-cactvs-binary" },
+    {},
+    { "tst", "application/vnd.etsi.timestamp-token" },
+    { "s1n", "image/vnd.sealed.png" },
+    { "exi", "application/exi" },
+    { "moc", "text/x-moc; charset=utf-8" },
+    {},
+    { "unityweb", "application/vnd.unity" },
+    { "emotionml", "application/emotionml+xml" },
+    { "s1w", "application/vnd.sealed.doc" },
+    { "axv", "video/annodex" },
+    {},
+    {},
+    { "psg", "application/vnd.afpc.modca-pagesegment" },
+    { "ica", "application/x-ica" },
+    { "grxml", "application/srgs+xml" },
+    { "vis", "application/vnd.visionary" },
+    { "spc", "chemical/x-galactic-spc" },
+    { "s1e", "application/vnd.sealed.xls" },
+    {},
+    {},
+    { "nml", "application/vnd.enliven" },
+    { "fig", "application/x-xfig" },
+    { "oxps", "application/oxps" },
+    {},
+    { "grd", "application/vnd.gentics.grd+json" },
+    { "tm", "text/texmacs; charset=utf-8" },
+    { "xsf", "application/prs.xsf+xml" },
+    {},
+    { "nns", "application/vnd.noblenet-sealer" },
+    { "kin", "chemical/x-kinemage" },
+    {},
+    { "3tz", "application/vnd.maxar.archive.3tz+zip" },
+    { "nt", "application/n-triples" },
+    { "fsc", "application/vnd.fsc.weblaunch" },
+    { "sofa", "audio/sofa" },
+    {},
+    { "espass", "application/vnd.espass-espass+zip" },
+    {},
+    {},
+    { "imscc", "application/vnd.ims.imsccv1p1" },
+    { "ufd", "application/vnd.ufdl" },
+    { "cdf", "application/x-cdf" },
+    { "cbr", "application/vnd.comicbook-rar" },
+    { "ssv", "application/vnd.shade-save-file" },
+    { "uvvu", "video/vnd.dece.mp4" },
+    {},
+    { "js", "application/javascript; charset=utf-8" },
+    {},
+    {},
+    { "oas", "application/vnd.fujitsu.oasys" },
+    { "apng", "image/apng" },
+    {},
+    {},
+    {},
+    { "mdi", "image/vnd.ms-modi" },
+    {},
+    { "plf", "application/vnd.pocketlearn" },
+    { "rq", "application/sparql-query" },
+    { "wmf", "image/wmf" },
+    { "pgb", "image/vnd.globalgraphics.pgb" },
+    { "mpega", "audio/mpeg" },
+    { "torrent", "application/x-bittorrent" },
+    { "stif", "application/vnd.sealed.tiff" },
+    { "mxmf", "audio/mobile-xmf" },
+    { "cbz", "application/vnd.comicbook+zip" },
+    {},
+    {},
+    { "rlm", "application/vnd.resilient.logic" },
+    { "apkg", "application/vnd.anki" },
+    { "acc", "application/vnd.americandynamics.acc" },
+    { "ic3", "application/vnd.commerce-battelle" },
+    { "portpkg", "application/vnd.macports.portpkg" },
+    {},
+    { "uvt", "application/vnd.dece.ttml+xml" },
+    { "package", "application/vnd.autopackage" },
+    { "ai", "application/postscript" },
+    { "msf", "application/vnd.epson.msf" },
+    { "sfv", "text/x-sfv; charset=utf-8" },
+    { "xslt", "application/xslt+xml" },
+    { "log", "text/plain; charset=utf-8" },
+    { "xul", "application/vnd.mozilla.xul+xml" },
+    { "fti", "application/vnd.anser-web-funds-transfer-initiation" },
+    { "fit", "image/fits" },
+    { "coswid", "application/swid+cbor" },
+    { "utz", "application/vnd.uiq.theme" },
+    { "hxx", "text/x-c++hdr; charset=utf-8" },
+    { "ns4", "application/vnd.lotus-notes" },
+    { "cache", "chemical/x-cache" },
+    { "daf", "application/vnd.mobius.daf" },
+    { "cls", "text/x-tex; charset=utf-8" },
+    { "smi", "application/smil+xml" },
+    { "msh", "model/mesh" },
+    { "cdfx", "application/cdfx+xml" },
+    { "xlf", "application/xliff+xml" },
+    { "xsm", "application/vnd.syncml+xml" },
+    { "pem", "application/pem-certificate-chain" },
+    { "pcap", "application/vnd.tcpdump.pcap" },
+    {},
+    { "dll", "application/x-msdos-program" },
+    { "apk", "application/vnd.android.package-archive" },
+    { "sxg", "application/vnd.sun.xml.writer.global" },
+    { "ccxml", "application/ccxml+xml" },
+    { "genozip", "application/vnd.genozip" },
+    {},
+    { "pps", "application/vnd.ms-powerpoint" },
+    { "sdoc", "application/vnd.sealed.doc" },
+    { "trig", "application/trig" },
+    { "ait", "application/vnd.dvb.ait" },
+    {},
+    { "wk1", "application/vnd.lotus-1-2-3" },
+    { "cnd", "text/jcr-cnd; charset=utf-8" },
+    { "mcd", "application/vnd.mcd" },
+    { "s1a", "application/vnd.sealedmedia.softseal.pdf" },
+    { "gml", "application/gml+xml" },
+    { "spx", "audio/ogg" },
+    { "com", "application/x-msdos-program" },
+    { "ins", "application/x-internet-signup" },
+    {},
+    { "kpr", "application/vnd.kde.kpresenter" },
+    {},
+    {},
+    { "ogg", "audio/ogg" },
+    { "pl", "text/x-perl; charset=utf-8" },
+    { "held", "application/atsc-held+xml" },
+    { "vfr", "application/vnd.tml" },
+    {},
+    { "wmd", "application/x-ms-wmd" },
+    { "onepkg", "application/onenote" },
+    {},
+    { "mp21", "application/mp21" },
+    { "abw", "application/x-abiword" },
+    { "s1g", "image/vnd.sealedmedia.softseal.gif" },
+    {},
+    { "mpd", "application/dash+xml" },
+    { "nb", "application/vnd.wolfram.mathematica" },
+    {},
+    { "spq", "application/scvp-vp-request" },
+    { "odf", "application/vnd.oasis.opendocument.formula" },
+    { "bsd", "chemical/x-crossfire" },
+    { "pub", "application/vnd.exstream-package" },
+    { "smht", "application/vnd.sealed.mht" },
+    { "mb", "application/mathematica" },
+    { "dxp", "application/vnd.spotfire.dxp" },
+    {},
+    { "cab", "application/vnd.ms-cab-compressed" },
+    {},
+    { "man", "application/x-troff-man" },
+    { "dpgraph", "application/vnd.dpgraph" },
+    { "senmlx", "application/senml+xml" },
+    { "dataless", "application/vnd.fdsn.seed" },
+    { "tgz", "application/x-gtar-compressed" },
+    { "miz", "text/mizar; charset=utf-8" },
+    { "gen", "chemical/x-genbank" },
+    { "cxx", "text/x-c++src; charset=utf-8" },
+    { "dxr", "application/x-director" },
+    { "hvs", "application/vnd.yamaha.hv-script" },
+    { "3dml", "text/vnd.in3d.3dml; charset=utf-8" },
+    { "csl", "application/vnd.citationstyles.style+xml" },
+    { "mpg", "video/mpeg" },
+    {},
+    { "atfx", "application/atfx" },
+    {},
+    { "gtm", "application/vnd.groove-tool-message" },
+    { "ors", "application/ocsp-response" },
+    { "ml2", "application/vnd.sybyl.mol2" },
+    {},
+    { "xlw", "application/vnd.ms-excel" },
+    {},
+    { "oti", "application/vnd.oasis.opendocument.image-template" },
+    { "qca", "application/vnd.ericsson.quickcall" },
+    { "viv", "video/vnd.vivo" },
+    {},
+    { "hdf", "application/x-hdf" },
+    { "rgbe", "image/vnd.radiance" },
+    {},
+    { "vcj", "application/voucher-cms+json" },
+    {},
+    { "pas", "text/x-pascal; charset=utf-8" },
+    { "sdw", "application/vnd.stardivision.writer" },
+    {},
+    { "rms", "application/vnd.jcp.javame.midlet-rms" },
+    {},
+    { "oxlicg", "application/vnd.oxli.countgraph" },
+    { "pnm", "image/x-portable-anymap" },
+    { "tr", "text/troff; charset=utf-8" },
+    { "xods", "application/vnd.collabio.xodocuments.spreadsheet" },
+    {},
+    { "jsontd", "application/td+json" },
+    { "obgx", "application/vnd.openblox.game+xml" },
+    { "rb", "application/x-ruby" },
+    { "spf", "application/vnd.yamaha.smaf-phrase" },
+    { "a2l", "application/a2l" },
+    {},
+    { "wafl", "application/vnd.wasmflow.wafl" },
+    {},
+    { "quiz", "application/vnd.quobject-quoxdocument" },
+    { "ifb", "text/calendar; charset=utf-8" },
+    { "scl", "application/vnd.sycle+xml" },
+    { "scs", "application/scvp-cv-response" },
+    { "potx", "application/vnd.openxmlformats-officedocument.presentationml.template" },
+    {},
+    { "xtel", "chemical/x-xtel" },
+    { "hin", "chemical/x-hin" },
+    { "sgf", "application/x-go-sgf" },
+    { "bmpr", "application/vnd.balsamiq.bmpr" },
+    { "xpi", "application/x-xpinstall" },
+    {},
+    { "gpkg", "application/geopackage+sqlite3" },
+    { "xots", "application/vnd.collabio.xodocuments.spreadsheet-template" },
+    { "x_b", "model/vnd.parasolid.transmit.binary" },
+    {},
+    { "ecig", "application/vnd.evolv.ecig.settings" },
+    { "multitrack", "audio/vnd.presonus.multitrack" },
+    { "nsh", "application/vnd.lotus-notes" },
+    { "html", "text/html; charset=utf-8" },
+    { "swf", "application/vnd.adobe.flash.movie" },
+    { "mpt", "application/vnd.ms-project" },
+    { "ros", "chemical/x-rosdal" },
+    { "bik", "video/vnd.radgamettools.bink" },
+    { "hps", "application/vnd.hp-hps" },
+    { "sdkd", "application/vnd.solent.sdkm+xml" },
+    { "msd", "application/vnd.fdsn.mseed" },
+    {},
+    {},
+    { "ic5", "application/vnd.commerce-battelle" },
+    {},
+    { "jpm", "image/jpm" },
+    { "geojson", "application/geo+json" },
+    {},
+    { "woff2", "font/woff2" },
+    { "fvt", "video/vnd.fvt" },
+    {},
+    { "xlc", "application/vnd.ms-excel" },
+    { "wax", "audio/x-ms-wax" },
+    {},
+    { "oga", "audio/ogg" },
+    { "eol", "audio/vnd.digital-winds" },
+    { "flx", "text/vnd.fmi.flexstor; charset=utf-8" },
+    { "clkp", "application/vnd.crick.clicker.palette" },
+    { "wtb", "application/vnd.webturbo" },
+    { "thmx", "application/vnd.ms-officetheme" },
+    {},
+    { "cea", "application/cea" },
+    { "uris", "text/uri-list; charset=utf-8" },
+    { "susp", "application/vnd.sus-calendar" },
+    {},
+    { "or3", "application/vnd.lotus-organizer" },
+    { "jph", "image/jph" },
+    { "sdp", "application/sdp" },
+    { "jrd", "application/jrd+json" },
+    { "wz", "application/x-wingz" },
+    { "rpst", "application/vnd.nokia.radio-preset" },
+    {},
+    { "sd2", "audio/x-sd2" },
+    { "class", "application/java-vm" },
+    {},
+    { "cl", "application/simple-filter+xml" },
+    { "onetoc2", "application/onenote" },
+    {},
+    {},
+    {},
+    { "sxi", "application/vnd.sun.xml.impress" },
+    {},
+    { "ic0", "application/vnd.commerce-battelle" },
+    { "itp", "application/vnd.shana.informed.formtemplate" },
+    { "nlu", "application/vnd.neurolanguage.nlu" },
+    { "gbr", "application/rpki-ghostbusters" },
+    { "xbm", "image/x-xbitmap" },
+    { "ndl", "application/vnd.lotus-notes" },
+    { "pyox", "model/vnd.pytha.pyox" },
+    { "pbm", "image/x-portable-bitmap" },
+    { "jxl", "image/jxl" },
+    { "wad", "application/x-doom" },
+    { "fxpl", "application/vnd.adobe.fxp" },
+    { "wmv", "video/x-ms-wmv" },
+    {},
+    { "jar", "application/java-archive" },
+    { "ggs", "application/vnd.geogebra.slides" },
+    {},
+    { "text", "text/plain; charset=utf-8" },
+    { "oa3", "application/vnd.fujitsu.oasys3" },
+    { "cdmid", "application/cdmi-domain" },
+    {},
+    { "sem", "application/vnd.sealed.eml" },
+    {},
+    { "mpe", "video/mpeg" },
+    { "sig", "application/pgp-signature" },
+    { "heifs", "image/heif-sequence" },
+    { "vcg", "application/vnd.groove-vcard" },
+    { "zst", "application/zstd" },
+    { "axa", "audio/annodex" },
+    { "ppsx", "application/vnd.openxmlformats-officedocument.presentationml.slideshow" },
+    { "mc1", "application/vnd.medcalcdata" },
+    { "lhzd", "application/vnd.belightsoft.lhzd+zip" },
+    { "sfd", "application/vnd.font-fontforge-sfd" },
+    { "apex", "application/vnd.apexlang" },
+    { "prt", "chemical/x-ncbi-asn1-ascii" },
+    { "es", "text/javascript; charset=utf-8" },
+    {},
+    { "tree", "application/vnd.rainstor.data" },
+    {},
+    {},
+    { "sitx", "application/x-stuffit" },
+    { "sgm", "text/sgml; charset=utf-8" },
+    { "gjc", "chemical/x-gaussian-input" },
+    { "odd", "application/tei+xml" },
+    { "mpc", "application/vnd.mophun.certificate" },
+    { "gz", "application/gzip" },
+    { "link66", "application/vnd.route66.link66+xml" },
+    {},
+    {},
+    { "fo", "application/vnd.software602.filler.form+xml" },
+    { "mgp", "application/vnd.osgeo.mapguide.package" },
+    { "pbd", "application/vnd.powerbuilder6" },
+    { "hdt", "application/vnd.hdt" },
+    { "uvvs", "video/vnd.dece.sd" },
+    { "rl", "application/resource-lists+xml" },
+    { "gxt", "application/vnd.geonext" },
+    { "vcs", "text/x-vcalendar; charset=utf-8" },
+    { "cuc", "application/tamp-community-update-confirm" },
+    {},
+    {},
+    { "es3", "application/vnd.eszigno3+xml" },
+    { "cql", "text/cql; charset=utf-8" },
+    {},
+    {},
+    { "slaz", "application/vnd.scribus" },
+    {},
+    { "crl", "application/pkix-crl" },
+    {},
+    { "wmz", "application/x-ms-wmz" },
+    { "atc", "application/vnd.acucorp" },
+    { "seml", "application/vnd.sealed.eml" },
+    { "dmp", "application/vnd.tcpdump.pcap" },
+    { "oza", "application/x-oz-application" },
+    { "mseed", "application/vnd.fdsn.mseed" },
+    {},
+    { "mail", "message/rfc822" },
+    {},
+    { "mrcx", "application/marcxml+xml" },
+    {},
+    { "xcf", "image/x-xcf" },
+    { "cdy", "application/vnd.cinderella" },
+    {},
+    { "nnw", "application/vnd.noblenet-web" },
+    { "sfc", "application/vnd.nintendo.snes.rom" },
+    { "dl", "application/vnd.datalog" },
+    {},
+    { "ipk", "application/vnd.shana.informed.package" },
+    { "cdmic", "application/cdmi-container" },
+    { "pgn", "application/vnd.chess-pgn" },
+    { "azv", "image/vnd.airzip.accelerator.azv" },
+    {},
+    { "ppsm", "application/vnd.ms-powerpoint.slideshow.macroenabled.12" },
+    { "semf", "application/vnd.semf" },
+    { "ra", "audio/x-pn-realaudio" },
+    { "bmed", "multipart/vnd.bint.med-plus" },
+    { "xpak", "application/vnd.gentoo.xpak" },
+    { "hh", "text/x-c++hdr; charset=utf-8" },
+    { "joda", "application/vnd.joost.joda-archive" },
+    { "aal", "audio/atrac-advanced-lossless" },
+    {},
+    { "xlm", "application/vnd.ms-excel" },
+    { "smf", "application/vnd.stardivision.math" },
+    { "dzr", "application/vnd.dzr" },
+    {},
+    { "flw", "application/vnd.kde.kivio" },
+    {},
+    { "dot", "text/vnd.graphviz; charset=utf-8" },
+    { "ggb", "application/vnd.geogebra.file" },
+    { "nsf", "application/vnd.lotus-notes" },
+    { "md", "text/markdown; charset=utf-8" },
+    { "dwg", "image/vnd.dwg" },
+    { "h++", "text/x-c++hdr; charset=utf-8" },
+    { "obg", "application/vnd.openblox.game-binary" },
+    { "cld", "model/vnd.cld" },
+    {},
+    { "fxp", "application/vnd.adobe.fxp" },
+    { "c11amc", "application/vnd.cluetrust.cartomobile-config" },
+    {},
+    { "dd2", "application/vnd.oma.dd2+xml" },
+    { "uvg", "image/vnd.dece.graphic" },
+    { "skd", "application/vnd.koan" },
+    { "flac", "audio/flac" },
+    { "mqy", "application/vnd.mobius.mqy" },
+    { "u8dsn", "message/global-delivery-status" },
+    { "gan", "application/x-ganttproject" },
+    { "knp", "application/vnd.kinar" },
+    { "pqa", "application/vnd.palm" },
+    {},
+    {},
+    {},
+    {},
+    {},
+    { "mxu", "video/vnd.mpegurl" },
+    { "xla", "application/vnd.ms-excel" },
+    {},
+    { "txt", "text/plain; charset=utf-8" },
+    { "pdf", "application/pdf" },
+    {},
+    {},
+    {},
+    { "zirz", "application/vnd.zul" },
+    { "bh2", "application/vnd.fujitsu.oasysprs" },
+    {},
+    { "ac", "application/pkix-attr-cert" },
+    { "one", "application/onenote" },
+    {},
+    { "mxml", "application/xv+xml" },
+    { "cmp", "application/vnd.yellowriver-custom-menu" },
+    {},
+    { "kcm", "application/vnd.nervana" },
+    {},
+    {},
+    { "listafp", "application/vnd.afpc.modca" },
+    { "c++", "text/x-c++src; charset=utf-8" },
+    { "kia", "application/vnd.kidspiration" },
+    { "ifc", "application/p21" },
+    { "xns", "application/xcap-ns+xml" },
+    { "sc", "application/vnd.ibm.secure-container" },
+    { "stml", "application/vnd.sealedmedia.softseal.html" },
+    {},
+    { "lhs", "text/x-literate-haskell; charset=utf-8" },
+    { "hej2", "image/hej2k" },
+    { "opf", "application/oebps-package+xml" },
+    { "p8", "application/pkcs8" },
+    { "cbor", "application/cbor" },
+    { "uvvx", "application/vnd.dece.unspecified" },
+    { "embl", "chemical/x-embl-dl-nucleotide" },
+    { "dvb", "video/vnd.dvb.file" },
+    { "org", "application/vnd.lotus-organizer" },
+    { "pil", "application/vnd.piaccess.application-licence" },
+    {},
+    { "imp", "application/vnd.accpac.simply.imp" },
+    { "hvp", "application/vnd.yamaha.hv-voice" },
+    { "ics", "text/calendar; charset=utf-8" },
+    {},
+    { "mjp2", "video/mj2" },
+    { "sswf", "video/vnd.sealed.swf" },
+    { "sm", "application/vnd.stepmania.stepchart" },
+    { "erf", "image/x-epson-erf" },
+    { "ez2", "application/vnd.ezpix-album" },
+    { "isp", "application/x-internet-signup" },
+    { "yin", "application/yin+xml" },
+    { "3dm", "text/vnd.in3d.3dml; charset=utf-8" },
+    { "ecigprofile", "application/vnd.evolv.ecig.profile" },
+    { "fb", "application/x-maker" },
+    { "xhvml", "application/xv+xml" },
+    { "src", "application/x-wais-source" },
+    { "uvvd", "application/vnd.dece.data" },
+    {},
+    {},
+    { "mpv", "video/x-matroska" },
+    { "notebook", "application/vnd.smart.notebook" },
+    { "wma", "audio/x-ms-wma" },
+    {},
+    { "obj", "model/obj" },
+    { "atxml", "application/atxml" },
+    { "c4d", "application/vnd.clonk.c4group" },
+    { "sl", "text/vnd.wap.sl; charset=utf-8" },
+    {},
+    { "hwp", "application/x-hwp" },
+    {},
+    { "mp2", "audio/mpeg" },
+    { "xct", "application/vnd.fujixerox.docuworks.container" },
+    {},
+    { "asice", "application/vnd.etsi.asic-e+zip" },
+    { "uvd", "application/vnd.dece.data" },
+    { "plb", "application/vnd.3gpp.pic-bw-large" },
+    { "azs", "application/vnd.airzip.filesecure.azs" },
+    { "mwc", "application/vnd.dpgraph" },
+    { "cac", "chemical/x-cache" },
+    { "exe", "application/x-msdos-program" },
+    { "kne", "application/vnd.kinar" },
+    {},
+    { "dssc", "application/dssc+der" },
+    { "mc2", "text/vnd.senx.warpscript; charset=utf-8" },
+    { "efi", "application/efi" },
+    { "s1m", "audio/vnd.sealedmedia.softseal.mpeg" },
+    { "gamin", "chemical/x-gamess-input" },
+    { "clkk", "application/vnd.crick.clicker.keyboard" },
+    {},
+    { "scala", "text/x-scala; charset=utf-8" },
+    {},
+    { "las", "application/vnd.las" },
+    { "pyo", "application/x-python-code" },
+    { "mid", "audio/sp-midi" },
+    { "wv", "application/vnd.wv.csp+wbxml" },
+    { "qwd", "application/vnd.quark.quarkxpress" },
+    { "ods", "application/vnd.oasis.opendocument.spreadsheet" },
+    { "eln", "application/vnd.eln+zip" },
+    { "xltm", "application/vnd.ms-excel.template.macroenabled.12" },
+    { "tk", "text/x-tcl; charset=utf-8" },
+    { "wqd", "application/vnd.wqd" },
+    { "uvva", "audio/vnd.dece.audio" },
+    {},
+    { "xer", "application/xcap-error+xml" },
+    { "xdssc", "application/dssc+xml" },
+    { "csd", "audio/csound" },
+    { "sam", "application/vnd.lotus-wordpro" },
+    {},
+    { "qcall", "application/vnd.ericsson.quickcall" },
+    { "sse", "application/vnd.kodak-descriptor" },
+    { "odc", "application/vnd.oasis.opendocument.chart" },
+    { "zmt", "chemical/x-mopac-input" },
+    { "clkw", "application/vnd.crick.clicker.wordbank" },
+    {},
+    { "xotp", "application/vnd.collabio.xodocuments.presentation-template" },
+    { "ogx", "application/ogg" },
+    { "jp2", "image/jp2" },
+    { "gl", "video/gl" },
+    { "cdmio", "application/cdmi-object" },
+    { "mol", "chemical/x-mdl-molfile" },
+    { "ged", "text/vnd.familysearch.gedcom; charset=utf-8" },
+    { "sfd-hdstx", "application/vnd.hydrostatix.sof-data" },
+    {},
+    { "mod", "application/xml-dtd" },
+    { "ddf", "application/vnd.syncml.dmddf+xml" },
+    { "ic4", "application/vnd.commerce-battelle" },
+    {},
+    { "tar", "application/x-tar" },
+    { "mph", "application/x-comsol" },
+    {},
+    { "msi", "application/x-msi" },
+    { "mm", "application/x-freemind" },
+    { "cmc", "application/vnd.cosmocaller" },
+    { "soc", "application/sgml-open-catalog" },
+    { "vrml", "model/vrml" },
+    { "mbk", "application/vnd.mobius.mbk" },
+    { "mpkg", "application/vnd.apple.installer+xml" },
+    { "atom", "application/atom+xml" },
+    {},
+    { "cii", "application/vnd.anser-web-certificate-issue-initiation" },
+    {},
+    {},
+    { "lyx", "application/x-lyx" },
+    { "mml", "application/mathml+xml" },
+    { "orf", "image/x-olympus-orf" },
+    { "ktx", "image/ktx" },
+    { "cpt", "application/mac-compactpro" },
+    {},
+    { "epub", "application/epub+zip" },
+    {},
+    { "atomcat", "application/atomcat+xml" },
+    { "wk4", "application/vnd.lotus-1-2-3" },
+    { "wav", "audio/wav" },
+    { "sxd", "application/vnd.sun.xml.draw" },
+    { "wasm", "application/wasm" },
+    { "gif", "image/gif" },
+    { "curl", "text/vnd.curl; charset=utf-8" },
+    {},
+    { "mdc", "application/vnd.marlin.drm.mdcf" },
+    { "ac2", "application/vnd.banana-accounting" },
+    { "csrattrs", "application/csrattrs" },
+    { "pre", "application/vnd.lotus-freelance" },
+    { "avi", "video/x-msvideo" },
+    {},
+    { "smp3", "audio/vnd.sealedmedia.softseal.mpeg" },
+    { "b", "chemical/x-molconn-z" },
+    { "orc", "audio/csound" },
+    { "fdf", "application/fdf" },
+    {},
+    { "dpg", "application/vnd.dpgraph" },
+    {},
+    { "spot", "text/vnd.in3d.spot; charset=utf-8" },
+    { "sy2", "application/vnd.sybyl.mol2" },
+    { "wcm", "application/vnd.ms-works" },
+    {},
+    { "s1p", "application/vnd.sealed.ppt" },
+    { "lbe", "application/vnd.llamagraphics.life-balance.exchange+xml" },
+    { "m4u", "video/vnd.mpegurl" },
+    { "bsp", "model/vnd.valve.source.compiled-map" },
+    { "jxsc", "image/jxsc" },
+    { "mxf", "application/mxf" },
+    { "csml", "chemical/x-csml" },
+    { "ttml", "application/ttml+xml" },
+    { "xel", "application/xcap-el+xml" },
+    { "opus", "audio/ogg" },
+    { "st", "application/vnd.sailingtracker.track" },
+    { "fdt", "application/fdt+xml" },
+    { "texi", "application/x-texinfo" },
+    { "ntf", "application/vnd.lotus-notes" },
+    { "nc", "application/x-netcdf" },
+    { "sik", "application/x-trash" },
+    { "mpy", "application/vnd.ibm.minipay" },
+    { "xml", "application/xml; charset=utf-8" },
+    { "psfs", "application/vnd.psfs" },
+    { "cpa", "chemical/x-compass" },
+    { "pki", "application/pkixcmp" },
+    { "ps", "application/postscript" },
+    { "tsr", "application/timestamp-reply" },
+    { "t", "text/troff; charset=utf-8" },
+    { "lrm", "application/vnd.ms-lrm" },
+    { "rs", "application/rls-services+xml" },
+    { "evw", "audio/evrcwb" },
+    { "c4u", "application/vnd.clonk.c4group" },
+    { "dp", "application/vnd.osgi.dp" },
+    { "sh", "application/x-sh" },
+    { "jnlp", "application/x-java-jnlp-file" },
+    { "bcpio", "application/x-bcpio" },
+    { "lsf", "video/x-la-asf" },
+    { "p21", "application/p21" },
+    { "val", "chemical/x-ncbi-asn1-binary" },
+    { "smh", "application/vnd.sealed.mht" },
+    { "psid", "audio/prs.sid" },
+    { "vsw", "application/vnd.visio" },
+    { "wspolicy", "application/wspolicy+xml" },
+    {},
+    { "mjs", "application/javascript; charset=utf-8" },
+    { "uvp", "video/vnd.dece.pd" },
+    { "ext", "application/vnd.novadigm.ext" },
+    {},
+    { "ufdl", "application/vnd.ufdl" },
+    { "sls", "application/route-s-tsid+xml" },
+    {},
+    {},
+    { "ota", "application/vnd.android.ota" },
+    {},
+    { "msm", "model/vnd.gdl" },
+    { "drle", "image/dicom-rle" },
+    {},
+    { "fg5", "application/vnd.fujitsu.oasysgp" },
+    {},
+    { "lostxml", "application/lost+xml" },
+    {},
+    {},
+    { "acu", "application/vnd.acucobol" },
+    { "fla", "application/vnd.dtg.local.flash" },
+    { "vsf", "application/vnd.vsf" },
+    { "clkt", "application/vnd.crick.clicker.template" },
+    { "amr", "audio/amr" },
+    {},
+    { "loas", "audio/usac" },
+    {},
+    { "lwp", "application/vnd.lotus-wordpro" },
+    {},
+    {},
+    {},
+    { "gal", "chemical/x-gaussian-log" },
+    { "igm", "application/vnd.insors.igm" },
+    {},
+    { "uis", "application/urc-uisocketdesc+xml" },
+    { "cst", "application/vnd.commonspace" },
+    { "seed", "application/vnd.fdsn.seed" },
+    { "rp9", "application/vnd.cloanto.rp9" },
+    { "p12", "application/pkcs12" },
+    { "p7z", "application/pkcs7-mime" },
+    { "preminet", "application/vnd.preminet" },
+    { "au", "audio/basic" },
+    { "123", "application/vnd.lotus-1-2-3" },
+    { "siv", "application/sieve" },
+    { "xlim", "application/vnd.xmpie.xlim" },
+    { "ogv", "video/ogg" },
+    {},
+    {},
+    { "sgml", "text/sgml; charset=utf-8" },
+    { "smo", "video/vnd.sealedmedia.softseal.mov" },
+    { "cer", "application/pkix-cert" },
+    { "xsl", "application/xslt+xml" },
+    {},
+    { "grv", "application/vnd.groove-injector" },
+    { "tcl", "application/x-tcl" },
+    { "iif", "application/vnd.shana.informed.interchange" },
+    { "tei", "application/tei+xml" },
+    { "upa", "application/vnd.hbci" },
+    { "ims", "application/vnd.ms-ims" },
+    { "m4s", "video/iso.segment" },
+    { "xyz", "chemical/x-xyz" },
+    { "ignition", "application/vnd.coreos.ignition+json" },
+    { "zmm", "application/vnd.handheld-entertainment+xml" },
+    { "otf", "font/otf" },
+    { "fe_launch", "application/vnd.denovo.fcselayout-link" },
+    { "wvx", "video/x-ms-wvx" },
+    { "tatp", "application/vnd.onepagertatp" },
+    { "m4v", "video/mp4" },
+    { "jls", "image/jls" },
+    { "aep", "application/vnd.audiograph" },
+    { "mcif", "chemical/x-mmcif" },
+    { "stpxz", "model/step-xml+zip" },
+    { "sw", "chemical/x-swissprot" },
+    {},
+    { "ipfix", "application/ipfix" },
+    { "mpeg", "video/mpeg" },
+    { "otc", "application/vnd.oasis.opendocument.chart-template" },
+    { "irm", "application/vnd.ibm.rights-management" },
+    { "1km", "application/vnd.1000minds.decision-model+xml" },
+    { "pml", "application/vnd.ctc-posml" },
+    {},
+    { "afp", "application/vnd.afpc.modca" },
+    { "smk", "video/vnd.radgamettools.smacker" },
+    { "acn", "audio/asc" },
+    {},
+    { "txf", "application/vnd.mobius.txf" },
+    { "jxra", "image/jxra" },
+    { "qtl", "application/x-quicktimeplayer" },
+    { "vpm", "multipart/voice-message" },
+    {},
+    { "xwd", "image/x-xwindowdump" },
+    { "rdz", "application/vnd.data-vision.rdz" },
+    { "gim", "application/vnd.groove-identity-message" },
+    {},
+    { "ivu", "application/vnd.immervision-ivu" },
+    {},
+    { "rxn", "chemical/x-mdl-rxnfile" },
+    {},
+    { "karbon", "application/vnd.kde.karbon" },
+    { "ic1", "application/vnd.commerce-battelle" },
+    { "ief", "image/ief" },
+    { "nbp", "application/vnd.wolfram.player" },
+    {},
+    { "senml-etchj", "application/senml-etch+json" },
+    { "mxs", "application/vnd.triscape.mxs" },
+    {},
+    { "aac", "audio/aac" },
+    { "nitf", "application/vnd.nitf" },
+    { "tsv", "text/tab-separated-values; charset=utf-8" },
+    { "ktr", "application/vnd.kahootz" },
+    { "emb", "chemical/x-embl-dl-nucleotide" },
+    { "tamx", "application/vnd.onepagertamx" },
+    { "pkd", "application/vnd.hbci" },
+    { "abc", "text/vnd.abc; charset=utf-8" },
+    { "sensmlc", "application/sensml+cbor" },
+    { "xz", "application/x-xz" },
+    { "mag", "application/vnd.ecowin.chart" },
+    { "fchk", "chemical/x-gaussian-checkpoint" },
+    { "lha", "application/x-lha" },
+    { "entity", "application/vnd.nervana" },
+    { "smv", "audio/smv" },
+    { "l16", "audio/l16" },
+    { "cellml", "application/cellml+xml" },
+    {},
+};